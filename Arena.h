@@ -0,0 +1,176 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code implements a monotonic arena and an allocator that allocates from it, for use with GraphSearch.h.  A search
+allocates its states, nodes, and frontier in many growing containers.  With ArenaAllocator, those containers carve
+their memory out of a few large blocks, and freeing memory does nothing.  The owner of the arena releases it all at
+once, after the problem that used it is destroyed or has no more use for its last search.  Threads that each search
+with their own arena then rarely call the global allocator, so they don't contend for it.
+
+Pass an ArenaAllocator as the last template variable of Problem, and the same allocator type as the last template
+variable of its state table, and construct the problem with the allocator.  For example:
+
+	typedef graphsearch::ArenaAllocator<int> Allocator;
+	class MyProblem : public graphsearch::Problem<int, MyActions, std::hash<int>,
+		graphsearch::FlatStateTable<int, std::hash<int>, Allocator>, graphsearch::NoSearchStats, Allocator>
+	{
+		...
+	public:
+		MyProblem(graphsearch::MonotonicArena& arena) : Problem(Allocator{arena}) {}
+	};
+
+An arena is not thread-safe.  Use one arena per thread.
+*/
+
+#pragma once
+
+#include <cstddef>       // std::size_t, std::max_align_t
+#include <cstdint>       // std::uintptr_t
+#include <new>           // ::operator new
+
+namespace graphsearch
+{
+	/*
+	The arena allocates blocks from the global allocator, each twice the size of the last, and hands out memory from
+	the newest block in order.  "release" frees every block but the newest, which it keeps for the next use.
+	*/
+	class MonotonicArena
+	{
+		struct Block
+		{
+			Block* previous;
+			std::size_t size;  // The size of the block, including this header
+		};
+
+		static const std::size_t header_size = (sizeof(Block) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t)
+			* alignof(std::max_align_t);
+
+		Block* newest{nullptr};
+		char* next{nullptr};  // The first free byte in the newest block
+		char* end{nullptr};   // The end of the newest block
+		std::size_t next_block_size;
+		std::size_t bytes_allocated{0};
+
+		/* Start a new block with room for at least "bytes" bytes aligned to "alignment." */
+		void addBlock(std::size_t bytes, std::size_t alignment)
+		{
+			std::size_t size = next_block_size;
+
+			while (size < header_size + bytes + alignment)
+			{
+				size *= 2;
+			}
+			Block* block = static_cast<Block*>(::operator new(size));
+			block->previous = newest;
+			block->size = size;
+			newest = block;
+			next = reinterpret_cast<char*>(block) + header_size;
+			end = reinterpret_cast<char*>(block) + size;
+			next_block_size = size * 2;
+		}
+
+	public:
+		explicit MonotonicArena(std::size_t first_block_size = 64 * 1024) : next_block_size{first_block_size}
+		{
+		}
+
+		MonotonicArena(const MonotonicArena&) = delete;
+		MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+		~MonotonicArena()
+		{
+			release();
+			if (newest != nullptr)
+			{
+				::operator delete(newest);
+			}
+		}
+
+		/* Return "bytes" bytes aligned to "alignment," which must be a power of two. */
+		void* allocate(std::size_t bytes, std::size_t alignment)
+		{
+			std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t>(next) + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+
+			if (newest == nullptr || aligned + bytes > reinterpret_cast<std::uintptr_t>(end))
+			{
+				addBlock(bytes, alignment);
+				aligned = (reinterpret_cast<std::uintptr_t>(next) + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+			}
+			next = reinterpret_cast<char*>(aligned + bytes);
+			bytes_allocated += bytes;
+			return reinterpret_cast<void*>(aligned);
+		}
+
+		/*
+		Free all of the memory allocated from the arena at once.  Nothing may use that memory afterward.  The newest
+		block, which is the largest, is kept for the next allocations.
+		*/
+		void release()
+		{
+			if (newest == nullptr)
+			{
+				return;
+			}
+			while (newest->previous != nullptr)
+			{
+				Block* previous = newest->previous;
+				newest->previous = previous->previous;
+				::operator delete(previous);
+			}
+			next = reinterpret_cast<char*>(newest) + header_size;
+			bytes_allocated = 0;
+		}
+
+		/* Return the number of bytes allocated since the arena was created or last released. */
+		std::size_t bytesAllocated() const
+		{
+			return bytes_allocated;
+		}
+	};
+
+	/*
+	A standard allocator that allocates from a MonotonicArena.  Deallocating does nothing; the memory is freed when
+	the arena is released.  Allocators for any type are equal if they use the same arena.
+	*/
+	template <typename T>
+	class ArenaAllocator
+	{
+		template <typename U> friend class ArenaAllocator;
+
+		MonotonicArena* arena;
+
+	public:
+		typedef T value_type;
+
+		ArenaAllocator(MonotonicArena& the_arena) : arena{&the_arena}
+		{
+		}
+
+		template <typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) : arena{other.arena}
+		{
+		}
+
+		T* allocate(std::size_t count)
+		{
+			return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* /* memory */, std::size_t /* count */)
+		{
+		}
+
+		template <typename U>
+		bool operator==(const ArenaAllocator<U>& other) const
+		{
+			return arena == other.arena;
+		}
+
+		template <typename U>
+		bool operator!=(const ArenaAllocator<U>& other) const
+		{
+			return arena != other.arena;
+		}
+	};
+} // End of the graphsearch namespace.
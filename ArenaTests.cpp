@@ -0,0 +1,84 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code tests Arena.h.
+*/
+
+#include <cstdint>         // std::uintptr_t
+#include <functional>      // std::hash
+#include <vector>
+#include "cute.h"
+#include "Arena.h"
+#include "ArenaTests.h"
+#include "Frontier.h"
+#include "StateTable.h"
+
+void MonotonicArenaTest()
+{
+	graphsearch::MonotonicArena arena{256};
+	char* first;
+	void* second;
+
+	ASSERTM("A new arena should have allocated nothing.", arena.bytesAllocated() == 0);
+	first = static_cast<char*>(arena.allocate(3, 1));
+	second = arena.allocate(8, 8);
+	ASSERTM("The allocation should be aligned.", reinterpret_cast<std::uintptr_t>(second) % 8 == 0);
+	ASSERTM("Allocations should follow one another in a block.", static_cast<char*>(second) - first < 16);
+	ASSERTM("The arena should count the bytes allocated.", arena.bytesAllocated() == 11);
+
+	// Allocations larger than a block get a block of their own, and the memory must be usable.
+	for (int i = 0; i < 10; ++i)
+	{
+		char* memory = static_cast<char*>(arena.allocate(1000, 16));
+		ASSERTM("The allocation should be aligned.", reinterpret_cast<std::uintptr_t>(memory) % 16 == 0);
+		for (int j = 0; j < 1000; ++j)
+		{
+			memory[j] = (char)i;
+		}
+	}
+	ASSERTM("The arena should count the bytes allocated.", arena.bytesAllocated() == 10011);
+
+	// Releasing the arena keeps the newest block, and allocations start over at its beginning.
+	void* after_release;
+	arena.release();
+	ASSERTM("A released arena should have allocated nothing.", arena.bytesAllocated() == 0);
+	after_release = arena.allocate(8, 8);
+	ASSERTM("The released arena should reuse its newest block.", arena.allocate(8, 8) == static_cast<char*>(after_release) + 8);
+}
+
+void ArenaAllocatorTest()
+{
+	graphsearch::MonotonicArena arena;
+	graphsearch::MonotonicArena other_arena;
+	graphsearch::ArenaAllocator<int> allocator{arena};
+	graphsearch::ArenaAllocator<double> rebound{allocator};
+
+	ASSERTM("Allocators for the same arena should be equal.", allocator == rebound);
+	ASSERTM("Allocators for different arenas should differ.", allocator != graphsearch::ArenaAllocator<int>{other_arena});
+
+	std::vector<int, graphsearch::ArenaAllocator<int>> numbers(allocator);
+	for (int i = 0; i < 1000; ++i)
+	{
+		numbers.push_back(i);
+	}
+	ASSERTM("The vector should hold its elements.", numbers[999] == 999);
+	ASSERTM("The vector should allocate from the arena.", arena.bytesAllocated() >= 1000 * sizeof(int));
+
+	graphsearch::FlatStateTable<int, std::hash<int>, graphsearch::ArenaAllocator<int>> table{allocator};
+	graphsearch::StateTable<int, std::hash<int>, graphsearch::ArenaAllocator<int>> node_table{allocator};
+	for (int i = 0; i < 1000; ++i)
+	{
+		table.intern(i * 7);
+		node_table.intern(i * 7);
+	}
+	ASSERTM("The flat table should find its states.", table.find(700) == 100 && table.find(701) == table.not_found);
+	ASSERTM("The table should find its states.", node_table.find(700) == 100 && node_table.find(701) == node_table.not_found);
+
+	graphsearch::BreadthFirstFrontier<int, graphsearch::ArenaAllocator<int>> frontier{allocator};
+	for (int i = 0; i < 1000; ++i)
+	{
+		frontier.add(i);
+	}
+	ASSERTM("The frontier should be first-in-first-out.", frontier.next() == 0);
+}
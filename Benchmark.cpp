@@ -0,0 +1,1908 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code benchmarks GraphSearch.h.  It is a separate program from the unit tests.  Build it with optimization,
+for example:  g++ -std=c++11 -O2 -pthread Benchmark.cpp -o benchmark
+
+Run it without arguments for the comparisons below, or with --suite to run every search mode on the problems from
+BenchmarkProblems.h and print a table, or with --json to print the same results as JSON, which can be saved and
+compared from one release to the next.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "Arena.h"
+#include "BenchmarkProblems.h"
+#define COUNTING_ALLOCATOR_BYTES  // Track the heap memory of each search
+#include "CountingAllocator.h"
+#include "CsrProblem.h"
+#include "GraphSearch.h"
+
+enum class GridActions { start_state, north, south, east, west };
+
+/*
+This class defines a square grid of integer states, numbered row by row, with four-way movement.  Every seventh
+column is a wall with a single gap, alternating between the top and bottom rows, so paths must zig-zag.  Entering a
+cell costs 1 or 3, depending on a fixed pattern of "rough" cells.
+*/
+class GridProblem : public graphsearch::Problem<int, GridActions>
+{
+	int width;
+	int goal;
+
+	bool isOpen(int x, int y) const
+	{
+		if (x % 7 != 6)
+		{
+			return true;
+		}
+		return (x / 7) % 2 == 0 ? y == width - 1 : y == 0;
+	}
+
+	void actions(int state, std::vector<GridActions>& available_actions) const override
+	{
+		int x = state % width;
+		int y = state / width;
+
+		++expanded;
+		if (y > 0 && isOpen(x, y - 1))
+		{
+			available_actions.push_back(GridActions::north);
+		}
+		if (y < width - 1 && isOpen(x, y + 1))
+		{
+			available_actions.push_back(GridActions::south);
+		}
+		if (x < width - 1 && isOpen(x + 1, y))
+		{
+			available_actions.push_back(GridActions::east);
+		}
+		if (x > 0 && isOpen(x - 1, y))
+		{
+			available_actions.push_back(GridActions::west);
+		}
+	}
+
+	const int result(int state, GridActions action) override
+	{
+		switch (action)
+		{
+		case GridActions::north:
+			return state - width;
+		case GridActions::south:
+			return state + width;
+		case GridActions::east:
+			return state + 1;
+		case GridActions::west:
+			return state - 1;
+		default:
+			throw "Unrecognized action.";
+		}
+	}
+
+	double stepCost(const int& /* state */, GridActions /* action */, const int& next_state) const override
+	{
+		return (next_state * 2654435761u) % 5 == 0 ? 3.0 : 1.0;
+	}
+
+	double heuristic(const int& state) const override
+	{
+		// Manhattan distance, which never overestimates because every step costs at least 1.
+		return std::abs(state % width - goal % width) + std::abs(state / width - goal / width);
+	}
+
+public:
+	mutable long expanded{0};  // The number of calls to "actions," which is the number of nodes expanded
+
+	GridProblem(int the_width) : width{the_width}, goal{the_width * the_width - 1}
+	{
+	}
+
+	int goalState() const
+	{
+		return goal;
+	}
+};
+
+/*
+This class defines a line of integer states, 0 through length - 1, with a move in each direction.  Expanding a state
+is about as cheap as possible, so the overhead of the frontier and the state table is a large share of the cost per node.
+*/
+template <typename StateTableType = graphsearch::StateTable<int>, typename StatsType = graphsearch::NoSearchStats>
+class LineProblem : public graphsearch::Problem<int, GridActions, std::hash<int>, StateTableType, StatsType>
+{
+	int length;
+
+	void actions(int state, std::vector<GridActions>& available_actions) const override
+	{
+		++expanded;
+		if (state < length - 1)
+		{
+			available_actions.push_back(GridActions::east);
+		}
+		if (state > 0)
+		{
+			available_actions.push_back(GridActions::west);
+		}
+	}
+
+	const int result(int state, GridActions action) override
+	{
+		return action == GridActions::east ? state + 1 : state - 1;
+	}
+
+public:
+	mutable long expanded{0};  // The number of calls to "actions," which is the number of nodes expanded
+
+	LineProblem(int the_length) : length{the_length}
+	{
+	}
+};
+
+/*
+This class defines a square grid of integer states, numbered row by row, with four-way movement and no obstacles.  It
+overrides "successors," which is safe to call from several threads at once, and "predecessors."  It counts the nodes
+expanded in either direction.
+*/
+class OpenGridProblem : public graphsearch::Problem<int, GridActions>
+{
+	int width;
+
+	void successors(const int& state, SuccessorSink& sink) override
+	{
+		int x = state % width;
+		int y = state / width;
+
+		++expanded;
+		if (y > 0)
+		{
+			sink.add(GridActions::north, state - width);
+		}
+		if (y < width - 1)
+		{
+			sink.add(GridActions::south, state + width);
+		}
+		if (x < width - 1)
+		{
+			sink.add(GridActions::east, state + 1);
+		}
+		if (x > 0)
+		{
+			sink.add(GridActions::west, state - 1);
+		}
+	}
+
+	void predecessors(const int& state, SuccessorSink& sink) override
+	{
+		int x = state % width;
+		int y = state / width;
+
+		++expanded;
+		if (y > 0)
+		{
+			sink.add(GridActions::south, state - width);
+		}
+		if (y < width - 1)
+		{
+			sink.add(GridActions::north, state + width);
+		}
+		if (x < width - 1)
+		{
+			sink.add(GridActions::west, state + 1);
+		}
+		if (x > 0)
+		{
+			sink.add(GridActions::east, state - 1);
+		}
+	}
+
+public:
+	std::atomic<long> expanded{0};
+
+	OpenGridProblem(int the_width) : width{the_width}
+	{
+	}
+};
+
+/*
+This class defines the same grid as OpenGridProblem, but its "result" stands in for an expensive simulation step:  it
+spins for several microseconds before returning the neighboring cell.  It counts the calls to "result."
+*/
+class SimulatedGridProblem : public graphsearch::Problem<int, GridActions>
+{
+	int width;
+
+	void actions(int state, std::vector<GridActions>& available_actions) const override
+	{
+		if (state / width > 0)
+		{
+			available_actions.push_back(GridActions::north);
+		}
+		if (state / width < width - 1)
+		{
+			available_actions.push_back(GridActions::south);
+		}
+		if (state % width < width - 1)
+		{
+			available_actions.push_back(GridActions::east);
+		}
+		if (state % width > 0)
+		{
+			available_actions.push_back(GridActions::west);
+		}
+	}
+
+	const int result(int state, GridActions action) override
+	{
+		volatile unsigned spin = 0;
+
+		++results;
+		for (int i = 0; i < 3000; ++i)
+		{
+			spin = spin * 31 + i;
+		}
+		switch (action)
+		{
+		case GridActions::north:
+			return state - width;
+		case GridActions::south:
+			return state + width;
+		case GridActions::east:
+			return state + 1;
+		default:
+			return state - 1;
+		}
+	}
+
+	double heuristic(const int& state) const override
+	{
+		return std::abs(state % width - goal % width) + std::abs(state / width - goal / width);
+	}
+
+public:
+	long results{0};
+	int goal{0};
+
+	SimulatedGridProblem(int the_width) : width{the_width}
+	{
+	}
+};
+
+/*
+This class searches the same explicit graph as CsrProblem, the way a problem without it would:  "actions" lists the
+edges from a vertex, and "result" looks up where each goes.  It keeps its states in the default StateTable.
+*/
+class ExplicitGraphProblem : public graphsearch::Problem<std::uint32_t, graphsearch::CsrEdge, std::hash<std::uint32_t>,
+	graphsearch::StateTable<std::uint32_t>, graphsearch::SearchStats>
+{
+	const graphsearch::CsrGraph& graph;
+
+	void actions(std::uint32_t state, std::vector<graphsearch::CsrEdge>& available_actions) const override
+	{
+		for (std::uint32_t e = graph.edgesBegin(state); e < graph.edgesEnd(state); ++e)
+		{
+			available_actions.push_back((graphsearch::CsrEdge)e);
+		}
+	}
+
+	const std::uint32_t result(std::uint32_t /* state */, graphsearch::CsrEdge action) override
+	{
+		return graph.target((std::uint32_t)action);
+	}
+
+public:
+	ExplicitGraphProblem(const graphsearch::CsrGraph& the_graph) : graph(the_graph)
+	{
+	}
+};
+
+/* A 200-byte state:  a position on a line plus a payload derived from it. */
+struct LargeState
+{
+	int position;
+	char payload[196];
+
+	LargeState() = default;
+
+	LargeState(int the_position) : position{the_position}
+	{
+		std::memset(payload, the_position & 0xff, sizeof(payload));
+	}
+
+	bool operator==(const LargeState& other) const
+	{
+		return position == other.position && std::memcmp(payload, other.payload, sizeof(payload)) == 0;
+	}
+};
+
+struct LargeStateHash
+{
+	std::size_t operator()(const LargeState& state) const
+	{
+		return std::hash<int>()(state.position);
+	}
+};
+
+/* This class defines the same line as LineProblem with LargeState states. */
+class LargeStateLineProblem : public graphsearch::Problem<LargeState, GridActions, LargeStateHash>
+{
+	int length;
+
+	void actions(LargeState state, std::vector<GridActions>& available_actions) const override
+	{
+		++expanded;
+		if (state.position < length - 1)
+		{
+			available_actions.push_back(GridActions::east);
+		}
+		if (state.position > 0)
+		{
+			available_actions.push_back(GridActions::west);
+		}
+	}
+
+	const LargeState result(LargeState state, GridActions action) override
+	{
+		return LargeState{action == GridActions::east ? state.position + 1 : state.position - 1};
+	}
+
+public:
+	mutable long expanded{0};  // The number of calls to "actions," which is the number of nodes expanded
+
+	LargeStateLineProblem(int the_length) : length{the_length}
+	{
+	}
+};
+
+/*
+Run one search of the grid from corner to corner, and print the nodes expanded and the elapsed time.  The method's
+type picks the overload of a search that takes a set of goal states.
+*/
+static void benchmarkGrid(const char* name, int width, bool (GridProblem::*search_method)(int, const std::unordered_set<int>&))
+{
+	GridProblem problem{width};
+	std::unordered_set<int> goal_states({ problem.goalState() });
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	bool found = (problem.*search_method)(0, goal_states);
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	std::vector<int> the_path;
+
+	if (found)
+	{
+		problem.path(the_path);
+	}
+	std::printf("%-14s %6d %12ld %10zu %12.3f\n", name, width, problem.expanded, the_path.size(), elapsed.count());
+}
+
+/* Compare the informed searches with breadth-first search on grids. */
+static void benchmarkInformedSearch()
+{
+	std::printf("%-14s %6s %12s %10s %12s\n", "search", "width", "expanded", "path", "ms");
+	for (int width : { 8, 10, 12, 100, 300, 1000 })
+	{
+		benchmarkGrid("breadth-first", width, &GridProblem::searchBreadthFirst);
+		benchmarkGrid("uniform-cost", width, &GridProblem::searchUniformCost);
+		benchmarkGrid("A*", width, &GridProblem::searchAStar);
+	}
+}
+
+/* Traverse the whole line repeatedly with a given search method, and print the nodes expanded per second. */
+template <typename SearchMethod>
+static void benchmarkLine(const char* name, SearchMethod search_method)
+{
+	const int length = 1000000;
+	const int repetitions = 10;
+	LineProblem<> problem{length};
+	std::unordered_set<int> no_goals;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < repetitions; ++i)
+	{
+		search_method(problem, no_goals);
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	std::printf("%-32s %12ld %14.0f\n", name, problem.expanded, problem.expanded / elapsed.count());
+}
+
+/* Compare a frontier called through the virtual Frontier interface with the same frontier as a policy. */
+static void benchmarkFrontierPolicy()
+{
+	typedef graphsearch::DepthFirstFrontier<LineProblem<>::NodeType> DepthFirst;
+	typedef graphsearch::BreadthFirstFrontier<LineProblem<>::NodeType> BreadthFirst;
+
+	std::printf("%-32s %12s %14s\n", "frontier", "expanded", "nodes/sec");
+	benchmarkLine("depth-first, virtual", [](LineProblem<>& problem, const std::unordered_set<int>& goals) {
+		std::unique_ptr<graphsearch::Frontier<LineProblem<>::NodeType>> frontier{new DepthFirst};
+		problem.search(0, goals, frontier.get());
+	});
+	benchmarkLine("depth-first, policy", [](LineProblem<>& problem, const std::unordered_set<int>& goals) {
+		problem.search<graphsearch::DepthFirstFrontier>(0, goals);
+	});
+	benchmarkLine("breadth-first, virtual", [](LineProblem<>& problem, const std::unordered_set<int>& goals) {
+		std::unique_ptr<graphsearch::Frontier<LineProblem<>::NodeType>> frontier{new BreadthFirst};
+		problem.search(0, goals, frontier.get());
+	});
+	benchmarkLine("breadth-first, policy", [](LineProblem<>& problem, const std::unordered_set<int>& goals) {
+		problem.search<graphsearch::BreadthFirstFrontier>(0, goals);
+	});
+}
+
+/*
+Traverse a line exhaustively with breadth-first search, and print the peak heap memory during the search and the heap
+memory retained afterward (for "solution" and "path"), both per node expanded.
+*/
+template <typename LineProblemType, typename StateSet>
+static void benchmarkNodeMemory(const char* name, int length)
+{
+	std::size_t bytes_before = bytes_in_use;
+	std::unique_ptr<LineProblemType> problem{new LineProblemType{length}};
+	StateSet no_goals;
+
+	peak_bytes_in_use = bytes_in_use.load();
+	problem->searchBreadthFirst(0, no_goals);
+	std::printf("%-24s %10ld %12zu %14.1f %14.1f\n", name, problem->expanded, sizeof(typename StateSet::value_type),
+			double(peak_bytes_in_use - bytes_before) / problem->expanded, double(bytes_in_use - bytes_before) / problem->expanded);
+}
+
+/* Measure the memory per node for small and large states. */
+static void benchmarkNodeStore()
+{
+	std::printf("%-24s %10s %12s %14s %14s\n", "problem", "expanded", "state bytes", "peak bytes/node", "kept bytes/node");
+	benchmarkNodeMemory<LineProblem<>, std::unordered_set<int>>("line, int", 1000000);
+	benchmarkNodeMemory<LineProblem<graphsearch::FlatStateTable<int>>, std::unordered_set<int>>("line, int, flat", 1000000);
+	benchmarkNodeMemory<LargeStateLineProblem, std::unordered_set<LargeState, LargeStateHash>>("line, 200-byte struct", 1000000);
+}
+
+/* A 12-byte state for the state table benchmarks. */
+struct PointState
+{
+	int x, y, z;
+
+	bool operator==(const PointState& other) const
+	{
+		return x == other.x && y == other.y && z == other.z;
+	}
+};
+
+struct PointStateHash
+{
+	std::size_t operator()(const PointState& state) const
+	{
+		return (std::size_t)state.x * 73856093u ^ (std::size_t)state.y * 19349663u ^ (std::size_t)state.z * 83492791u;
+	}
+};
+
+/* Return the i'th of a sequence of distinct, scattered states. */
+static int makeState(int i, int)
+{
+	return (int)((unsigned)i * 2654435761u);
+}
+
+static PointState makeState(int i, PointState)
+{
+	return PointState{ i % 1000, (i / 1000) % 1000, i / 1000000 };
+}
+
+/* Adapt std::unordered_set to the interface of the state tables, as the explored set was before StateTable. */
+template <typename StateType, typename StateHashType>
+class UnorderedStateSet
+{
+	std::unordered_set<StateType, StateHashType> states;
+
+public:
+	void intern(const StateType& state)
+	{
+		states.insert(state);
+	}
+
+	bool contains(const StateType& state) const
+	{
+		return states.count(state) == 1;
+	}
+};
+
+/*
+Add "count" states to a table, then look each one up, then look up as many states that are not in the table.  Print
+the time per operation for each phase and the heap memory per state.
+*/
+template <typename StateType, typename TableType>
+static void benchmarkTable(const char* name, int count)
+{
+	std::size_t bytes_before = bytes_in_use;
+	std::unique_ptr<TableType> table{new TableType};
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::chrono::duration<double, std::nano> insert_time, hit_time, miss_time;
+	long found = 0;
+
+	for (int i = 0; i < count; ++i)
+	{
+		table->intern(makeState(i, StateType()));
+	}
+	insert_time = std::chrono::steady_clock::now() - start;
+	std::size_t bytes = bytes_in_use - bytes_before;
+
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < count; ++i)
+	{
+		found += table->contains(makeState(i, StateType()));
+	}
+	hit_time = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	for (int i = count; i < 2 * count; ++i)
+	{
+		found += table->contains(makeState(i, StateType()));
+	}
+	miss_time = std::chrono::steady_clock::now() - start;
+
+	if (found != count)
+	{
+		std::printf("%s found %ld of %d states.\n", name, found, count);
+	}
+	std::printf("%-32s %10.1f %10.1f %10.1f %12.1f\n", name, insert_time.count() / count, hit_time.count() / count,
+			miss_time.count() / count, double(bytes) / count);
+}
+
+/* Compare the state tables with std::unordered_set on 10 million integer and structure states. */
+static void benchmarkStateTables()
+{
+	const int count = 10000000;
+
+	std::printf("%-32s %10s %10s %10s %12s\n", "table", "insert ns", "hit ns", "miss ns", "bytes/state");
+	benchmarkTable<int, UnorderedStateSet<int, std::hash<int>>>("int, std::unordered_set", count);
+	benchmarkTable<int, graphsearch::StateTable<int>>("int, StateTable", count);
+	benchmarkTable<int, graphsearch::FlatStateTable<int>>("int, FlatStateTable", count);
+	benchmarkTable<PointState, UnorderedStateSet<PointState, PointStateHash>>("struct, std::unordered_set", count);
+	benchmarkTable<PointState, graphsearch::StateTable<PointState, PointStateHash>>("struct, StateTable", count);
+	benchmarkTable<PointState, graphsearch::FlatStateTable<PointState, PointStateHash>>("struct, FlatStateTable", count);
+}
+
+/* Traverse a grid exhaustively with a parallel search using 1, 2, 4, ... threads. */
+template <typename SearchMethod>
+static void benchmarkParallelSearch(const char* name, SearchMethod search_method)
+{
+	const int width = 2000;
+	unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+	OpenGridProblem problem{width};
+	std::unordered_set<int> no_goals;
+	double one_thread_seconds = 0.0;
+
+	for (unsigned num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		(problem.*search_method)(0, no_goals, num_threads);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		if (num_threads == 1)
+		{
+			one_thread_seconds = elapsed.count();
+		}
+		std::printf("%-16s %8u %12.3f %14.0f %10.2f\n", name, num_threads, elapsed.count(),
+				double(width) * width / elapsed.count(), one_thread_seconds / elapsed.count());
+	}
+}
+
+/* Measure how the parallel searches scale with the number of threads. */
+static void benchmarkParallelSearches()
+{
+	std::printf("%-16s %8s %12s %14s %10s   (%u hardware threads)\n", "search", "threads", "seconds", "nodes/sec",
+			"speedup", std::thread::hardware_concurrency());
+	benchmarkParallelSearch("breadth-first", &OpenGridProblem::searchBreadthFirstParallel);
+	benchmarkParallelSearch("depth-first", &OpenGridProblem::searchDepthFirstParallel);
+}
+
+/* Search a grid from one state to another, and print the nodes expanded and the elapsed time. */
+template <typename SearchMethod>
+static void benchmarkOpenGrid(const char* name, const char* route, int width, int start, int goal, SearchMethod search_method)
+{
+	OpenGridProblem problem{width};
+	std::unordered_set<int> goal_states({ goal });
+	std::vector<int> the_path;
+	std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+	search_method(problem, start, goal_states);
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start_time;
+	problem.path(the_path);
+	std::printf("%-16s %-10s %6d %12ld %8zu %12.3f\n", name, route, width, problem.expanded.load(), the_path.size(), elapsed.count());
+}
+
+/*
+Compare bidirectional search with breadth-first search, between two interior states half a grid apart and from
+corner to corner.
+*/
+static void benchmarkBidirectional()
+{
+	std::printf("%-16s %-10s %6s %12s %8s %12s\n", "search", "route", "width", "expanded", "path", "ms");
+	for (int width : { 500, 2000 })
+	{
+		int interior = (width / 2) * width + width / 4;
+		auto breadth_first = [](OpenGridProblem& problem, int start, const std::unordered_set<int>& goals) {
+			problem.searchBreadthFirst(start, goals);
+		};
+		auto bidirectional = [](OpenGridProblem& problem, int start, const std::unordered_set<int>& goals) {
+			problem.searchBidirectional(start, goals);
+		};
+
+		benchmarkOpenGrid("breadth-first", "interior", width, interior, interior + width / 2, breadth_first);
+		benchmarkOpenGrid("bidirectional", "interior", width, interior, interior + width / 2, bidirectional);
+		benchmarkOpenGrid("breadth-first", "corners", width, 0, width * width - 1, breadth_first);
+		benchmarkOpenGrid("bidirectional", "corners", width, 0, width * width - 1, bidirectional);
+	}
+}
+
+/* Solve an eight puzzle, and print the nodes expanded, the solution length, the peak heap memory, and the elapsed time. */
+template <typename SearchMethod>
+static void benchmarkPuzzle(const char* name, int scramble_length, SearchMethod search_method)
+{
+	std::size_t bytes_before = bytes_in_use;
+	std::unique_ptr<SlidingTileProblem> problem{new SlidingTileProblem{3, 3}};
+	std::unordered_set<std::uint64_t> goal_states({ problem->goal() });
+	std::vector<Move> the_solution;
+
+	peak_bytes_in_use = bytes_in_use.load();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	search_method(*problem, problem->scramble(scramble_length, 12345), goal_states);
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	problem->solution(the_solution);
+	std::printf("%-22s %8d %12zu %8zu %14zu %12.3f\n", name, scramble_length, problem->stats().nodes_expanded,
+			the_solution.size(), peak_bytes_in_use - bytes_before, elapsed.count());
+}
+
+/*
+Compare the memory of the iterative-deepening searches with depth-first search and A* on eight puzzles.  Depth-first
+search finds a long solution and keeps every node it expands.  The iterative-deepening searches keep only the current
+path, at the cost of expanding shallow nodes again.  (The memory is the peak heap memory of the search, which stands
+in for the peak resident set size, which the process can't reset between searches.)
+*/
+static void benchmarkIterativeDeepening()
+{
+	std::printf("%-22s %8s %12s %8s %14s %12s\n", "search", "scramble", "expanded", "solution", "peak bytes", "ms");
+	for (int scramble_length : { 12, 24, 60 })
+	{
+		benchmarkPuzzle("depth-first", scramble_length, [](SlidingTileProblem& problem, std::uint64_t start,
+				const std::unordered_set<std::uint64_t>& goals) {
+			problem.searchDepthFirst(start, goals);
+		});
+		if (scramble_length <= 24)
+		{
+			benchmarkPuzzle("iterative deepening", scramble_length, [](SlidingTileProblem& problem, std::uint64_t start,
+					const std::unordered_set<std::uint64_t>& goals) {
+				problem.searchIterativeDeepening(start, goals, 40);
+			});
+		}
+		benchmarkPuzzle("iterative deepening, 4K", scramble_length, [](SlidingTileProblem& problem, std::uint64_t start,
+				const std::unordered_set<std::uint64_t>& goals) {
+			problem.searchIterativeDeepening(start, goals, 40, 4096);
+		});
+		benchmarkPuzzle("IDA*", scramble_length, [](SlidingTileProblem& problem, std::uint64_t start,
+				const std::unordered_set<std::uint64_t>& goals) {
+			problem.searchIDAStar(start, goals);
+		});
+		benchmarkPuzzle("A*", scramble_length, [](SlidingTileProblem& problem, std::uint64_t start,
+				const std::unordered_set<std::uint64_t>& goals) {
+			problem.searchAStar(start, goals);
+		});
+	}
+}
+
+/*
+Run short uniform-cost searches between random nearby cells of a 1000x1000 grid, each with a fresh problem or all with
+one problem, and print the queries per second and the allocations per query.  The reused problem first searches the
+whole grid, so its buffers are large, and each short search must clear them without touching all of their memory.
+*/
+template <typename ProblemType, typename MakeProblem>
+static void benchmarkShortQueries(const char* name, MakeProblem make_problem)
+{
+	const int width = 1000;
+	const int queries = 100000;
+	std::mt19937 random{21};
+	std::uniform_int_distribution<int> any_cell{0, width * width - 1}, offset{-2, 2};
+	std::vector<int> starts, goals;
+	std::unique_ptr<ProblemType> reused{make_problem()};
+
+	for (int i = 0; i < queries; ++i)
+	{
+		int start = any_cell(random);
+		int x = std::min(std::max(start % width + offset(random), 0), width - 1);
+		int y = std::min(std::max(start / width + offset(random), 0), width - 1);
+		starts.push_back(start);
+		goals.push_back(y * width + x);
+	}
+	reused->searchUniformCost(0, std::unordered_set<int>());
+
+	for (bool reuse : { false, true })
+	{
+		std::size_t allocations_before = allocation_count;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < queries; ++i)
+		{
+			std::unordered_set<int> goal_states({ goals[i] });
+			if (reuse)
+			{
+				reused->searchUniformCost(starts[i], goal_states);
+			}
+			else
+			{
+				std::unique_ptr<ProblemType> fresh{make_problem()};
+				fresh->searchUniformCost(starts[i], goal_states);
+			}
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::printf("%-24s %-14s %14.0f %16.1f\n", name, reuse ? "reused" : "fresh", queries / elapsed.count(),
+				double(allocation_count - allocations_before) / queries);
+	}
+}
+
+/* Compare a fresh problem per query with one problem that keeps its buffers, for each kind of state table. */
+static void benchmarkSearchReuse()
+{
+	static const GridWorld world{1000, 1000, 1, 0.0, 1};
+
+	std::printf("%-24s %-14s %14s %16s\n", "table", "problem", "queries/sec", "allocations/query");
+	benchmarkShortQueries<OpenGridProblem>("StateTable", []() { return new OpenGridProblem{1000}; });
+	benchmarkShortQueries<GridWorldProblem>("FlatStateTable", []() { return new GridWorldProblem{world, 0}; });
+}
+
+/*
+Traverse a 1000x1000 grid exhaustively with breadth-first search, in memory and on disk with memory
+budgets of a fraction of the 24 MB that the records of its million states take, and print the time and the peak heap
+memory of each.  The disk files go in the current directory.
+*/
+static void benchmarkExternalSearch()
+{
+	const int width = 1000;
+	OpenGridProblem problem{width};
+	std::unordered_set<int> no_goals;
+
+	std::printf("%-24s %12s %12s %16s\n", "search", "budget MB", "seconds", "peak heap MB");
+	for (std::size_t budget : { std::size_t{0}, std::size_t{6} << 20, std::size_t{1} << 20 })
+	{
+		std::size_t bytes_before = bytes_in_use;
+		peak_bytes_in_use = bytes_in_use.load();
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		if (budget == 0)
+		{
+			problem.searchBreadthFirst(0, no_goals);
+		}
+		else
+		{
+			problem.searchBreadthFirstExternal(0, no_goals, ".", budget);
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::printf("%-24s %12.0f %12.3f %16.1f\n", budget == 0 ? "in memory" : "external", budget / 1048576.0,
+				elapsed.count(), double(peak_bytes_in_use - bytes_before) / 1048576.0);
+	}
+}
+
+/*
+Search a 1000x1000 grid corner to corner with uniform-cost search for each result kind, and print the time and the
+peak heap memory of each.  Only the path needs the node store.
+*/
+static void benchmarkResultKinds()
+{
+	const int width = 1000;
+	std::unordered_set<int> goals({ width * width - 1 });
+	const graphsearch::ResultKind kinds[] = { graphsearch::ResultKind::path, graphsearch::ResultKind::distance,
+			graphsearch::ResultKind::reachability };
+	const char* names[] = { "path", "distance", "reachability" };
+
+	std::printf("%-24s %12s %16s\n", "result kind", "seconds", "peak heap MB");
+	for (int i = 0; i < 3; ++i)
+	{
+		std::size_t bytes_before = bytes_in_use;
+		peak_bytes_in_use = bytes_in_use.load();
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::unique_ptr<OpenGridProblem> problem{new OpenGridProblem{width}};
+
+		problem->setResultKind(kinds[i]);
+		problem->searchUniformCost(0, goals);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::printf("%-24s %12.3f %16.1f\n", names[i], elapsed.count(), double(peak_bytes_in_use - bytes_before) / 1048576.0);
+	}
+}
+
+/*
+Answer 1000 queries for the fewest actions between random cells of a 256x256 grid, with one breadth-first search per
+query and with one batched search, and print the queries per second and the states expanded per query.  Then find the
+nearest of 16 random cells to each of 1000 others, with one search per cell and with one search from the 16, which the
+grid's symmetry allows.
+*/
+static void benchmarkBatchSearch()
+{
+	const int width = 256;
+	const int queries = 1000;
+	std::mt19937 random{23};
+	std::uniform_int_distribution<int> any_cell{0, width * width - 1};
+	std::vector<int> sources, goals, depots;
+	std::vector<std::uint32_t> separate, batched, nearest_sources, distances;
+
+	for (int i = 0; i < queries; ++i)
+	{
+		sources.push_back(any_cell(random));
+		goals.push_back(any_cell(random));
+	}
+	for (int i = 0; i < 16; ++i)
+	{
+		depots.push_back(any_cell(random));
+	}
+	std::unordered_set<int> depot_states(depots.begin(), depots.end());
+
+	std::printf("%-24s %14s %16s\n", "search", "queries/sec", "expanded/query");
+	for (int mode = 0; mode < 4; ++mode)
+	{
+		OpenGridProblem problem{width};
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		problem.setResultKind(graphsearch::ResultKind::distance);
+		for (int i = 0; mode % 2 == 0 && i < queries; ++i)
+		{
+			bool found = mode == 0 ? problem.searchBreadthFirst(sources[i], std::unordered_set<int>({ goals[i] }))
+				: problem.searchBreadthFirst(sources[i], depot_states);
+			separate.push_back(found ? (std::uint32_t)problem.distance() : OpenGridProblem::unreachable);
+		}
+		if (mode == 1)
+		{
+			problem.searchBreadthFirstBatch(sources, goals, batched);
+		}
+		else if (mode == 3)
+		{
+			problem.searchBreadthFirstNearest(depots, sources, nearest_sources, distances);
+			batched.insert(batched.end(), distances.begin(), distances.end());
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		const char* names[] = { "one per query", "batched", "nearest, one per cell", "nearest, one search" };
+		std::printf("%-24s %14.0f %16.1f\n", names[mode], queries / elapsed.count(), double(problem.expanded) / queries);
+	}
+	if (separate != batched)
+	{
+		std::printf("The batched distances differ from the others.\n");
+	}
+}
+
+/*
+Answer 200 A* queries between random cells of the middle of a 200x200 grid whose "result" is expensive, on one problem,
+without a successor cache, with one large enough for every state, and with one that must evict, and print the time,
+the calls to "result," and the share of expansions the cache answered.
+*/
+static void benchmarkSuccessorCache()
+{
+	const int width = 200;
+	const int queries = 200;
+	std::mt19937 random{29};
+	std::uniform_int_distribution<int> middle{width / 4, width * 3 / 4 - 1};
+	std::vector<int> starts, goals;
+
+	for (int i = 0; i < queries; ++i)
+	{
+		starts.push_back(middle(random) * width + middle(random));
+		goals.push_back(middle(random) * width + middle(random));
+	}
+
+	std::printf("%-24s %12s %14s %10s\n", "successor cache", "seconds", "result calls", "hit rate");
+	for (std::size_t budget : { std::size_t{0}, std::size_t{64} << 20, std::size_t{256} << 10 })
+	{
+		SimulatedGridProblem problem{width};
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		problem.setSuccessorCache(budget);
+		for (int i = 0; i < queries; ++i)
+		{
+			problem.goal = goals[i];
+			problem.searchAStar(starts[i], std::unordered_set<int>({ goals[i] }));
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		const graphsearch::Problem<int, GridActions>::SuccessorCacheType* cache = problem.successorCache();
+		std::printf("%-24s %12.3f %14ld %10.2f\n", budget == 0 ? "off" : budget > (1 << 20) ? "64 MB" : "256 KB",
+				elapsed.count(), problem.results, cache == nullptr ? 0.0 : double(cache->hits()) / (cache->hits() + cache->misses()));
+	}
+}
+
+/* Traverse a graph exhaustively depth-first, and print the time, the nodes expanded per second, and the peak heap memory. */
+template <typename ProblemType>
+static void traverseExplicitGraph(const char* name, const graphsearch::CsrGraph& graph)
+{
+	std::size_t bytes_before = bytes_in_use;
+	peak_bytes_in_use = bytes_in_use.load();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::unique_ptr<ProblemType> problem{new ProblemType{graph}};
+
+	problem->setResultKind(graphsearch::ResultKind::reachability);
+	problem->searchDepthFirst(0, std::unordered_set<std::uint32_t>());
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	std::printf("%-24s %12.3f %16.0f %16.1f\n", name, elapsed.count(), problem->stats().nodes_expanded / elapsed.count(),
+			double(peak_bytes_in_use - bytes_before) / 1048576.0);
+}
+
+/*
+Traverse a random graph of 5 million vertices and 50 million edges exhaustively with depth-first search, as a
+CsrProblem and as the equivalent ExplicitGraphProblem, and print the time, the nodes expanded per second, and the peak
+heap memory of the search, which doesn't include the graph.  Building the graph from its edge list is timed, too.
+*/
+static void benchmarkCsrProblem()
+{
+	const std::uint32_t vertices = 5000000;
+	const std::uint32_t degree = 10;
+	std::mt19937 random{31};
+	std::uniform_int_distribution<std::uint32_t> any_vertex{0, vertices - 1};
+	std::unique_ptr<graphsearch::CsrGraph> graph;
+
+	{
+		std::vector<std::uint32_t> sources, targets;
+		sources.reserve(std::size_t{vertices} * degree);
+		targets.reserve(std::size_t{vertices} * degree);
+		for (std::size_t i = 0; i < std::size_t{vertices} * degree; ++i)
+		{
+			sources.push_back(any_vertex(random));
+			targets.push_back(any_vertex(random));
+		}
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		graph.reset(new graphsearch::CsrGraph{vertices, sources, targets});
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::printf("built a graph of %u edges from an edge list in %.3f seconds\n", graph->edges(), elapsed.count());
+	}
+
+	std::printf("%-24s %12s %16s %16s\n", "problem", "seconds", "expanded/sec", "peak heap MB");
+	traverseExplicitGraph<graphsearch::CsrProblem<graphsearch::SearchStats>>("CsrProblem", *graph);
+	traverseExplicitGraph<ExplicitGraphProblem>("actions and result", *graph);
+}
+
+/*
+Build an undirected power-law graph with the R-MAT generator of Chakrabarti, Zhan, and Faloutsos, with the parameters
+of the Graph500 benchmark:  2^scale vertices and edge_factor * 2^scale edges in each direction.  Self-loops and
+duplicate edges are kept.
+*/
+static graphsearch::CsrGraph rmatGraph(unsigned scale, unsigned edge_factor, unsigned seed)
+{
+	std::mt19937 random{seed};
+	std::uniform_real_distribution<double> quadrant{0.0, 1.0};
+	std::size_t num_edges = (std::size_t{edge_factor} << scale);
+	std::vector<std::uint32_t> sources, targets;
+
+	sources.reserve(2 * num_edges);
+	targets.reserve(2 * num_edges);
+	for (std::size_t i = 0; i < num_edges; ++i)
+	{
+		std::uint32_t u = 0, v = 0;
+		for (unsigned bit = 0; bit < scale; ++bit)
+		{
+			double r = quadrant(random);
+			u = u << 1 | (r >= 0.76 ? 1 : 0);                             // Quadrants c and d
+			v = v << 1 | ((r >= 0.57 && r < 0.76) || r >= 0.95 ? 1 : 0);  // Quadrants b and d
+		}
+		sources.push_back(u);
+		targets.push_back(v);
+		sources.push_back(v);
+		targets.push_back(u);
+	}
+	return graphsearch::CsrGraph{std::uint32_t{1} << scale, sources, targets};
+}
+
+/*
+Compare the direction-optimizing breadth-first search with the same search kept top-down, and with the plain
+breadth-first search of the other problems, on full traversals of a power-law graph from several sources.
+*/
+static void benchmarkDirectionOptimizing()
+{
+	const unsigned scale = 21;
+	graphsearch::CsrGraph graph = rmatGraph(scale, 8, 41);
+	graphsearch::CsrProblem<graphsearch::SearchStats> problem{graph};
+	std::unordered_set<std::uint32_t> no_goals;
+	std::vector<std::uint32_t> sources;
+	std::mt19937 random{43};
+	std::uniform_int_distribution<std::uint32_t> any_vertex{0, graph.vertices() - 1};
+
+	graph.addReverseEdges();
+	problem.setResultKind(graphsearch::ResultKind::reachability);
+	while (sources.size() < 4)
+	{
+		std::uint32_t source = any_vertex(random);
+		if (graph.degree(source) > 0)
+		{
+			sources.push_back(source);
+		}
+	}
+	std::printf("R-MAT graph of %u vertices and %u edges, %zu traversals\n", graph.vertices(), graph.edges(),
+		sources.size());
+	std::printf("%-24s %12s %16s %12s\n", "search", "seconds", "edges/sec", "levels");
+
+	const char* names[] = { "breadth-first", "top-down", "direction-optimizing" };
+	for (int method = 0; method < 3; ++method)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::size_t levels = 0;
+		for (std::uint32_t source : sources)
+		{
+			if (method == 0)
+			{
+				problem.searchBreadthFirst(source, no_goals);
+			}
+			else
+			{
+				problem.searchBreadthFirstDirectionOptimizing(source, no_goals, method == 1 ? 0.0 :
+					problem.default_top_down_factor);
+			}
+			levels += problem.stats().max_depth + 1;
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::printf("%-24s %12.3f %16.0f %12zu\n", names[method], elapsed.count(),
+			(double)graph.edges() * sources.size() / elapsed.count(), levels);
+	}
+}
+
+/*
+Run 32 threads at once, each answering its own A* queries on a shared grid with a fresh problem per query.  The
+problems allocate from the global allocator, or from an arena per thread that is released after each query.  Print the
+queries per second and the global allocations per query.  The counting allocator above adds atomic updates to every allocation, which makes contention for it somewhat worse than
+with the plain global allocator.
+*/
+static void benchmarkConcurrentSearches(bool use_arena)
+{
+	static const GridWorld world{256, 256, 1, 0.2, 5};
+	const unsigned num_threads = 32;
+	const int queries_per_thread = 40;
+	std::vector<std::thread> threads;
+	std::size_t allocations_before = allocation_count;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (unsigned t = 0; t < num_threads; ++t)
+	{
+		threads.emplace_back([use_arena, t, queries_per_thread]() {
+			std::mt19937 random{t};
+			graphsearch::MonotonicArena arena;
+
+			for (int i = 0; i < queries_per_thread; ++i)
+			{
+				int from = world.randomOpenCell(random);
+				std::unordered_set<int> goal_states({ world.randomOpenCell(random) });
+
+				if (use_arena)
+				{
+					{
+						BasicGridWorldProblem<graphsearch::ArenaAllocator<int>> problem{world, *goal_states.begin(),
+							graphsearch::ArenaAllocator<int>{arena}};
+						problem.searchAStar(from, goal_states);
+					}
+					arena.release();  // The problem is gone, so all of its memory can go at once.
+				}
+				else
+				{
+					GridWorldProblem problem{world, *goal_states.begin()};
+					problem.searchAStar(from, goal_states);
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	std::printf("%-24s %8u %14.0f %20.1f\n", use_arena ? "arena per thread" : "global allocator", num_threads,
+			num_threads * queries_per_thread / elapsed.count(),
+			double(allocation_count - allocations_before) / (num_threads * queries_per_thread));
+}
+
+/* Compare concurrent independent searches with and without an arena. */
+static void benchmarkArena()
+{
+	std::printf("%-24s %8s %14s %20s   (%u hardware threads)\n", "memory", "threads", "queries/sec",
+			"allocations/query", std::thread::hardware_concurrency());
+	benchmarkConcurrentSearches(false);
+	benchmarkConcurrentSearches(true);
+}
+
+/* Traverse the whole line repeatedly with breadth-first search, and print the nodes expanded per second. */
+template <typename StatsType>
+static LineProblem<graphsearch::FlatStateTable<int>, StatsType> benchmarkStatsLine(const char* name)
+{
+	const int length = 1000000;
+	const int repetitions = 10;
+	LineProblem<graphsearch::FlatStateTable<int>, StatsType> problem{length};
+	std::unordered_set<int> no_goals;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < repetitions; ++i)
+	{
+		problem.searchBreadthFirst(0, no_goals);
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	std::printf("%-24s %12ld %14.0f\n", name, problem.expanded, problem.expanded / elapsed.count());
+	return problem;
+}
+
+/* Measure the cost of collecting statistics, and print the statistics of the last search. */
+static void benchmarkSearchStats()
+{
+	typedef std::chrono::duration<double, std::milli> Milliseconds;
+
+	std::printf("%-24s %12s %14s\n", "statistics", "expanded", "nodes/sec");
+	benchmarkStatsLine<graphsearch::NoSearchStats>("none");
+	const graphsearch::SearchStats stats = benchmarkStatsLine<graphsearch::SearchStats>("SearchStats").stats();
+
+	std::printf("last search:  %zu expanded, %zu generated, %zu duplicates, peak frontier %zu, peak nodes %zu, "
+			"depth %u, %.1f ms in successors, %.1f ms bookkeeping\n", stats.nodes_expanded, stats.nodes_generated,
+			stats.duplicate_hits, stats.peak_frontier, stats.peak_nodes, stats.max_depth,
+			Milliseconds(stats.successor_time).count(), Milliseconds(stats.bookkeepingTime()).count());
+}
+
+enum class SearchMode
+{
+	breadth_first, depth_first, uniform_cost, a_star, bidirectional, breadth_first_parallel, depth_first_parallel,
+	iterative_deepening, ida_star
+};
+
+static const char* modeName(SearchMode mode)
+{
+	static const char* const names[] = { "breadth-first", "depth-first", "uniform-cost", "A*", "bidirectional",
+		"breadth-first parallel", "depth-first parallel", "iterative deepening", "IDA*" };
+	return names[(int)mode];
+}
+
+/*
+Run a search.  The parallel searches use every hardware thread.  Iterative deepening goes up to 200 actions, and it
+remembers up to 64K states per round, without which it would take exponential time on grids.
+*/
+template <typename ProblemType, typename StateType, typename StateSet>
+static bool runSearch(ProblemType& problem, SearchMode mode, const StateType& start, const StateSet& goals)
+{
+	unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+	switch (mode)
+	{
+	case SearchMode::breadth_first:
+		return problem.searchBreadthFirst(start, goals);
+	case SearchMode::depth_first:
+		return problem.searchDepthFirst(start, goals);
+	case SearchMode::uniform_cost:
+		return problem.searchUniformCost(start, goals);
+	case SearchMode::a_star:
+		return problem.searchAStar(start, goals);
+	case SearchMode::bidirectional:
+		return problem.searchBidirectional(start, goals);
+	case SearchMode::breadth_first_parallel:
+		return problem.searchBreadthFirstParallel(start, goals, threads);
+	case SearchMode::depth_first_parallel:
+		return problem.searchDepthFirstParallel(start, goals, threads);
+	case SearchMode::iterative_deepening:
+		return problem.searchIterativeDeepening(start, goals, 200, 65536);
+	default:
+		return problem.searchIDAStar(start, goals);
+	}
+}
+
+/* The results of one search mode on one problem, over a set of queries */
+struct SuiteResult
+{
+	std::string problem;
+	const char* mode;
+	std::size_t queries;
+	std::size_t solved;
+	std::size_t nodes_expanded;
+	double nodes_per_second;
+	double bytes_per_node;     // The peak heap memory of each search, summed, over the nodes expanded
+	std::size_t peak_frontier; // The largest peak frontier of any query
+	double latency_ms[3];      // The 50th, 90th, and 99th percentile time per query
+};
+
+static const double suite_percentiles[] = { 0.50, 0.90, 0.99 };
+
+template <typename StateType>
+struct SuiteQuery
+{
+	StateType start;
+	StateType goal;
+};
+
+/*
+Run each query with a fresh problem from "make_problem," which takes the goal, and add the results to "results."
+Every problem collects SearchStats, which count the nodes.  The time includes the cost of collecting them.
+*/
+template <typename StateType, typename StateHashType, typename MakeProblem>
+static void runQueries(std::vector<SuiteResult>& results, const std::string& problem_name,
+	const std::vector<SuiteQuery<StateType>>& queries, MakeProblem make_problem, std::initializer_list<SearchMode> modes)
+{
+	for (SearchMode mode : modes)
+	{
+		SuiteResult result{problem_name, modeName(mode), queries.size(), 0, 0, 0.0, 0.0, 0, {}};
+		std::vector<double> latencies;
+		double total_seconds = 0.0, total_bytes = 0.0;
+
+		for (const SuiteQuery<StateType>& query : queries)
+		{
+			std::unordered_set<StateType, StateHashType> goal_states({ query.goal });
+			std::size_t bytes_before = bytes_in_use;
+
+			peak_bytes_in_use = bytes_in_use.load();
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			auto problem = make_problem(query.goal);
+			result.solved += runSearch(*problem, mode, query.start, goal_states);
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+			latencies.push_back(elapsed.count() * 1000.0);
+			total_seconds += elapsed.count();
+			total_bytes += peak_bytes_in_use - bytes_before;
+			result.nodes_expanded += problem->stats().nodes_expanded;
+			result.peak_frontier = std::max(result.peak_frontier, problem->stats().peak_frontier);
+		}
+
+		std::sort(latencies.begin(), latencies.end());
+		for (int i = 0; i < 3; ++i)
+		{
+			std::size_t rank = (std::size_t)std::ceil(suite_percentiles[i] * latencies.size());
+			result.latency_ms[i] = latencies[std::max<std::size_t>(rank, 1) - 1];
+		}
+		result.nodes_per_second = result.nodes_expanded / total_seconds;
+		result.bytes_per_node = total_bytes / std::max<std::size_t>(result.nodes_expanded, 1);
+		results.push_back(result);
+	}
+}
+
+/* Return queries between random open cells of a grid. */
+static std::vector<SuiteQuery<int>> gridQueries(const GridWorld& world, int count, unsigned seed)
+{
+	std::mt19937 random{seed};
+	std::vector<SuiteQuery<int>> queries;
+
+	for (int i = 0; i < count; ++i)
+	{
+		int start = world.randomOpenCell(random);
+		queries.push_back(SuiteQuery<int>{start, world.randomOpenCell(random)});
+	}
+	return queries;
+}
+
+/*
+Run every search mode that finishes in reasonable time on each generated problem.  searchBreadthFirst and
+searchDepthFirst expand a state once per path that reaches it before it is explored, and iterative deepening
+expands a state once per path, so they run on small problems only.
+*/
+static std::vector<SuiteResult> runSuite()
+{
+	std::vector<SuiteResult> results;
+	const std::initializer_list<SearchMode> graph_modes = { SearchMode::uniform_cost, SearchMode::a_star,
+		SearchMode::bidirectional, SearchMode::breadth_first_parallel, SearchMode::depth_first_parallel };
+
+	{
+		GridWorld world{16, 16, 1, 0.2, 1};
+		runQueries<int, std::hash<int>>(results, "grid2d 16x16, 20% obstacles", gridQueries(world, 20, 11),
+			[&world](int goal) { return std::unique_ptr<GridWorldProblem>(new GridWorldProblem{world, goal}); },
+			{ SearchMode::breadth_first, SearchMode::depth_first, SearchMode::uniform_cost, SearchMode::a_star,
+			SearchMode::bidirectional, SearchMode::breadth_first_parallel, SearchMode::depth_first_parallel,
+			SearchMode::iterative_deepening, SearchMode::ida_star });
+	}
+	{
+		GridWorld world{512, 512, 1, 0.2, 2};
+		runQueries<int, std::hash<int>>(results, "grid2d 512x512, 20% obstacles", gridQueries(world, 20, 12),
+			[&world](int goal) { return std::unique_ptr<GridWorldProblem>(new GridWorldProblem{world, goal}); }, graph_modes);
+	}
+	{
+		GridWorld world{64, 64, 64, 0.2, 3};
+		runQueries<int, std::hash<int>>(results, "grid3d 64x64x64, 20% obstacles", gridQueries(world, 10, 13),
+			[&world](int goal) { return std::unique_ptr<GridWorldProblem>(new GridWorldProblem{world, goal}); }, graph_modes);
+	}
+	{
+		GridWorld world{128, 128, 1, 0.2, 4};
+		std::vector<SuiteQuery<LargeGridState>> queries;
+		for (const SuiteQuery<int>& query : gridQueries(world, 10, 14))
+		{
+			queries.push_back(SuiteQuery<LargeGridState>{LargeGridState{query.start}, LargeGridState{query.goal}});
+		}
+		runQueries<LargeGridState, LargeGridStateHash>(results, "grid2d 128x128, 256-byte states", queries,
+			[&world](const LargeGridState& goal) {
+				return std::unique_ptr<LargeStateGridProblem>(new LargeStateGridProblem{world, goal.cell});
+			}, graph_modes);
+	}
+	{
+		RandomGraph graph{200000, 4, 5};
+		std::mt19937 random{15};
+		std::uniform_int_distribution<std::uint32_t> any_vertex{0, graph.vertices() - 1};
+		std::vector<SuiteQuery<std::uint32_t>> queries;
+		for (int i = 0; i < 20; ++i)
+		{
+			std::uint32_t start = any_vertex(random);
+			queries.push_back(SuiteQuery<std::uint32_t>{start, any_vertex(random)});
+		}
+		runQueries<std::uint32_t, std::hash<std::uint32_t>>(results, "random graph 200K vertices, degree 4", queries,
+			[&graph](std::uint32_t goal) { return std::unique_ptr<RandomGraphProblem>(new RandomGraphProblem{graph, goal}); },
+			graph_modes);
+	}
+	{
+		std::vector<SuiteQuery<std::uint64_t>> queries;
+		for (unsigned seed = 0; seed < 20; ++seed)
+		{
+			SlidingTileProblem puzzle{3, 3};
+			queries.push_back(SuiteQuery<std::uint64_t>{puzzle.scramble(40, seed), puzzle.goal()});
+		}
+		runQueries<std::uint64_t, std::hash<std::uint64_t>>(results, "sliding tile 3x3, 40-move scramble", queries,
+			[](std::uint64_t) { return std::unique_ptr<SlidingTileProblem>(new SlidingTileProblem{3, 3}); },
+			{ SearchMode::depth_first, SearchMode::uniform_cost, SearchMode::a_star, SearchMode::bidirectional,
+			SearchMode::breadth_first_parallel, SearchMode::depth_first_parallel, SearchMode::iterative_deepening,
+			SearchMode::ida_star });
+	}
+	{
+		std::vector<SuiteQuery<std::uint64_t>> queries;
+		for (unsigned seed = 0; seed < 20; ++seed)
+		{
+			SlidingTileProblem puzzle{4, 4};
+			queries.push_back(SuiteQuery<std::uint64_t>{puzzle.scramble(40, seed), puzzle.goal()});
+		}
+		runQueries<std::uint64_t, std::hash<std::uint64_t>>(results, "sliding tile 4x4, 40-move scramble", queries,
+			[](std::uint64_t) { return std::unique_ptr<SlidingTileProblem>(new SlidingTileProblem{4, 4}); },
+			{ SearchMode::a_star, SearchMode::ida_star });
+	}
+	return results;
+}
+
+static void printSuite(const std::vector<SuiteResult>& results)
+{
+	std::printf("%-38s %-24s %8s %12s %14s %10s %12s %10s %10s %10s\n", "problem", "search", "solved", "expanded",
+			"nodes/sec", "bytes/node", "peak front.", "p50 ms", "p90 ms", "p99 ms");
+	for (const SuiteResult& result : results)
+	{
+		std::printf("%-38s %-24s %4zu/%-3zu %12zu %14.0f %10.1f %12zu %10.3f %10.3f %10.3f\n", result.problem.c_str(),
+				result.mode, result.solved, result.queries, result.nodes_expanded, result.nodes_per_second,
+				result.bytes_per_node, result.peak_frontier, result.latency_ms[0], result.latency_ms[1], result.latency_ms[2]);
+	}
+}
+
+static void printSuiteJson(const std::vector<SuiteResult>& results)
+{
+	std::printf("{\n  \"hardware_threads\": %u,\n  \"results\": [", std::thread::hardware_concurrency());
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		const SuiteResult& result = results[i];
+		std::printf("%s\n    {\"problem\": \"%s\", \"search\": \"%s\", \"queries\": %zu, \"solved\": %zu, "
+				"\"nodes_expanded\": %zu, \"nodes_per_second\": %.0f, \"bytes_per_node\": %.1f, \"peak_frontier\": %zu, "
+				"\"latency_ms\": {\"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f}}", i == 0 ? "" : ",",
+				result.problem.c_str(), result.mode, result.queries, result.solved, result.nodes_expanded,
+				result.nodes_per_second, result.bytes_per_node, result.peak_frontier, result.latency_ms[0],
+				result.latency_ms[1], result.latency_ms[2]);
+	}
+	std::printf("\n  ]\n}\n");
+}
+
+/*
+Compare searchBreadthFirstDense, which marks the states visited in a bitmap, with searchBreadthFirst, which keeps them
+in a hash table, on full traversals:  of an open grid of 100 million states, whose
+levels are all small, and of the R-MAT graph, whose middle levels are bitmaps, with each set of bitmap instructions
+the processor supports.
+*/
+static void benchmarkDenseSearch()
+{
+	const int width = 10000;
+	const graphsearch::BitmapInstructions all_instructions[] = {
+		graphsearch::BitmapInstructions::scalar, graphsearch::BitmapInstructions::sse,
+		graphsearch::BitmapInstructions::avx2 };
+	const char* instruction_names[] = { "scalar", "SSE", "AVX2" };
+	graphsearch::BitmapInstructions original = graphsearch::bitmapInstructions();
+
+	std::printf("%-32s %12s %16s %16s\n", "traversal", "seconds", "expanded/sec", "peak heap MB");
+	for (int dense = 1; dense >= 0; --dense)
+	{
+		std::size_t bytes_before = bytes_in_use;
+		peak_bytes_in_use = bytes_in_use.load();
+		std::unique_ptr<OpenGridProblem> problem{new OpenGridProblem{width}};
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		problem->setResultKind(graphsearch::ResultKind::reachability);
+		if (dense == 1)
+		{
+			problem->searchBreadthFirstDense(width * (width / 2) + width / 2, std::unordered_set<int>(),
+				(std::size_t)width * width);
+		}
+		else
+		{
+			problem->searchBreadthFirst(width * (width / 2) + width / 2, std::unordered_set<int>());
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::printf("%-32s %12.3f %16.0f %16.1f\n", dense == 1 ? "grid, bitmap" : "grid, hash table", elapsed.count(),
+			problem->expanded / elapsed.count(), double(peak_bytes_in_use - bytes_before) / 1048576.0);
+	}
+
+	graphsearch::CsrGraph graph = rmatGraph(21, 8, 41);
+	graphsearch::CsrProblem<graphsearch::SearchStats> problem{graph};
+	problem.setResultKind(graphsearch::ResultKind::reachability);
+	for (std::size_t i = 0; i <= sizeof(all_instructions) / sizeof(all_instructions[0]); ++i)
+	{
+		std::string name;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		if (i < sizeof(all_instructions) / sizeof(all_instructions[0]))
+		{
+			if (graphsearch::setBitmapInstructions(all_instructions[i]) != all_instructions[i])
+			{
+				continue;
+			}
+			name = std::string("R-MAT, bitmap, ") + instruction_names[i];
+			problem.searchBreadthFirstDense(0, std::unordered_set<std::uint32_t>(), graph.vertices());
+		}
+		else
+		{
+			name = "R-MAT, hash table";
+			problem.searchBreadthFirst(0, std::unordered_set<std::uint32_t>());
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::printf("%-32s %12.3f %16.0f %16s\n", name.c_str(), elapsed.count(),
+			problem.stats().nodes_expanded / elapsed.count(), "");
+	}
+	graphsearch::setBitmapInstructions(original);
+}
+
+/* This class searches a RandomGraph for any vertex to the left of a given x coordinate. */
+class RegionGraphProblem : public RandomGraphProblem
+{
+	const RandomGraph& graph;
+	double max_x;
+
+	bool isGoal(const std::uint32_t& state) const override
+	{
+		return graph.x[state] < max_x;
+	}
+
+public:
+	RegionGraphProblem(const RandomGraph& the_graph, double the_max_x)
+		: RandomGraphProblem{the_graph, 0}, graph(the_graph), max_x{the_max_x}
+	{
+	}
+};
+
+/*
+Compare testing goals when they are generated with testing them when they leave the frontier, in breadth-first
+searches of a random graph for single goals:  search<BreadthFirstFrontier> tests them when they leave it.  Then compare
+listing a goal region of a million states in a set with recognizing them with isGoal.
+*/
+static void benchmarkGoalTests()
+{
+	RandomGraph graph{2000000, 8, 51};
+	RegionGraphProblem problem{graph, 0.5};
+	std::mt19937 random{53};
+	std::uniform_int_distribution<std::uint32_t> any_vertex{0, graph.vertices() - 1};
+	std::vector<std::uint32_t> goals;
+
+	problem.setResultKind(graphsearch::ResultKind::reachability);
+	for (int i = 0; i < 5; ++i)
+	{
+		goals.push_back(any_vertex(random));
+	}
+	std::printf("%-28s %14s %14s %12s\n", "goal test", "generated", "expanded", "seconds");
+	for (int on_generation = 0; on_generation <= 1; ++on_generation)
+	{
+		std::size_t generated = 0, expanded = 0;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for (std::uint32_t goal : goals)
+		{
+			std::unordered_set<std::uint32_t> goal_states({ goal });
+			if (on_generation == 1)
+			{
+				problem.searchBreadthFirst(0, goal_states);
+			}
+			else
+			{
+				problem.search<graphsearch::BreadthFirstFrontier>(0, goal_states);
+			}
+			generated += problem.stats().nodes_generated;
+			expanded += problem.stats().nodes_expanded;
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::printf("%-28s %14zu %14zu %12.3f\n", on_generation == 1 ? "on generation" : "leaving the frontier", generated,
+			expanded, elapsed.count());
+	}
+
+	std::printf("\n%-28s %14s %14s %12s\n", "goal region", "states listed", "setup ms", "search ms");
+	for (int use_set = 1; use_set >= 0; --use_set)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::unordered_set<std::uint32_t> goal_states;
+		if (use_set == 1)
+		{
+			for (std::uint32_t v = 0; v < graph.vertices(); ++v)
+			{
+				if (graph.x[v] < 0.5)
+				{
+					goal_states.insert(v);
+				}
+			}
+		}
+		std::chrono::steady_clock::time_point setup_end = std::chrono::steady_clock::now();
+		if (use_set == 1)
+		{
+			problem.searchBreadthFirst(goals[0], goal_states);
+		}
+		else
+		{
+			problem.searchBreadthFirst(goals[0]);
+		}
+		std::chrono::duration<double, std::milli> setup = setup_end - start;
+		std::chrono::duration<double, std::milli> search = std::chrono::steady_clock::now() - setup_end;
+		std::printf("%-28s %14zu %14.3f %12.3f\n", use_set == 1 ? "set of goal states" : "isGoal", goal_states.size(),
+			setup.count(), search.count());
+	}
+}
+
+/*
+Track the frontier memory of the searches on a dense random graph:  full traversals with breadth-first and depth-first
+search, marking states on generation and on expansion, and uniform-cost and A* searches across the graph.  Print the
+peak frontier, the nodes expanded and generated, and the peak heap, so that a change to the frontiers shows up here.
+*/
+static void benchmarkFrontierMemory()
+{
+	RandomGraph graph{200000, 32, 61};
+	RandomGraphProblem problem{graph, graph.vertices() - 1};
+	std::unordered_set<std::uint32_t> no_goals, goal_states({ graph.vertices() - 1 });
+	const graphsearch::StateMarking markings[] = { graphsearch::StateMarking::on_generation,
+		graphsearch::StateMarking::on_expansion };
+	const char* marking_names[] = { "on generation", "on expansion" };
+
+	std::printf("%-34s %14s %14s %14s %10s %14s\n", "search", "peak frontier", "expanded", "generated", "seconds",
+		"peak heap MB");
+	for (int method = 0; method < 6; ++method)
+	{
+		std::string name;
+		std::size_t bytes_before = bytes_in_use;
+		peak_bytes_in_use = bytes_in_use.load();
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		if (method < 4)
+		{
+			problem.setResultKind(graphsearch::ResultKind::reachability);
+			problem.setStateMarking(markings[method % 2]);
+			name = std::string(method < 2 ? "breadth-first, " : "depth-first, ") + marking_names[method % 2];
+			if (method < 2)
+			{
+				problem.searchBreadthFirst(0, no_goals);
+			}
+			else
+			{
+				problem.searchDepthFirst(0, no_goals);
+			}
+		}
+		else
+		{
+			problem.setResultKind(graphsearch::ResultKind::distance);
+			name = method == 4 ? "uniform-cost" : "A*";
+			if (method == 4)
+			{
+				problem.searchUniformCost(0, goal_states);
+			}
+			else
+			{
+				problem.searchAStar(0, goal_states);
+			}
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::printf("%-34s %14zu %14zu %14zu %10.3f %14.1f\n", name.c_str(), problem.stats().peak_frontier,
+			problem.stats().nodes_expanded, problem.stats().nodes_generated, elapsed.count(),
+			double(peak_bytes_in_use - bytes_before) / 1048576.0);
+	}
+}
+
+/*
+Run A* queries across a random graph, each with its own problem:  one after another without limits, one after another
+with limits that never stop them, which shows what checking the limits costs, and interleaved on one thread in slices
+of a budget of nodes, resuming each query in turn, which shows what stopping and resuming costs and how long the
+longest slice takes.  Then stop a query at a deadline, and print how far past the deadline it returned, which includes
+clearing the problem's last search.
+*/
+static void benchmarkSearchLimits()
+{
+	const std::size_t num_queries = 8, slice = 2000;
+	RandomGraph graph{1000000, 8, 71};
+	std::vector<std::unique_ptr<RandomGraphProblem>> problems;
+	std::vector<std::unordered_set<std::uint32_t>> goal_states;
+	std::vector<std::uint32_t> sources;
+	std::mt19937 random{73};
+	std::uniform_int_distribution<std::uint32_t> any_vertex{0, graph.vertices() - 1};
+	graphsearch::CancellationToken token;
+
+	for (std::size_t i = 0; i < num_queries; ++i)
+	{
+		std::uint32_t goal = any_vertex(random);
+		problems.emplace_back(new RandomGraphProblem{graph, goal});
+		problems.back()->setResultKind(graphsearch::ResultKind::distance);
+		goal_states.push_back(std::unordered_set<std::uint32_t>({ goal }));
+		sources.push_back(any_vertex(random));
+	}
+
+	std::printf("%-28s %12s %12s %14s %16s\n", "queries", "seconds", "expanded", "calls", "longest call ms");
+	for (int mode = 0; mode < 3; ++mode)
+	{
+		std::size_t expanded = 0, calls = 0;
+		double longest = 0.0;
+		graphsearch::SearchLimits limits;
+		std::vector<graphsearch::SearchStatus> statuses(num_queries);
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		if (mode == 1)
+		{
+			limits.deadline = start + std::chrono::hours(1);
+			limits.cancellation = &token;
+		}
+		else if (mode == 2)
+		{
+			limits.max_expansions = slice;
+		}
+		for (std::size_t round = 0, running = num_queries; running > 0; ++round)
+		{
+			running = 0;
+			for (std::size_t i = 0; i < num_queries; ++i)
+			{
+				std::chrono::steady_clock::time_point call_start = std::chrono::steady_clock::now();
+				if (round == 0 && mode == 0)
+				{
+					problems[i]->searchAStar(sources[i], goal_states[i]);
+				}
+				else if (round == 0)
+				{
+					statuses[i] = problems[i]->searchAStar(sources[i], goal_states[i], limits);
+				}
+				else if (graphsearch::stoppedEarly(statuses[i]))
+				{
+					statuses[i] = problems[i]->resumeSearch(goal_states[i], limits);
+				}
+				else
+				{
+					continue;
+				}
+				std::chrono::duration<double, std::milli> call = std::chrono::steady_clock::now() - call_start;
+				longest = std::max(longest, call.count());
+				++calls;
+				if (mode != 0 && graphsearch::stoppedEarly(statuses[i]))
+				{
+					++running;
+				}
+				else
+				{
+					expanded += problems[i]->stats().nodes_expanded;
+				}
+			}
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		const char* names[] = { "one at a time", "one at a time, limited", "interleaved" };
+		std::printf("%-28s %12.3f %12zu %14zu %16.3f\n", names[mode], elapsed.count(), expanded, calls, longest);
+	}
+
+	std::printf("\n%-28s %12s %14s\n", "deadline", "expanded", "overrun us");
+	for (int ms : { 1, 10 })
+	{
+		graphsearch::SearchLimits limits;
+		limits.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+		graphsearch::SearchStatus status = problems[0]->searchAStar(sources[0], goal_states[0], limits);
+		std::chrono::duration<double, std::micro> overrun = std::chrono::steady_clock::now() - limits.deadline;
+		std::printf("%-28s %12zu %14.1f%s\n", (std::to_string(ms) + " ms").c_str(), problems[0]->stats().nodes_expanded,
+			overrun.count(), status == graphsearch::SearchStatus::deadline_passed ? "" : " (finished first)");
+	}
+}
+
+/*
+Plan a path across a 1000x1000 grid with 10% of its cells blocked and a random cost from 1 to 4 for each move, then
+change the costs of 0.1% of the moves at random for several ticks.  After each tick, repair the plan with the
+incremental search, and plan again from scratch with A* on a second problem with the same costs, and compare the time
+and the nodes expanded.  The changed moves are either spread over the whole grid, or clustered in one square region,
+as around a moving obstacle.  Spread out, they change the path cost of most of the states the search has reached, so
+the incremental search has to expand them all again.
+*/
+static void benchmarkIncrementalSearch()
+{
+	const int width = 1000, ticks = 10;
+	GridWorld world{width, width, 1, 0.1, 81};
+	std::vector<double> costs((std::size_t)world.cells() * world.moves());
+	std::mt19937 random{83};
+	std::uniform_real_distribution<double> any_cost{1.0, 4.0};
+	std::uniform_int_distribution<int> any_move{0, world.moves() - 1};
+	int start = world.randomOpenCell(random), goal = world.randomOpenCell(random);
+	WeightedGridProblem incremental{world, costs, goal}, fresh{world, costs, goal};
+	std::unordered_set<int> goal_states({ goal });
+	std::size_t changes = costs.size() / 1000;
+	int region_width = (int)std::sqrt((double)changes / world.moves());  // A region with about "changes" moves
+
+	for (double& cost : costs)
+	{
+		cost = any_cost(random);
+	}
+	incremental.setResultKind(graphsearch::ResultKind::distance);
+	fresh.setResultKind(graphsearch::ResultKind::distance);
+
+	std::printf("grid of %d cells, %zu moves changed per tick\n", world.cells(), changes);
+	std::printf("%-24s %16s %20s %12s\n", "changes, search", "ms per tick", "expanded per tick", "mismatches");
+	for (int clustered = 0; clustered <= 1; ++clustered)
+	{
+		double incremental_seconds = 0.0, fresh_seconds = 0.0;
+		std::size_t incremental_expanded = 0, fresh_expanded = 0, mismatches = 0;
+		std::uniform_int_distribution<int> any_corner{0, width - region_width};
+
+		incremental.searchIncremental(start, goal);
+		for (int tick = 0; tick < ticks; ++tick)
+		{
+			int corner = any_corner(random) * width + any_corner(random);
+			for (std::size_t i = 0; i < changes; ++i)
+			{
+				int cell = clustered == 1 ? corner + (int)(i / world.moves()) / region_width * width
+					+ (int)(i / world.moves()) % region_width : world.randomOpenCell(random);
+				int move = clustered == 1 ? (int)(i % world.moves()) : any_move(random);
+				int next = world.isOpen(cell) ? world.neighbor(cell, move) : -1;
+				if (next >= 0)
+				{
+					costs[(std::size_t)cell * world.moves() + move] = any_cost(random);
+					incremental.edgeChanged(cell, next);
+				}
+			}
+
+			std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+			bool found = incremental.replan();
+			std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+			bool fresh_found = fresh.searchAStar(start, goal_states);
+			std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+			incremental_seconds += std::chrono::duration<double>(middle - start_time).count();
+			fresh_seconds += std::chrono::duration<double>(end - middle).count();
+			incremental_expanded += incremental.stats().nodes_expanded;
+			fresh_expanded += fresh.stats().nodes_expanded;
+			if (found != fresh_found || (found && std::abs(incremental.distance() - fresh.distance()) > 1e-9 * fresh.distance()))
+			{
+				++mismatches;
+			}
+		}
+		const char* names[] = { "spread out", "clustered" };
+		std::printf("%-24s %16.3f %20zu %12zu\n", (std::string(names[clustered]) + ", replan").c_str(),
+			1000.0 * incremental_seconds / ticks, incremental_expanded / ticks, mismatches);
+		std::printf("%-24s %16.3f %20zu\n", (std::string(names[clustered]) + ", fresh A*").c_str(),
+			1000.0 * fresh_seconds / ticks, fresh_expanded / ticks);
+	}
+}
+
+/*
+Compare the peak heap of a breadth-first search with that of beam searches and of a search whose frontier is bounded,
+all under the same memory ceiling, on a grid large enough that the breadth-first search exceeds it.
+*/
+static void benchmarkBoundedMemory()
+{
+	const int width = 3000;
+	const std::size_t ceiling = 32u << 20;
+	GridWorld world{width, width, 1, 0.2, 89};
+	int start = width / 10 * width + width / 10, goal = width * 9 / 10 * width + width * 9 / 10;
+
+	while (!world.isOpen(start))
+	{
+		++start;
+	}
+	while (!world.isOpen(goal))
+	{
+		++goal;
+	}
+	std::unordered_set<int> goal_states({ goal });
+
+	// Order nodes as A* would, by their depth plus their distance to the goal, so that the frontier grows.
+	struct LowerEstimate
+	{
+		const GridWorld* world;
+		int goal;
+
+		bool operator()(const GridWorldProblem::NodeType& a, const GridWorldProblem::NodeType& b) const
+		{
+			return a.depth + world->manhattanDistance(a.state, goal) > b.depth + world->manhattanDistance(b.state, goal);
+		}
+	};
+
+	std::printf("grid of %d cells, ceiling %.1f MB\n", world.cells(), double(ceiling) / 1048576.0);
+	std::printf("%-24s %8s %10s %12s %12s %10s %14s %8s\n", "search", "found", "distance", "expanded", "pruned",
+		"seconds", "peak heap MB", "within");
+	for (int method = 0; method < 4; ++method)
+	{
+		std::string name;
+		bool found;
+		double distance;
+		std::size_t expanded, pruned;
+		std::size_t bytes_before = bytes_in_use;
+		peak_bytes_in_use = bytes_in_use.load();
+		std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+		{
+			GridWorldProblem problem{world, goal};
+			problem.setResultKind(graphsearch::ResultKind::distance);
+			if (method == 0)
+			{
+				name = "breadth-first";
+				found = problem.searchBreadthFirst(start, goal_states);
+				pruned = 0;
+			}
+			else if (method < 3)
+			{
+				std::size_t beam_width = method == 1 ? 64 : 256;
+				name = "beam, width " + std::to_string(beam_width);
+				found = problem.searchBeam(start, goal_states, beam_width);
+				pruned = problem.stats().nodes_pruned;
+			}
+			else
+			{
+				// The frontier gets a sixteenth of the ceiling; the state table and nodes still grow with the search.
+				typedef graphsearch::BoundedFrontier<GridWorldProblem::NodeType, LowerEstimate> Bounded;
+				Bounded frontier{Bounded::nodesWithin(ceiling / 16), LowerEstimate{&world, goal}};
+				name = "bounded frontier";
+				found = problem.search(start, goal_states, &frontier);
+				pruned = frontier.pruned();
+			}
+			distance = found ? problem.distance() : 0.0;
+			expanded = problem.stats().nodes_expanded;
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+		double peak = double(peak_bytes_in_use - bytes_before);
+		std::printf("%-24s %8s %10.0f %12zu %12zu %10.3f %14.1f %8s\n", name.c_str(), found ? "yes" : "no", distance,
+			expanded, pruned, elapsed.count(), peak / 1048576.0, peak <= ceiling ? "yes" : "no");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && std::strcmp(argv[1], "--suite") == 0)
+	{
+		printSuite(runSuite());
+		return 0;
+	}
+	if (argc > 1 && std::strcmp(argv[1], "--json") == 0)
+	{
+		printSuiteJson(runSuite());
+		return 0;
+	}
+
+	benchmarkInformedSearch();
+	std::printf("\n");
+	benchmarkFrontierPolicy();
+	std::printf("\n");
+	benchmarkNodeStore();
+	std::printf("\n");
+	benchmarkStateTables();
+	std::printf("\n");
+	benchmarkParallelSearches();
+	std::printf("\n");
+	benchmarkBidirectional();
+	std::printf("\n");
+	benchmarkIterativeDeepening();
+	std::printf("\n");
+	benchmarkSearchStats();
+	std::printf("\n");
+	benchmarkSearchReuse();
+	std::printf("\n");
+	benchmarkArena();
+	std::printf("\n");
+	benchmarkExternalSearch();
+	std::printf("\n");
+	benchmarkResultKinds();
+	std::printf("\n");
+	benchmarkBatchSearch();
+	std::printf("\n");
+	benchmarkSuccessorCache();
+	std::printf("\n");
+	benchmarkCsrProblem();
+	std::printf("\n");
+	benchmarkDirectionOptimizing();
+	std::printf("\n");
+	benchmarkDenseSearch();
+	std::printf("\n");
+	benchmarkGoalTests();
+	std::printf("\n");
+	benchmarkFrontierMemory();
+	std::printf("\n");
+	benchmarkSearchLimits();
+	std::printf("\n");
+	benchmarkIncrementalSearch();
+	std::printf("\n");
+	benchmarkBoundedMemory();
+	return 0;
+}
@@ -0,0 +1,546 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code generates large synthetic problems for Benchmark.cpp:  2D and 3D grids with obstacles, with unit costs or a
+cost for each move, random sparse graphs, sliding-tile puzzles, and grids whose states are large structures.  Each
+generator takes its size and a seed, so the same parameters always produce the same problem.
+
+A generated world, such as a GridWorld, is built once and shared.  A problem refers to a world and holds only the goal
+for its heuristic, so a benchmark can create a fresh problem for every query and measure the memory of the search
+alone.  Every problem collects SearchStats and overrides "predecessors," so that every search mode can run on it.
+*/
+
+#pragma once
+
+#include <cmath>         // std::sqrt
+#include <cstddef>       // std::size_t
+#include <cstdint>       // std::uint32_t, std::uint64_t
+#include <cstdlib>       // std::abs
+#include <cstring>       // std::memset, std::memcmp
+#include <functional>    // std::hash
+#include <memory>        // std::allocator
+#include <random>
+#include <vector>
+#include "GraphSearch.h"
+
+/*
+The action types of the generated problems number their moves from 0:  a direction on a grid or a puzzle, or an edge
+of a graph.  start_state is a value no move uses.
+*/
+enum class Move : std::uint32_t { start_state = UINT32_MAX };
+
+/*
+A grid of cells, width by height by depth, some of which are blocked.  A 2D grid has a depth of 1.  Cells are numbered
+x first, then y, then z.  The moves are the six directions in the order +x, -x, +y, -y, +z, -z, so the opposite of
+move m is m ^ 1.
+*/
+class GridWorld
+{
+	std::vector<char> blocked;
+
+public:
+	const int width, height, depth;
+
+	/* Block each cell with the given probability. */
+	GridWorld(int the_width, int the_height, int the_depth, double obstacle_density, unsigned seed)
+		: blocked((std::size_t)the_width * the_height * the_depth), width{the_width}, height{the_height}, depth{the_depth}
+	{
+		std::mt19937 random{seed};
+		std::bernoulli_distribution obstacle{obstacle_density};
+
+		for (char& cell : blocked)
+		{
+			cell = obstacle(random);
+		}
+	}
+
+	int cells() const
+	{
+		return (int)blocked.size();
+	}
+
+	bool isOpen(int cell) const
+	{
+		return !blocked[cell];
+	}
+
+	/* Return a random open cell. */
+	int randomOpenCell(std::mt19937& random) const
+	{
+		std::uniform_int_distribution<int> any_cell{0, cells() - 1};
+		int cell;
+
+		do
+		{
+			cell = any_cell(random);
+		} while (!isOpen(cell));
+		return cell;
+	}
+
+	/* Return the open cell one move from the given cell, or -1 if the move leaves the grid or enters a blocked cell. */
+	int neighbor(int cell, int move) const
+	{
+		int x = cell % width;
+		int y = (cell / width) % height;
+		int z = cell / (width * height);
+		int next;
+
+		switch (move)
+		{
+		case 0:
+			next = x < width - 1 ? cell + 1 : -1;
+			break;
+		case 1:
+			next = x > 0 ? cell - 1 : -1;
+			break;
+		case 2:
+			next = y < height - 1 ? cell + width : -1;
+			break;
+		case 3:
+			next = y > 0 ? cell - width : -1;
+			break;
+		case 4:
+			next = z < depth - 1 ? cell + width * height : -1;
+			break;
+		default:
+			next = z > 0 ? cell - width * height : -1;
+			break;
+		}
+		return next >= 0 && isOpen(next) ? next : -1;
+	}
+
+	int moves() const
+	{
+		return depth > 1 ? 6 : 4;
+	}
+
+	/* Return the number of moves between two cells if there were no obstacles. */
+	int manhattanDistance(int a, int b) const
+	{
+		return std::abs(a % width - b % width) + std::abs((a / width) % height - (b / width) % height)
+			+ std::abs(a / (width * height) - b / (width * height));
+	}
+};
+
+/*
+This class searches a GridWorld with unit costs.  Its heuristic is the Manhattan distance to the goal.  The template
+variable is the problem's allocator; GridWorldProblem uses the standard one.
+*/
+template <typename AllocatorType>
+class BasicGridWorldProblem : public graphsearch::Problem<int, Move, std::hash<int>,
+	graphsearch::FlatStateTable<int, std::hash<int>, AllocatorType>, graphsearch::SearchStats, AllocatorType>
+{
+	typedef typename BasicGridWorldProblem::SuccessorSink SuccessorSink;
+
+	const GridWorld& world;
+	int goal;
+
+	void successors(const int& state, SuccessorSink& sink) override
+	{
+		for (int move = 0; move < world.moves(); ++move)
+		{
+			int next = world.neighbor(state, move);
+			if (next >= 0)
+			{
+				sink.add((Move)move, next);
+			}
+		}
+	}
+
+	void predecessors(const int& state, SuccessorSink& sink) override
+	{
+		for (int move = 0; move < world.moves(); ++move)
+		{
+			int previous = world.neighbor(state, move);
+			if (previous >= 0)
+			{
+				sink.add((Move)(move ^ 1), previous);
+			}
+		}
+	}
+
+	double heuristic(const int& state) const override
+	{
+		return world.manhattanDistance(state, goal);
+	}
+
+public:
+	BasicGridWorldProblem(const GridWorld& the_world, int the_goal, const AllocatorType& allocator = AllocatorType())
+		: BasicGridWorldProblem::Problem(allocator), world(the_world), goal{the_goal}
+	{
+	}
+};
+
+typedef BasicGridWorldProblem<std::allocator<int>> GridWorldProblem;
+
+/*
+This class searches a GridWorld in which each move has its own cost, at least 1, given by "costs" at
+cell * moves + move.  The costs belong to the benchmark, which can change them between searches.  Its heuristic is the
+Manhattan distance to the goal.
+*/
+class WeightedGridProblem : public graphsearch::Problem<int, Move, std::hash<int>, graphsearch::FlatStateTable<int>,
+	graphsearch::SearchStats>
+{
+	const GridWorld& world;
+	const std::vector<double>& costs;
+	int goal;
+
+	void successors(const int& state, SuccessorSink& sink) override
+	{
+		for (int move = 0; move < world.moves(); ++move)
+		{
+			int next = world.neighbor(state, move);
+			if (next >= 0)
+			{
+				sink.add((Move)move, next);
+			}
+		}
+	}
+
+	void predecessors(const int& state, SuccessorSink& sink) override
+	{
+		for (int move = 0; move < world.moves(); ++move)
+		{
+			int previous = world.neighbor(state, move);
+			if (previous >= 0)
+			{
+				sink.add((Move)(move ^ 1), previous);
+			}
+		}
+	}
+
+	double stepCost(const int& state, Move action, const int& /* next_state */) const override
+	{
+		return costs[(std::size_t)state * world.moves() + (std::size_t)action];
+	}
+
+	double heuristic(const int& state) const override
+	{
+		return world.manhattanDistance(state, goal);
+	}
+
+public:
+	WeightedGridProblem(const GridWorld& the_world, const std::vector<double>& the_costs, int the_goal)
+		: world(the_world), costs(the_costs), goal{the_goal}
+	{
+	}
+};
+
+/* A 256-byte state:  a cell of a GridWorld plus a payload derived from it. */
+struct LargeGridState
+{
+	int cell;
+	unsigned char payload[252];
+
+	LargeGridState() = default;
+
+	LargeGridState(int the_cell) : cell{the_cell}
+	{
+		std::memset(payload, the_cell & 0xff, sizeof(payload));
+	}
+
+	bool operator==(const LargeGridState& other) const
+	{
+		return cell == other.cell && std::memcmp(payload, other.payload, sizeof(payload)) == 0;
+	}
+};
+
+struct LargeGridStateHash
+{
+	std::size_t operator()(const LargeGridState& state) const
+	{
+		return std::hash<int>()(state.cell);
+	}
+};
+
+/* This class searches a GridWorld, as GridWorldProblem does, with LargeGridState states. */
+class LargeStateGridProblem : public graphsearch::Problem<LargeGridState, Move, LargeGridStateHash,
+	graphsearch::FlatStateTable<LargeGridState, LargeGridStateHash>, graphsearch::SearchStats>
+{
+	const GridWorld& world;
+	int goal;
+
+	void successors(const LargeGridState& state, SuccessorSink& sink) override
+	{
+		for (int move = 0; move < world.moves(); ++move)
+		{
+			int next = world.neighbor(state.cell, move);
+			if (next >= 0)
+			{
+				sink.add((Move)move, LargeGridState{next});
+			}
+		}
+	}
+
+	void predecessors(const LargeGridState& state, SuccessorSink& sink) override
+	{
+		for (int move = 0; move < world.moves(); ++move)
+		{
+			int previous = world.neighbor(state.cell, move);
+			if (previous >= 0)
+			{
+				sink.add((Move)(move ^ 1), LargeGridState{previous});
+			}
+		}
+	}
+
+	double heuristic(const LargeGridState& state) const override
+	{
+		return world.manhattanDistance(state.cell, goal);
+	}
+
+public:
+	LargeStateGridProblem(const GridWorld& the_world, int the_goal) : world(the_world), goal{the_goal}
+	{
+	}
+};
+
+/*
+A random sparse directed graph.  Each vertex has a random position in the unit square and "degree" edges to random
+vertices.  An edge costs between one and two times the distance between its ends, so the straight-line distance to the
+goal never overestimates the cost.  The edges are stored in compressed rows, forward and reversed:  move m from a
+vertex is its m'th edge, and each reversed edge records the source vertex and the source's move.
+*/
+class RandomGraph
+{
+public:
+	struct ReverseEdge
+	{
+		std::uint32_t source;
+		std::uint32_t move;
+	};
+
+	std::vector<double> x, y;
+	std::vector<std::uint32_t> edge_offsets;  // Vertex v's edges are edge_offsets[v] up to edge_offsets[v + 1]
+	std::vector<std::uint32_t> edge_targets;
+	std::vector<double> edge_costs;
+	std::vector<std::uint32_t> reverse_offsets;
+	std::vector<ReverseEdge> reverse_edges;
+
+	RandomGraph(std::uint32_t vertices, std::uint32_t degree, unsigned seed)
+		: x(vertices), y(vertices), edge_offsets(vertices + 1), reverse_offsets(vertices + 1, 0)
+	{
+		std::mt19937 random{seed};
+		std::uniform_real_distribution<double> unit{0.0, 1.0};
+		std::uniform_int_distribution<std::uint32_t> any_vertex{0, vertices - 1};
+
+		for (std::uint32_t v = 0; v < vertices; ++v)
+		{
+			x[v] = unit(random);
+			y[v] = unit(random);
+		}
+		for (std::uint32_t v = 0; v < vertices; ++v)
+		{
+			edge_offsets[v] = (std::uint32_t)edge_targets.size();
+			for (std::uint32_t e = 0; e < degree; ++e)
+			{
+				std::uint32_t target = any_vertex(random);
+				edge_targets.push_back(target);
+				edge_costs.push_back(distance(v, target) * (1.0 + unit(random)));
+				++reverse_offsets[target + 1];
+			}
+		}
+		edge_offsets[vertices] = (std::uint32_t)edge_targets.size();
+
+		// Count the edges into each vertex, then place each reversed edge.
+		for (std::uint32_t v = 0; v < vertices; ++v)
+		{
+			reverse_offsets[v + 1] += reverse_offsets[v];
+		}
+		std::vector<std::uint32_t> next_reverse(reverse_offsets.begin(), reverse_offsets.end() - 1);
+		reverse_edges.resize(edge_targets.size());
+		for (std::uint32_t v = 0; v < vertices; ++v)
+		{
+			for (std::uint32_t e = edge_offsets[v]; e < edge_offsets[v + 1]; ++e)
+			{
+				reverse_edges[next_reverse[edge_targets[e]]++] = ReverseEdge{v, e - edge_offsets[v]};
+			}
+		}
+	}
+
+	std::uint32_t vertices() const
+	{
+		return (std::uint32_t)x.size();
+	}
+
+	double distance(std::uint32_t a, std::uint32_t b) const
+	{
+		return std::sqrt((x[a] - x[b]) * (x[a] - x[b]) + (y[a] - y[b]) * (y[a] - y[b]));
+	}
+};
+
+/* This class searches a RandomGraph.  Its heuristic is the straight-line distance to the goal. */
+class RandomGraphProblem : public graphsearch::Problem<std::uint32_t, Move, std::hash<std::uint32_t>,
+	graphsearch::FlatStateTable<std::uint32_t>, graphsearch::SearchStats>
+{
+	const RandomGraph& graph;
+	std::uint32_t goal;
+
+	void successors(const std::uint32_t& state, SuccessorSink& sink) override
+	{
+		std::uint32_t first = graph.edge_offsets[state];
+
+		for (std::uint32_t e = first; e < graph.edge_offsets[state + 1]; ++e)
+		{
+			sink.add((Move)(e - first), graph.edge_targets[e]);
+		}
+	}
+
+	void predecessors(const std::uint32_t& state, SuccessorSink& sink) override
+	{
+		for (std::uint32_t e = graph.reverse_offsets[state]; e < graph.reverse_offsets[state + 1]; ++e)
+		{
+			sink.add((Move)graph.reverse_edges[e].move, graph.reverse_edges[e].source);
+		}
+	}
+
+	double stepCost(const std::uint32_t& state, Move action, const std::uint32_t& /* next_state */) const override
+	{
+		return graph.edge_costs[graph.edge_offsets[state] + (std::uint32_t)action];
+	}
+
+	double heuristic(const std::uint32_t& state) const override
+	{
+		return graph.distance(state, goal);
+	}
+
+public:
+	RandomGraphProblem(const RandomGraph& the_graph, std::uint32_t the_goal) : graph(the_graph), goal{the_goal}
+	{
+	}
+};
+
+/*
+This class defines a sliding-tile puzzle on a board of up to 16 cells, such as the eight puzzle (3x3) or the fifteen
+puzzle (4x4).  A state packs the tile in each cell into four bits, cell 0 lowest, and the blank is 0.  The moves move
+the blank in the order down, up, right, left, so the opposite of move m is m ^ 1.  The goal has tile i in cell i.  The
+heuristic is the sum of the tiles' Manhattan distances from their goal cells.
+*/
+class SlidingTileProblem : public graphsearch::Problem<std::uint64_t, Move, std::hash<std::uint64_t>,
+	graphsearch::FlatStateTable<std::uint64_t>, graphsearch::SearchStats>
+{
+	int width, height;
+
+	static unsigned tile(std::uint64_t state, int cell)
+	{
+		return (state >> (4 * cell)) & 0xf;
+	}
+
+	static int blank(std::uint64_t state)
+	{
+		int cell = 0;
+
+		while (tile(state, cell) != 0)
+		{
+			++cell;
+		}
+		return cell;
+	}
+
+	/* Return the state after moving the tile in cell "to" into the blank in cell "from." */
+	static std::uint64_t slide(std::uint64_t state, int from, int to)
+	{
+		std::uint64_t moved = tile(state, to);
+		return (state & ~(0xfull << (4 * to))) | (moved << (4 * from));
+	}
+
+	/* Return the cell the blank moves to, or -1 if the move leaves the board. */
+	int target(int cell, int move) const
+	{
+		switch (move)
+		{
+		case 0:
+			return cell / width < height - 1 ? cell + width : -1;
+		case 1:
+			return cell >= width ? cell - width : -1;
+		case 2:
+			return cell % width < width - 1 ? cell + 1 : -1;
+		default:
+			return cell % width > 0 ? cell - 1 : -1;
+		}
+	}
+
+	void successors(const std::uint64_t& state, SuccessorSink& sink) override
+	{
+		int cell = blank(state);
+
+		for (int move = 0; move < 4; ++move)
+		{
+			int next = target(cell, move);
+			if (next >= 0)
+			{
+				sink.add((Move)move, slide(state, cell, next));
+			}
+		}
+	}
+
+	// Every move can be undone by the opposite move.
+	void predecessors(const std::uint64_t& state, SuccessorSink& sink) override
+	{
+		int cell = blank(state);
+
+		for (int move = 0; move < 4; ++move)
+		{
+			int next = target(cell, move);
+			if (next >= 0)
+			{
+				sink.add((Move)(move ^ 1), slide(state, cell, next));
+			}
+		}
+	}
+
+	double heuristic(const std::uint64_t& state) const override
+	{
+		int distance = 0;
+
+		for (int cell = 0; cell < width * height; ++cell)
+		{
+			int goal_cell = (int)tile(state, cell);
+			if (goal_cell != 0)
+			{
+				distance += std::abs(cell % width - goal_cell % width) + std::abs(cell / width - goal_cell / width);
+			}
+		}
+		return distance;
+	}
+
+public:
+	SlidingTileProblem(int the_width, int the_height) : width{the_width}, height{the_height}
+	{
+	}
+
+	std::uint64_t goal() const
+	{
+		std::uint64_t state = 0;
+
+		for (int cell = 0; cell < width * height; ++cell)
+		{
+			state |= (std::uint64_t)cell << (4 * cell);
+		}
+		return state;
+	}
+
+	/* Return the state reached from the goal by a pseudo-random walk of the given length that never backtracks. */
+	std::uint64_t scramble(int length, unsigned seed) const
+	{
+		std::mt19937 random{seed};
+		std::uint64_t state = goal();
+		int cell = 0, previous_move = -1;
+
+		while (length > 0)
+		{
+			int move = (int)(random() % 4);
+			int next = target(cell, move);
+			if (next < 0 || move == (previous_move ^ 1))
+			{
+				continue;
+			}
+			state = slide(state, cell, next);
+			cell = next;
+			previous_move = move;
+			--length;
+		}
+		return state;
+	}
+};
@@ -0,0 +1,422 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code implements a bitmap of the states of a problem whose states are the integers from 0 up to some size, for
+use with GraphSearch.h.  Such a problem can mark the states it has visited with one bit each instead of an entry in a
+hash table, and a level of a breadth-first search that holds a large part of the states can be kept as a bitmap, too.
+Combining two such bitmaps, masking one with another, and counting their bits are then loops over whole words, which
+Bitmap runs with AVX2 or SSE instructions when the processor has them.
+
+The instructions are chosen when a program first uses a bitmap, from what the processor supports, so one build runs
+on any x86-64 processor; elsewhere, or with compilers other than GCC and Clang, the loops are plain C++ on 64-bit
+words.  "setBitmapInstructions" chooses less, for example to compare the loops.
+*/
+
+#pragma once
+
+#include <algorithm>     // std::fill, std::swap
+#include <cstddef>       // std::size_t
+#include <cstdint>       // std::uint64_t
+#include <vector>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define GRAPHSEARCH_BITMAP_X86 1
+#include <immintrin.h>
+#endif
+
+namespace graphsearch
+{
+	/* The instructions for the loops over whole bitmaps, from least to most capable. */
+	enum class BitmapInstructions { scalar, sse, avx2 };
+
+	namespace bitmap_detail
+	{
+		/*
+		The loops over the words of bitmaps, in one set of instructions.  "unite" sets the bits of "source" in
+		"target."  "subtract" clears the bits of "mask" in "target."  "count" counts the bits set.  "merge" clears the
+		bits of "visited" in "level," sets the bits left in "visited," and counts them.
+		*/
+		struct Kernels
+		{
+			void (*unite)(std::uint64_t* target, const std::uint64_t* source, std::size_t num_words);
+			void (*subtract)(std::uint64_t* target, const std::uint64_t* mask, std::size_t num_words);
+			std::size_t (*count)(const std::uint64_t* words, std::size_t num_words);
+			std::size_t (*merge)(std::uint64_t* level, std::uint64_t* visited, std::size_t num_words);
+		};
+
+		inline unsigned popCount(std::uint64_t word)
+		{
+#if defined(__GNUC__)
+			return (unsigned)__builtin_popcountll(word);
+#else
+			word -= (word >> 1) & 0x5555555555555555;
+			word = (word & 0x3333333333333333) + ((word >> 2) & 0x3333333333333333);
+			word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0f;
+			return (unsigned)((word * 0x0101010101010101) >> 56);
+#endif
+		}
+
+		inline void uniteScalar(std::uint64_t* target, const std::uint64_t* source, std::size_t num_words)
+		{
+			for (std::size_t i = 0; i < num_words; ++i)
+			{
+				target[i] |= source[i];
+			}
+		}
+
+		inline void subtractScalar(std::uint64_t* target, const std::uint64_t* mask, std::size_t num_words)
+		{
+			for (std::size_t i = 0; i < num_words; ++i)
+			{
+				target[i] &= ~mask[i];
+			}
+		}
+
+		inline std::size_t countScalar(const std::uint64_t* words, std::size_t num_words)
+		{
+			std::size_t total = 0;
+
+			for (std::size_t i = 0; i < num_words; ++i)
+			{
+				total += popCount(words[i]);
+			}
+			return total;
+		}
+
+		inline std::size_t mergeScalar(std::uint64_t* level, std::uint64_t* visited, std::size_t num_words)
+		{
+			std::size_t total = 0;
+
+			for (std::size_t i = 0; i < num_words; ++i)
+			{
+				std::uint64_t new_bits = level[i] & ~visited[i];
+				level[i] = new_bits;
+				visited[i] |= new_bits;
+				total += popCount(new_bits);
+			}
+			return total;
+		}
+
+#if defined(GRAPHSEARCH_BITMAP_X86)
+		/*
+		The SSE loops handle two words at a time with SSE2, which every x86-64 processor has, and count bits with the
+		POPCNT instruction, which the processor must also have for them to be chosen.
+		*/
+		__attribute__((target("popcnt"))) inline unsigned popCountSse(std::uint64_t word)
+		{
+			return (unsigned)_mm_popcnt_u64(word);
+		}
+
+		inline void uniteSse(std::uint64_t* target, const std::uint64_t* source, std::size_t num_words)
+		{
+			std::size_t i = 0;
+
+			for (; i + 2 <= num_words; i += 2)
+			{
+				__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(target + i));
+				__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), _mm_or_si128(a, b));
+			}
+			uniteScalar(target + i, source + i, num_words - i);
+		}
+
+		inline void subtractSse(std::uint64_t* target, const std::uint64_t* mask, std::size_t num_words)
+		{
+			std::size_t i = 0;
+
+			for (; i + 2 <= num_words; i += 2)
+			{
+				__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(target + i));
+				__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), _mm_andnot_si128(b, a));
+			}
+			subtractScalar(target + i, mask + i, num_words - i);
+		}
+
+		__attribute__((target("popcnt"))) inline std::size_t countSse(const std::uint64_t* words, std::size_t num_words)
+		{
+			std::size_t total = 0;
+
+			for (std::size_t i = 0; i < num_words; ++i)
+			{
+				total += popCountSse(words[i]);
+			}
+			return total;
+		}
+
+		__attribute__((target("popcnt"))) inline std::size_t mergeSse(std::uint64_t* level, std::uint64_t* visited,
+			std::size_t num_words)
+		{
+			std::size_t total = 0;
+			std::size_t i = 0;
+
+			for (; i + 2 <= num_words; i += 2)
+			{
+				__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(level + i));
+				__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(visited + i));
+				__m128i new_bits = _mm_andnot_si128(b, a);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(level + i), new_bits);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(visited + i), _mm_or_si128(b, new_bits));
+				total += popCountSse(level[i]) + popCountSse(level[i + 1]);
+			}
+			return total + mergeScalar(level + i, visited + i, num_words - i);
+		}
+
+		/*
+		Count the bits of 32 bytes with the method of Mula, Kurz, and Lemire:  look up the count of each half byte in a
+		table with a shuffle, and sum the bytes' counts into four 64-bit lanes.
+		*/
+		__attribute__((target("avx2"))) inline __m256i popCountAvx2(__m256i bytes)
+		{
+			const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+			const __m256i low_half = _mm256_set1_epi8(0x0f);
+			__m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(bytes, low_half));
+			__m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), low_half));
+
+			return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+		}
+
+		__attribute__((target("avx2"))) inline std::size_t sumLanes(__m256i lanes)
+		{
+			return (std::size_t)(_mm256_extract_epi64(lanes, 0) + _mm256_extract_epi64(lanes, 1)
+				+ _mm256_extract_epi64(lanes, 2) + _mm256_extract_epi64(lanes, 3));
+		}
+
+		__attribute__((target("avx2"))) inline void uniteAvx2(std::uint64_t* target, const std::uint64_t* source,
+			std::size_t num_words)
+		{
+			std::size_t i = 0;
+
+			for (; i + 4 <= num_words; i += 4)
+			{
+				__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(target + i));
+				__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i), _mm256_or_si256(a, b));
+			}
+			uniteScalar(target + i, source + i, num_words - i);
+		}
+
+		__attribute__((target("avx2"))) inline void subtractAvx2(std::uint64_t* target, const std::uint64_t* mask,
+			std::size_t num_words)
+		{
+			std::size_t i = 0;
+
+			for (; i + 4 <= num_words; i += 4)
+			{
+				__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(target + i));
+				__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i), _mm256_andnot_si256(b, a));
+			}
+			subtractScalar(target + i, mask + i, num_words - i);
+		}
+
+		__attribute__((target("avx2"))) inline std::size_t countAvx2(const std::uint64_t* words, std::size_t num_words)
+		{
+			__m256i totals = _mm256_setzero_si256();
+			std::size_t i = 0;
+
+			for (; i + 4 <= num_words; i += 4)
+			{
+				__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+				totals = _mm256_add_epi64(totals, popCountAvx2(a));
+			}
+			return sumLanes(totals) + countScalar(words + i, num_words - i);
+		}
+
+		__attribute__((target("avx2"))) inline std::size_t mergeAvx2(std::uint64_t* level, std::uint64_t* visited,
+			std::size_t num_words)
+		{
+			__m256i totals = _mm256_setzero_si256();
+			std::size_t i = 0;
+
+			for (; i + 4 <= num_words; i += 4)
+			{
+				__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(level + i));
+				__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(visited + i));
+				__m256i new_bits = _mm256_andnot_si256(b, a);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(level + i), new_bits);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(visited + i), _mm256_or_si256(b, new_bits));
+				totals = _mm256_add_epi64(totals, popCountAvx2(new_bits));
+			}
+			return sumLanes(totals) + mergeScalar(level + i, visited + i, num_words - i);
+		}
+#endif
+
+		inline const Kernels& kernelsFor(BitmapInstructions instructions)
+		{
+			static const Kernels scalar{uniteScalar, subtractScalar, countScalar, mergeScalar};
+#if defined(GRAPHSEARCH_BITMAP_X86)
+			static const Kernels sse{uniteSse, subtractSse, countSse, mergeSse};
+			static const Kernels avx2{uniteAvx2, subtractAvx2, countAvx2, mergeAvx2};
+
+			if (instructions == BitmapInstructions::avx2)
+			{
+				return avx2;
+			}
+			if (instructions == BitmapInstructions::sse)
+			{
+				return sse;
+			}
+#endif
+			return scalar;
+		}
+
+		inline BitmapInstructions detectInstructions()
+		{
+#if defined(GRAPHSEARCH_BITMAP_X86)
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2"))
+			{
+				return BitmapInstructions::avx2;
+			}
+			if (__builtin_cpu_supports("popcnt"))
+			{
+				return BitmapInstructions::sse;
+			}
+#endif
+			return BitmapInstructions::scalar;
+		}
+
+		/* The instructions the bitmaps use now.  They are chosen once, when a program first uses a bitmap. */
+		inline BitmapInstructions& currentInstructions()
+		{
+			static BitmapInstructions instructions = detectInstructions();
+			return instructions;
+		}
+	}
+
+	/* Return the most capable instructions for bitmaps that the processor supports. */
+	inline BitmapInstructions supportedBitmapInstructions()
+	{
+		static const BitmapInstructions supported = bitmap_detail::detectInstructions();
+		return supported;
+	}
+
+	inline BitmapInstructions bitmapInstructions()
+	{
+		return bitmap_detail::currentInstructions();
+	}
+
+	/*
+	Have bitmaps use the given instructions, or the most capable the processor supports if it doesn't support them,
+	and return the instructions chosen.  This isn't thread-safe:  call it while no bitmap is in use.
+	*/
+	inline BitmapInstructions setBitmapInstructions(BitmapInstructions instructions)
+	{
+		if (instructions > supportedBitmapInstructions())
+		{
+			instructions = supportedBitmapInstructions();
+		}
+		bitmap_detail::currentInstructions() = instructions;
+		return instructions;
+	}
+
+	/*
+	A set of the integers from 0 up to a size, with a bit for each.  Setting and testing a bit are inline; the
+	operations on whole bitmaps use the instructions chosen above.
+	*/
+	class Bitmap
+	{
+		std::vector<std::uint64_t> words;
+		std::size_t num_bits;
+
+		static const bitmap_detail::Kernels& kernels()
+		{
+			return bitmap_detail::kernelsFor(bitmapInstructions());
+		}
+
+	public:
+		/* Create a bitmap of the integers from 0 to size - 1, with every bit clear. */
+		explicit Bitmap(std::size_t size = 0) : words((size + 63) / 64, 0), num_bits{size}
+		{
+		}
+
+		std::size_t size() const
+		{
+			return num_bits;
+		}
+
+		bool test(std::size_t index) const
+		{
+			return (words[index >> 6] >> (index & 63) & 1) != 0;
+		}
+
+		void set(std::size_t index)
+		{
+			words[index >> 6] |= std::uint64_t{1} << (index & 63);
+		}
+
+		/* Set a bit, and return whether it was clear. */
+		bool testAndSet(std::size_t index)
+		{
+			std::uint64_t mask = std::uint64_t{1} << (index & 63);
+			bool was_clear = (words[index >> 6] & mask) == 0;
+
+			words[index >> 6] |= mask;
+			return was_clear;
+		}
+
+		/* Clear every bit. */
+		void clear()
+		{
+			std::fill(words.begin(), words.end(), 0);
+		}
+
+		/* Return the number of bits set. */
+		std::size_t count() const
+		{
+			return kernels().count(words.data(), words.size());
+		}
+
+		/* Set the bits that are set in another bitmap of the same size. */
+		void unite(const Bitmap& other)
+		{
+			kernels().unite(words.data(), other.words.data(), words.size());
+		}
+
+		/* Clear the bits that are set in another bitmap of the same size. */
+		void subtract(const Bitmap& mask)
+		{
+			kernels().subtract(words.data(), mask.words.data(), words.size());
+		}
+
+		/*
+		Clear the bits that are set in "visited," set the bits left in "visited," and return their number, in one pass.
+		A breadth-first search calls this with the next level when it is done.
+		*/
+		std::size_t mergeInto(Bitmap& visited)
+		{
+			return kernels().merge(words.data(), visited.words.data(), words.size());
+		}
+
+		/* Call "function" with the index of each bit set, in increasing order.  Words with no bits set are skipped. */
+		template <typename Function>
+		void forEach(Function function) const
+		{
+			for (std::size_t w = 0; w < words.size(); ++w)
+			{
+				for (std::uint64_t bits = words[w]; bits != 0; bits &= bits - 1)
+				{
+#if defined(__GNUC__)
+					function(w * 64 + (std::size_t)__builtin_ctzll(bits));
+#else
+					std::size_t index = 0;
+					while ((bits >> index & 1) == 0)
+					{
+						++index;
+					}
+					function(w * 64 + index);
+#endif
+				}
+			}
+		}
+
+		void swap(Bitmap& other)
+		{
+			words.swap(other.words);
+			std::swap(num_bits, other.num_bits);
+		}
+	};
+} // End of the graphsearch namespace.
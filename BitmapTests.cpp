@@ -0,0 +1,106 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code tests Bitmap.h.
+*/
+
+#include <cstddef>         // std::size_t
+#include <random>
+#include <vector>
+#include "cute.h"
+#include "Bitmap.h"
+#include "BitmapTests.h"
+
+void BitmapTest()
+{
+	graphsearch::Bitmap visited{200}, level{200};
+	std::vector<std::size_t> indexes;
+
+	ASSERTM("A new bitmap should be clear.", visited.size() == 200 && visited.count() == 0 && !visited.test(0));
+	visited.set(0);
+	visited.set(64);
+	ASSERTM("Incorrect bits.", visited.test(0) && visited.test(64) && !visited.test(63) && visited.count() == 2);
+	ASSERTM("A clear bit should be reported clear.", visited.testAndSet(199));
+	ASSERTM("A set bit should be reported set.", !visited.testAndSet(199) && visited.count() == 3);
+
+	// Merging a level into the visited states removes the states already visited.
+	level.set(0);
+	level.set(1);
+	level.set(130);
+	ASSERTM("Incorrect number of new states.", level.mergeInto(visited) == 2);
+	ASSERTM("A visited state should be removed.", !level.test(0) && level.test(1) && level.test(130));
+	ASSERTM("The new states should be visited.", visited.test(1) && visited.test(130) && visited.count() == 5);
+
+	level.forEach([&indexes](std::size_t index) { indexes.push_back(index); });
+	ASSERTM("Incorrect indexes.", (indexes == std::vector<std::size_t>({ 1, 130 })));
+
+	visited.subtract(level);
+	ASSERTM("Incorrect bits after subtracting.", visited.count() == 3 && !visited.test(1) && visited.test(64));
+	visited.unite(level);
+	ASSERTM("Incorrect bits after uniting.", visited.count() == 5 && visited.test(1));
+	visited.clear();
+	ASSERTM("A cleared bitmap should be clear.", visited.count() == 0 && !visited.test(64));
+}
+
+void BitmapInstructionsTest()
+{
+	const graphsearch::BitmapInstructions all_instructions[] = {
+		graphsearch::BitmapInstructions::scalar, graphsearch::BitmapInstructions::sse,
+		graphsearch::BitmapInstructions::avx2 };
+	graphsearch::BitmapInstructions original = graphsearch::bitmapInstructions();
+
+	// Sizes that leave a partial word, and words left over from the SIMD loops
+	for (std::size_t size : { 1, 63, 64, 65, 200, 1000, 4093 })
+	{
+		std::mt19937 random{(unsigned)size};
+		std::bernoulli_distribution coin{0.3};
+		std::vector<bool> in_a(size), in_b(size);
+		std::size_t a_count = 0, new_count = 0, union_count = 0;
+
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			in_a[i] = coin(random);
+			in_b[i] = coin(random);
+			a_count += in_a[i];
+			new_count += in_a[i] && !in_b[i];
+			union_count += in_a[i] || in_b[i];
+		}
+
+		// Every set of instructions the processor supports should give the same results as the plain loops.
+		for (graphsearch::BitmapInstructions instructions : all_instructions)
+		{
+			graphsearch::Bitmap a{size}, b{size}, c{size};
+
+			graphsearch::setBitmapInstructions(instructions);
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				if (in_a[i])
+				{
+					a.set(i);
+				}
+				if (in_b[i])
+				{
+					b.set(i);
+				}
+			}
+			ASSERTM("Incorrect count.", a.count() == a_count);
+			c.unite(a);
+			c.unite(b);
+			ASSERTM("Incorrect union.", c.count() == union_count);
+			c.subtract(b);
+			ASSERTM("Incorrect difference.", c.count() == new_count);
+			ASSERTM("Incorrect number of new states.", a.mergeInto(b) == new_count);
+			ASSERTM("Incorrect merge.", a.count() == new_count && b.count() == union_count);
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				ASSERTM("Incorrect bit after merging.", a.test(i) == (in_a[i] && !in_b[i]) && c.test(i) == a.test(i));
+			}
+		}
+	}
+
+	ASSERTM("Unsupported instructions should not be chosen.",
+			graphsearch::setBitmapInstructions(graphsearch::BitmapInstructions::avx2)
+			== graphsearch::supportedBitmapInstructions());
+	graphsearch::setBitmapInstructions(original);
+}
@@ -0,0 +1,133 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code replaces the global allocation functions to count allocations, for the unit tests and the benchmark.  The tests
+use the count to verify that a search doesn't allocate, and the benchmark to compare the allocations of searches.
+
+Define COUNTING_ALLOCATOR_BYTES before including this file to also track the number of bytes allocated and not yet
+freed, and the peak of that number.  The bytes are the usable size the C library reports for each block, so nothing
+is stored alongside the memory returned.
+
+The replacements are definitions rather than declarations, so include this file in only one source file of a program.
+The counts are atomic because parallel searches allocate from several threads.
+
+Every form of new and delete is replaced so that each pair matches.  The delete that frees the memory isn't inlined,
+so that GCC doesn't see "free" called on memory from "new" and warn about a mismatch.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>       // std::size_t
+#include <cstdlib>       // std::malloc, std::free
+#include <new>           // std::bad_alloc, std::nothrow_t
+
+#ifdef COUNTING_ALLOCATOR_BYTES
+#if defined(__APPLE__)
+#include <malloc/malloc.h>  // malloc_size
+#else
+#include <malloc.h>         // malloc_usable_size, or _msize on Windows
+#endif
+#endif
+
+#if defined(__GNUC__)
+#define COUNTING_ALLOCATOR_NOINLINE __attribute__((noinline))
+#else
+#define COUNTING_ALLOCATOR_NOINLINE
+#endif
+
+static std::atomic<std::size_t> allocation_count{0};
+
+#ifdef COUNTING_ALLOCATOR_BYTES
+static std::atomic<std::size_t> bytes_in_use{0};
+static std::atomic<std::size_t> peak_bytes_in_use{0};
+
+static std::size_t usableSize(void* memory)
+{
+#if defined(__APPLE__)
+	return malloc_size(memory);
+#elif defined(_WIN32)
+	return _msize(memory);
+#else
+	return malloc_usable_size(memory);
+#endif
+}
+#endif
+
+void* operator new(std::size_t size)
+{
+	void* memory = std::malloc(size == 0 ? 1 : size);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	++allocation_count;
+#ifdef COUNTING_ALLOCATOR_BYTES
+	std::size_t now_in_use = bytes_in_use += usableSize(memory);
+	std::size_t peak = peak_bytes_in_use.load();
+	while (now_in_use > peak && !peak_bytes_in_use.compare_exchange_weak(peak, now_in_use))
+	{
+	}
+#endif
+	return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return operator new(size);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return operator new(size, std::nothrow);
+}
+
+COUNTING_ALLOCATOR_NOINLINE void operator delete(void* memory) noexcept
+{
+#ifdef COUNTING_ALLOCATOR_BYTES
+	if (memory != nullptr)
+	{
+		bytes_in_use -= usableSize(memory);
+	}
+#endif
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	operator delete(memory);
+}
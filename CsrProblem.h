@@ -0,0 +1,461 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code implements a problem for explicit graphs, for use with GraphSearch.h.  Many problems are static graphs
+whose states are vertex numbers, and implementing "actions" and "result" for them with a switch, or a map, costs a
+virtual call per successor and a hash lookup per state.  CsrGraph stores such a graph in compressed sparse row form:
+the edges from each vertex are consecutive in one array, so expanding a vertex reads its successors with contiguous
+loads.  CsrProblem searches a CsrGraph with every search of Problem, and keeps the states it has seen in a
+DenseStateTable, which finds a vertex's index with one array load.
+
+The action of an edge is its index in the graph's edge arrays, as a CsrEdge, so "solution" returns the edges of the
+path.  For example:
+
+	graphsearch::CsrGraph graph = graphsearch::CsrGraph::readEdgeList(file);
+	graphsearch::CsrProblem<> problem{graph};
+	problem.searchUniformCost(0, std::unordered_set<std::uint32_t>({ 42 }));
+*/
+
+#pragma once
+
+#include <algorithm>     // std::max, std::min, std::upper_bound
+#include <cstdint>       // std::uint32_t
+#include <functional>    // std::hash
+#include <istream>
+#include <sstream>
+#include <stdexcept>     // std::out_of_range
+#include <string>
+#include <vector>
+#include "Bitmap.h"
+#include "GraphSearch.h"
+#include "StateTable.h"
+
+namespace graphsearch
+{
+	/* The action of taking an edge of a CsrGraph:  the edge's index. */
+	enum class CsrEdge : std::uint32_t { start_state = UINT32_MAX };
+
+	/*
+	A directed graph with vertices 0 to vertices() - 1.  The edges from vertex v are the edges with indexes from
+	edgesBegin(v) up to edgesEnd(v), in the order they were given.  An edge has a weight, which is 1 unless the graph was
+	built with weights.  Add an edge in each direction for an undirected graph.
+
+	"addReverseEdges" adds the edges into each vertex, in the same form, for searches that go backward.
+	*/
+	class CsrGraph
+	{
+		std::vector<std::uint32_t> offsets;  // The edges from vertex v are offsets[v] up to offsets[v + 1]
+		std::vector<std::uint32_t> targets;
+		std::vector<double> weights;         // Empty if every weight is 1
+
+		// The edges into vertex v are reverse_offsets[v] up to reverse_offsets[v + 1], if they have been added.  Each
+		// holds the vertex the edge comes from and the edge's index.
+		std::vector<std::uint32_t> reverse_offsets;
+		std::vector<std::uint32_t> reverse_sources;
+		std::vector<std::uint32_t> reverse_edges;
+
+	public:
+		/*
+		Build a graph from an edge list:  edge i goes from sources[i] to targets[i] with weight weights[i], or 1 if
+		"weights" is empty.  The edges are sorted by source with a counting sort, in time proportional to the number
+		of vertices and edges.
+		*/
+		CsrGraph(std::uint32_t num_vertices, const std::vector<std::uint32_t>& sources,
+			const std::vector<std::uint32_t>& the_targets, const std::vector<double>& the_weights = std::vector<double>())
+			: offsets(std::size_t{num_vertices} + 1, 0), targets(the_targets.size()), weights(the_weights.size())
+		{
+			if (sources.size() != the_targets.size() || (!the_weights.empty() && the_weights.size() != sources.size()))
+			{
+				throw "An edge list needs a target, and a weight if any edge has one, for every source.";
+			}
+			if (sources.size() >= UINT32_MAX)
+			{
+				throw "A CsrGraph holds fewer than 2^32 - 1 edges.";
+			}
+
+			// Count the edges from each vertex, then place each edge after those from lower vertices.
+			for (std::size_t i = 0; i < sources.size(); ++i)
+			{
+				if (sources[i] >= num_vertices || the_targets[i] >= num_vertices)
+				{
+					throw "An edge list refers to a vertex outside the graph.";
+				}
+				++offsets[sources[i] + 1];
+			}
+			for (std::uint32_t v = 0; v < num_vertices; ++v)
+			{
+				offsets[v + 1] += offsets[v];
+			}
+			std::vector<std::uint32_t> next(offsets.begin(), offsets.end() - 1);
+			for (std::size_t i = 0; i < sources.size(); ++i)
+			{
+				std::uint32_t e = next[sources[i]]++;
+				targets[e] = the_targets[i];
+				if (!weights.empty())
+				{
+					weights[e] = the_weights[i];
+				}
+			}
+		}
+
+		/*
+		Read an edge list, one edge per line:  a source vertex, a target vertex, and optionally a weight, separated by
+		spaces.  Blank lines and lines starting with '#' are skipped.  The graph has one more vertex than the largest
+		vertex in the list.  If any edge has a weight, every edge must.
+		*/
+		static CsrGraph readEdgeList(std::istream& input)
+		{
+			std::vector<std::uint32_t> sources, the_targets;
+			std::vector<double> the_weights;
+			std::uint32_t num_vertices = 0;
+			std::string line;
+
+			while (std::getline(input, line))
+			{
+				std::istringstream fields{line};
+				std::uint32_t source, target;
+				double weight;
+
+				if (line.empty() || line[0] == '#')
+				{
+					continue;
+				}
+				if (!(fields >> source >> target))
+				{
+					throw "An edge list line needs a source and a target vertex.";
+				}
+				sources.push_back(source);
+				the_targets.push_back(target);
+				if (fields >> weight)
+				{
+					the_weights.push_back(weight);
+				}
+				num_vertices = std::max(num_vertices, std::max(source, target) + 1);
+			}
+			return CsrGraph{num_vertices, sources, the_targets, the_weights};
+		}
+
+		/* Add the edges into each vertex, unless they have already been added.  This takes 8 more bytes per edge. */
+		void addReverseEdges()
+		{
+			if (hasReverseEdges())
+			{
+				return;
+			}
+			reverse_offsets.assign(offsets.size(), 0);
+			reverse_sources.resize(targets.size());
+			reverse_edges.resize(targets.size());
+			for (std::uint32_t target : targets)
+			{
+				++reverse_offsets[target + 1];
+			}
+			for (std::uint32_t v = 0; v < vertices(); ++v)
+			{
+				reverse_offsets[v + 1] += reverse_offsets[v];
+			}
+			std::vector<std::uint32_t> next(reverse_offsets.begin(), reverse_offsets.end() - 1);
+			for (std::uint32_t v = 0; v < vertices(); ++v)
+			{
+				for (std::uint32_t e = offsets[v]; e < offsets[v + 1]; ++e)
+				{
+					std::uint32_t position = next[targets[e]]++;
+					reverse_sources[position] = v;
+					reverse_edges[position] = e;
+				}
+			}
+		}
+
+		bool hasReverseEdges() const
+		{
+			return !reverse_offsets.empty();
+		}
+
+		std::uint32_t vertices() const
+		{
+			return (std::uint32_t)offsets.size() - 1;
+		}
+
+		std::uint32_t edges() const
+		{
+			return (std::uint32_t)targets.size();
+		}
+
+		std::uint32_t edgesBegin(std::uint32_t vertex) const
+		{
+			return offsets[vertex];
+		}
+
+		std::uint32_t edgesEnd(std::uint32_t vertex) const
+		{
+			return offsets[vertex + 1];
+		}
+
+		std::uint32_t target(std::uint32_t edge) const
+		{
+			return targets[edge];
+		}
+
+		double weight(std::uint32_t edge) const
+		{
+			return weights.empty() ? 1.0 : weights[edge];
+		}
+
+		/* Return the vertex an edge comes from, by a binary search of the offsets. */
+		std::uint32_t source(std::uint32_t edge) const
+		{
+			return (std::uint32_t)(std::upper_bound(offsets.begin(), offsets.end(), edge) - offsets.begin()) - 1;
+		}
+
+		std::uint32_t degree(std::uint32_t vertex) const
+		{
+			return offsets[vertex + 1] - offsets[vertex];
+		}
+
+		std::uint32_t reverseBegin(std::uint32_t vertex) const
+		{
+			return reverse_offsets[vertex];
+		}
+
+		std::uint32_t reverseEnd(std::uint32_t vertex) const
+		{
+			return reverse_offsets[vertex + 1];
+		}
+
+		/* Return the vertex that the i'th edge into a vertex, by its position in the reverse edges, comes from. */
+		std::uint32_t reverseSource(std::uint32_t position) const
+		{
+			return reverse_sources[position];
+		}
+
+		/* Return the index of the i'th edge into a vertex, by its position in the reverse edges. */
+		std::uint32_t reverseEdge(std::uint32_t position) const
+		{
+			return reverse_edges[position];
+		}
+	};
+
+	/*
+	A problem that searches a CsrGraph, which must outlive it.  Its step costs are the edge weights, and its heuristic
+	is 0; subclass it and override "heuristic" for A*.  If the graph has reverse edges, it implements "predecessors" for
+	the bidirectional search, and it can search with searchBreadthFirstDirectionOptimizing.  See Problem for StatsType
+	and AllocatorType.
+	*/
+	template <typename StatsType = NoSearchStats, typename AllocatorType = std::allocator<std::uint32_t>>
+	class CsrProblem : public Problem<std::uint32_t, CsrEdge, std::hash<std::uint32_t>,
+		DenseStateTable<std::uint32_t, AllocatorType>, StatsType, AllocatorType>
+	{
+		typedef Problem<std::uint32_t, CsrEdge, std::hash<std::uint32_t>, DenseStateTable<std::uint32_t, AllocatorType>,
+			StatsType, AllocatorType> ProblemType;
+
+		const CsrGraph& graph;
+
+	protected:
+		void successors(const std::uint32_t& state, typename ProblemType::SuccessorSink& sink) override
+		{
+			std::uint32_t end = graph.edgesEnd(state);
+
+			for (std::uint32_t e = graph.edgesBegin(state); e < end; ++e)
+			{
+				sink.add((CsrEdge)e, graph.target(e));
+			}
+		}
+
+		void predecessors(const std::uint32_t& state, typename ProblemType::SuccessorSink& sink) override
+		{
+			if (!graph.hasReverseEdges())
+			{
+				ProblemType::predecessors(state, sink);  // Throws
+			}
+			for (std::uint32_t i = graph.reverseBegin(state); i < graph.reverseEnd(state); ++i)
+			{
+				sink.add((CsrEdge)graph.reverseEdge(i), graph.reverseSource(i));
+			}
+		}
+
+		double stepCost(const std::uint32_t& /* state */, CsrEdge action,
+			const std::uint32_t& /* next_state */) const override
+		{
+			return graph.weight((std::uint32_t)action);
+		}
+
+	public:
+		// The defaults for searchBreadthFirstDirectionOptimizing, from Beamer, Asanovic, and Patterson
+		static constexpr double default_top_down_factor = 14.0;
+		static constexpr double default_bottom_up_factor = 24.0;
+
+		explicit CsrProblem(const CsrGraph& the_graph, const AllocatorType& allocator = AllocatorType())
+			: ProblemType(allocator), graph(the_graph)
+		{
+		}
+
+		/*
+		Perform a direction-optimizing breadth-first search, which needs the graph's reverse edges.  Like
+		searchBreadthFirst, it finds a solution with the fewest actions, and it goes one level at a time, but it
+		finds each level in whichever of two ways is cheaper:
+
+		Top-down, it looks at the edges from each vertex of the current level, as searchBreadthFirst does.  On a graph
+		with a small diameter and a high degree, most of those edges in the middle levels lead to vertices already
+		reached.  Bottom-up, it looks instead at the edges into each vertex not yet reached, and stops at the first that
+		comes from the current level, which it keeps in a bitmap.  That is cheaper when the current level is large.
+
+		The search switches to bottom-up when the edges from the current level outnumber the edges into the vertices
+		not yet reached divided by top_down_factor, and back to top-down when the level has fewer than the number of
+		vertices divided by bottom_up_factor and is shrinking.  A top_down_factor of 0 keeps the search top-down.
+
+		The search marks the vertices it reaches in a bitmap and records each one's parent in an array, so its memory
+		is proportional to the number of vertices.  It checks for goals as it reaches vertices rather than when it
+		expands them.  For statistics, the nodes expanded are the vertices of each level.
+		*/
+		bool searchBreadthFirstDirectionOptimizing(std::uint32_t initial_state,
+			const std::unordered_set<std::uint32_t>& goal_states, double top_down_factor = default_top_down_factor,
+			double bottom_up_factor = default_bottom_up_factor)
+		{
+			if (!graph.hasReverseEdges())
+			{
+				throw "A direction-optimizing search needs the graph's reverse edges.";
+			}
+			if (initial_state >= graph.vertices())
+			{
+				throw std::out_of_range("A direction-optimizing search needs an initial state in the graph.");
+			}
+
+			const std::uint32_t no_parent = UINT32_MAX;
+			std::uint32_t num_vertices = graph.vertices();
+			std::vector<std::uint32_t> parent_edges(num_vertices, no_parent);  // The edge each vertex was reached by
+			Bitmap visited{num_vertices};
+			Bitmap level_bits, next_bits;  // The current and next levels, bottom-up
+			std::vector<std::uint32_t> level{initial_state}, next_level;  // The current and next levels, top-down
+			std::uint64_t unexplored_edges = graph.edges() - graph.degree(initial_state);  // Into vertices not yet reached, for an undirected graph
+			std::uint64_t level_edges = graph.degree(initial_state);  // From the vertices of the current level
+			std::size_t level_size = 1;
+			bool bottom_up = false;
+			std::uint32_t goal = no_parent;
+
+			ProblemType::clearSearch();
+			typename ProblemType::SearchTimer timer{*this};
+			visited.set(initial_state);
+			if (goal_states.count(initial_state) == 1)
+			{
+				goal = initial_state;
+			}
+
+			std::uint32_t depth = 0;
+			for (; goal == no_parent && level_size > 0; ++depth)
+			{
+				// Choose the direction for the next level.
+				std::size_t previous_size = level_size;
+				if (!bottom_up && top_down_factor > 0.0 && level_edges > unexplored_edges / top_down_factor)
+				{
+					bottom_up = true;
+					level_bits = Bitmap{num_vertices};
+					next_bits = Bitmap{num_vertices};
+					for (std::uint32_t v : level)
+					{
+						level_bits.set(v);
+					}
+				}
+				this->search_stats.frontierSize(level_size);
+				for (std::size_t i = 0; i < level_size; ++i)
+				{
+					ProblemType::countExpansion(depth);
+				}
+
+				level_size = 0;
+				level_edges = 0;
+				if (bottom_up)
+				{
+					// Find a parent in the current level for each vertex not yet reached, until a goal is reached.
+					next_bits.clear();
+					for (std::uint32_t v = 0; v < num_vertices && goal == no_parent; ++v)
+					{
+						if (visited.test(v))
+						{
+							continue;
+						}
+						for (std::uint32_t i = graph.reverseBegin(v); i < graph.reverseEnd(v); ++i)
+						{
+							if (level_bits.test(graph.reverseSource(i)))
+							{
+								parent_edges[v] = graph.reverseEdge(i);
+								next_bits.set(v);
+								level_edges += graph.degree(v);
+								if (goal_states.count(v) == 1)
+								{
+									goal = v;
+								}
+								break;
+							}
+						}
+					}
+					level_size = next_bits.mergeInto(visited);
+					level_bits.swap(next_bits);
+					if (level_size < num_vertices / bottom_up_factor && level_size < previous_size)
+					{
+						// Go back to top-down for the next level.
+						bottom_up = false;
+						level.clear();
+						level_bits.forEach([&level](std::size_t v) { level.push_back((std::uint32_t)v); });
+					}
+				}
+				else
+				{
+					// Reach the vertices not yet reached from the edges of each vertex of the current level, until a goal
+					// is reached.
+					next_level.clear();
+					for (std::uint32_t u : level)
+					{
+						std::uint32_t end = graph.edgesEnd(u);
+						for (std::uint32_t e = graph.edgesBegin(u); e < end && goal == no_parent; ++e)
+						{
+							std::uint32_t v = graph.target(e);
+							if (visited.testAndSet(v))
+							{
+								parent_edges[v] = e;
+								next_level.push_back(v);
+								level_edges += graph.degree(v);
+								if (goal_states.count(v) == 1)
+								{
+									goal = v;
+								}
+							}
+						}
+						if (goal != no_parent)
+						{
+							break;
+						}
+					}
+					level.swap(next_level);
+					level_size = level.size();
+				}
+				unexplored_edges -= std::min(unexplored_edges, level_edges);
+			}
+
+			if (goal == no_parent)
+			{
+				return false;
+			}
+			if (!ProblemType::recordsPath())
+			{
+				ProblemType::recordGoal(0, depth);
+				return true;
+			}
+
+			// Walk the parent edges back from the goal, and add the path to the node vectors.
+			std::vector<std::uint32_t> path_edges;
+			for (std::uint32_t v = goal; v != initial_state; )
+			{
+				path_edges.push_back(parent_edges[v]);
+				v = graph.source(parent_edges[v]);
+			}
+			ProblemType::addNode(this->states.intern(initial_state), 0, CsrEdge::start_state);
+			for (std::size_t i = path_edges.size(); i-- > 0; )
+			{
+				ProblemType::addNode(this->states.intern(graph.target(path_edges[i])), (std::uint32_t)this->node_states.size() - 1,
+					(CsrEdge)path_edges[i]);
+			}
+			ProblemType::recordGoal((std::uint32_t)this->node_states.size() - 1, depth);
+			return true;
+		}
+	};
+} // End of the graphsearch namespace.
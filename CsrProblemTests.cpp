@@ -0,0 +1,190 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code tests CsrProblem.h.
+*/
+
+#include <cstdint>         // std::uint32_t
+#include <random>
+#include <sstream>
+#include <stdexcept>       // std::out_of_range
+#include <unordered_set>
+#include <vector>
+#include "cute.h"
+#include "CsrProblem.h"
+#include "CsrProblemTests.h"
+
+/*
+Return the weighted graph of WeightedProblem in GraphSearchTests.h, with the edges in both directions:  1-2, 2-3, and
+3-4 cost 1, and 1-4 costs 10.
+*/
+static graphsearch::CsrGraph weightedGraph()
+{
+	std::istringstream input{"# source target weight\n1 2 1\n2 1 1\n2 3 1\n3 2 1\n\n3 4 1\n4 3 1\n1 4 10\n4 1 10\n"};
+	return graphsearch::CsrGraph::readEdgeList(input);
+}
+
+void CsrGraphTest()
+{
+	// The edges are given out of order, and vertex 1 has none.
+	graphsearch::CsrGraph graph{4, std::vector<std::uint32_t>({ 2, 0, 2, 0 }), std::vector<std::uint32_t>({ 3, 1, 0, 2 })};
+
+	ASSERTM("Incorrect size.", graph.vertices() == 4 && graph.edges() == 4);
+	ASSERTM("Incorrect edges from 0.", graph.edgesEnd(0) - graph.edgesBegin(0) == 2
+			&& graph.target(graph.edgesBegin(0)) == 1 && graph.target(graph.edgesBegin(0) + 1) == 2);
+	ASSERTM("Vertex 1 should have no edges.", graph.edgesBegin(1) == graph.edgesEnd(1));
+	ASSERTM("Incorrect edges from 2.", graph.edgesEnd(2) - graph.edgesBegin(2) == 2
+			&& graph.target(graph.edgesBegin(2)) == 3 && graph.target(graph.edgesBegin(2) + 1) == 0);
+	ASSERTM("Vertex 3 should have no edges.", graph.edgesBegin(3) == graph.edgesEnd(3) && graph.edgesEnd(3) == 4);
+	ASSERTM("An unweighted edge should weigh 1.", graph.weight(0) == 1.0);
+
+	ASSERT_THROWSM("An edge to a vertex outside the graph should raise an exception.",
+			graphsearch::CsrGraph(2, std::vector<std::uint32_t>({ 0 }), std::vector<std::uint32_t>({ 2 })), const char*);
+	ASSERT_THROWSM("Edge lists of different lengths should raise an exception.",
+			graphsearch::CsrGraph(2, std::vector<std::uint32_t>({ 0, 1 }), std::vector<std::uint32_t>({ 1 })), const char*);
+}
+
+void CsrEdgeListTest()
+{
+	graphsearch::CsrGraph graph = weightedGraph();
+
+	ASSERTM("Incorrect size.", graph.vertices() == 5 && graph.edges() == 8);
+	ASSERTM("Incorrect edges from 1.", graph.edgesEnd(1) - graph.edgesBegin(1) == 2
+			&& graph.target(graph.edgesBegin(1)) == 2 && graph.target(graph.edgesBegin(1) + 1) == 4);
+	ASSERTM("Incorrect weight.", graph.weight(graph.edgesBegin(1) + 1) == 10.0);
+
+	std::istringstream bad_input{"1\n"};
+	ASSERT_THROWSM("A line without a target should raise an exception.", graphsearch::CsrGraph::readEdgeList(bad_input),
+			const char*);
+}
+
+void CsrProblemSearchTest()
+{
+	graphsearch::CsrGraph graph = weightedGraph();
+	graphsearch::CsrProblem<> problem{graph};
+	std::unordered_set<std::uint32_t> goal_states({ 4 });
+	std::vector<std::uint32_t> the_path;
+	std::vector<graphsearch::CsrEdge> the_solution;
+
+	// Breadth-first search ignores the weights and takes the edge 1-4.
+	ASSERTM("No solution found.", problem.searchBreadthFirst(1, goal_states));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<std::uint32_t>({ 1, 4 })));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", the_solution.size() == 1 && graph.target((std::uint32_t)the_solution[0]) == 4);
+
+	// Uniform-cost search takes the cheap path through 2 and 3.
+	ASSERTM("No solution found.", problem.searchUniformCost(1, goal_states));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<std::uint32_t>({ 1, 2, 3, 4 })));
+	ASSERTM("Incorrect distance.", problem.distance() == 3.0);
+
+	ASSERTM("No solution found.", problem.searchDepthFirst(1, goal_states));
+	ASSERTM("No solution found.", problem.searchIDAStar(1, goal_states));
+	ASSERTM("Incorrect distance.", problem.distance() == 3.0);
+	ASSERTM("No solution found.", problem.searchBreadthFirstParallel(1, goal_states, 2));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<std::uint32_t>({ 1, 4 })));
+
+	// Vertex 0 has no edges, and an exhaustive search from 1 reaches the other four vertices.
+	ASSERTM("Vertex 0 should be unreachable.", !problem.searchBreadthFirst(1, std::unordered_set<std::uint32_t>({ 0 })));
+	ASSERTM("Searching from an isolated vertex should find nothing.", !problem.searchDepthFirst(0, goal_states));
+}
+
+void CsrReverseEdgesTest()
+{
+	graphsearch::CsrGraph graph{4, std::vector<std::uint32_t>({ 2, 0, 2, 0 }), std::vector<std::uint32_t>({ 3, 1, 0, 2 })};
+	graphsearch::CsrProblem<> problem{graph};
+
+	ASSERTM("The graph should have no reverse edges yet.", !graph.hasReverseEdges());
+	ASSERT_THROWSM("A bidirectional search without reverse edges should raise an exception.",
+			problem.searchBidirectional(0, std::unordered_set<std::uint32_t>({ 3 })), const char*);
+
+	graph.addReverseEdges();
+	ASSERTM("The graph should have reverse edges.", graph.hasReverseEdges());
+	ASSERTM("Vertex 0 should have one edge in, from 2.", graph.reverseEnd(0) - graph.reverseBegin(0) == 1
+			&& graph.reverseSource(graph.reverseBegin(0)) == 2);
+	ASSERTM("Vertex 2 should have one edge in, from 0.", graph.reverseEnd(2) - graph.reverseBegin(2) == 1
+			&& graph.reverseSource(graph.reverseBegin(2)) == 0);
+	for (std::uint32_t v = 0; v < graph.vertices(); ++v)
+	{
+		for (std::uint32_t i = graph.reverseBegin(v); i < graph.reverseEnd(v); ++i)
+		{
+			ASSERTM("A reverse edge should name its forward edge.", graph.target(graph.reverseEdge(i)) == v
+					&& graph.source(graph.reverseEdge(i)) == graph.reverseSource(i));
+		}
+	}
+
+	std::vector<std::uint32_t> the_path;
+	ASSERTM("No solution found.", problem.searchBidirectional(0, std::unordered_set<std::uint32_t>({ 3 })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<std::uint32_t>({ 0, 2, 3 })));
+}
+
+void DirectionOptimizingSearchTest()
+{
+	// A random graph whose middle levels are large enough for the search to go bottom-up
+	const std::uint32_t num_vertices = 2000;
+	std::mt19937 random{7};
+	std::uniform_int_distribution<std::uint32_t> vertex(0, num_vertices - 1);
+	std::vector<std::uint32_t> sources, targets;
+	for (std::uint32_t i = 0; i < 4 * num_vertices; ++i)
+	{
+		sources.push_back(vertex(random));
+		targets.push_back(vertex(random));
+	}
+	graphsearch::CsrGraph graph{num_vertices, sources, targets};
+	graphsearch::CsrProblem<> problem{graph};
+	std::vector<std::uint32_t> the_path;
+	std::vector<graphsearch::CsrEdge> the_solution;
+
+	ASSERT_THROWSM("A search without reverse edges should raise an exception.",
+			problem.searchBreadthFirstDirectionOptimizing(0, std::unordered_set<std::uint32_t>({ 1 })), const char*);
+	graph.addReverseEdges();
+	ASSERT_THROWSM("A search from a state outside the graph should raise an exception.",
+			problem.searchBreadthFirstDirectionOptimizing(num_vertices, std::unordered_set<std::uint32_t>({ 1 })),
+			std::out_of_range);
+
+	// Top-down only, the default switching, and bottom-up from the second level should agree with searchBreadthFirst.
+	const double factors[] = { 0.0, problem.default_top_down_factor, 1.0e9 };
+	for (std::uint32_t goal = 1; goal < num_vertices; goal += 97)
+	{
+		std::unordered_set<std::uint32_t> goal_states({ goal });
+		bool found = problem.searchBreadthFirst(0, goal_states);
+		double expected = found ? problem.distance() : 0.0;
+
+		for (double factor : factors)
+		{
+			ASSERTM("The searches should agree on whether there is a solution.",
+					problem.searchBreadthFirstDirectionOptimizing(0, goal_states, factor) == found);
+			if (!found)
+			{
+				continue;
+			}
+			ASSERTM("Incorrect distance.", problem.distance() == expected);
+			problem.path(the_path);
+			problem.solution(the_solution);
+			ASSERTM("Incorrect path length.", the_path.size() == expected + 1 && the_solution.size() == expected);
+			ASSERTM("The path should end at the goal.", the_path.front() == 0 && the_path.back() == goal);
+			for (std::size_t i = 0; i < the_solution.size(); ++i)
+			{
+				std::uint32_t edge = (std::uint32_t)the_solution[i];
+				ASSERTM("Each edge should join consecutive states.", graph.source(edge) == the_path[i]
+						&& graph.target(edge) == the_path[i + 1]);
+			}
+		}
+	}
+
+	// The initial state may be a goal, and the distance-only result keeps no path.
+	ASSERTM("No solution found.", problem.searchBreadthFirstDirectionOptimizing(5, std::unordered_set<std::uint32_t>({ 5 })));
+	ASSERTM("Incorrect distance.", problem.distance() == 0.0);
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<std::uint32_t>({ 5 })));
+	ASSERTM("No solution found.", problem.searchBreadthFirst(0, std::unordered_set<std::uint32_t>({ 1 })));
+	double expected = problem.distance();
+	problem.setResultKind(graphsearch::ResultKind::distance);
+	ASSERTM("No solution found.", problem.searchBreadthFirstDirectionOptimizing(0, std::unordered_set<std::uint32_t>({ 1 }),
+			1.0e9));
+	ASSERTM("Incorrect distance.", problem.distance() == expected);
+}
@@ -0,0 +1,15 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code tests CsrProblem.h.
+*/
+
+#pragma once
+
+// Test function prototypes:
+void CsrGraphTest();
+void CsrEdgeListTest();
+void CsrProblemSearchTest();
+void CsrReverseEdgesTest();
+void DirectionOptimizingSearchTest();
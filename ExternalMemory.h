@@ -0,0 +1,315 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code implements the files that Problem::searchBreadthFirstExternal in GraphSearch.h keeps on disk.  A search
+writes each file once, sequentially, through a buffer, and then reads it through a read-only memory mapping, so the
+operating system, not the search, decides how much of it is in memory.  The records in the files are trivially
+copyable structures, written and mapped as raw bytes, so the files are only meaningful to the process that wrote them.
+
+It uses POSIX files and memory mappings.  Where they are available, it defines GRAPHSEARCH_EXTERNAL_MEMORY, and
+GraphSearch.h defines the external-memory search.
+*/
+
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#define GRAPHSEARCH_EXTERNAL_MEMORY 1
+
+#include <algorithm>     // std::lower_bound, std::min
+#include <cerrno>
+#include <cstddef>       // std::size_t
+#include <cstring>       // std::memcmp
+#include <memory>        // std::unique_ptr
+#include <queue>
+#include <stdlib.h>      // mkdtemp
+#include <string>
+#include <vector>
+#include <fcntl.h>       // open
+#include <sys/mman.h>    // mmap, munmap
+#include <sys/stat.h>    // fstat
+#include <unistd.h>      // write, close, unlink, rmdir
+
+namespace graphsearch
+{
+	/*
+	Order trivially copyable values by their bytes.  Equal values must have equal bytes, so a structure with padding
+	must zero its padding.
+	*/
+	template <typename T>
+	bool bytesLess(const T& a, const T& b)
+	{
+		return std::memcmp(&a, &b, sizeof(T)) < 0;
+	}
+
+	template <typename T>
+	bool bytesEqual(const T& a, const T& b)
+	{
+		return std::memcmp(&a, &b, sizeof(T)) == 0;
+	}
+
+	/* A new directory, with a unique name, for the files of one search.  It removes itself and its files when destroyed. */
+	class TemporaryDirectory
+	{
+		std::string path;
+		std::size_t next_file{0};
+
+	public:
+		explicit TemporaryDirectory(const std::string& parent)
+		{
+			std::string pattern = parent + "/graphsearch-XXXXXX";
+			std::vector<char> name(pattern.begin(), pattern.end());
+
+			name.push_back('\0');
+			if (mkdtemp(name.data()) == nullptr)
+			{
+				throw "Could not create a directory for the files of an external-memory search.";
+			}
+			path = name.data();
+		}
+
+		TemporaryDirectory(const TemporaryDirectory&) = delete;
+		TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+		~TemporaryDirectory()
+		{
+			for (std::size_t i = 0; i < next_file; ++i)
+			{
+				::unlink(fileName(i).c_str());  // Files already removed fail harmlessly.
+			}
+			::rmdir(path.c_str());
+		}
+
+		std::string fileName(std::size_t number) const
+		{
+			return path + "/" + std::to_string(number);
+		}
+
+		/* Return the name of a new file in the directory.  The file is created when it is opened for writing. */
+		std::string newFile()
+		{
+			return fileName(next_file++);
+		}
+
+		/* Remove a file that is no longer needed, to free its disk space before the search ends. */
+		void remove(const std::string& file)
+		{
+			::unlink(file.c_str());
+		}
+	};
+
+	/* Write records to a new file, in order, through a buffer.  Call "close" to write the rest of the buffer. */
+	template <typename RecordType>
+	class RecordWriter
+	{
+		int descriptor;
+		std::vector<RecordType> buffer;
+		std::size_t count{0};
+
+		void writeBytes(const void* data, std::size_t size)
+		{
+			const char* bytes = static_cast<const char*>(data);
+
+			while (size > 0)
+			{
+				ssize_t written = ::write(descriptor, bytes, size);
+				if (written < 0 && errno != EINTR)
+				{
+					throw "Could not write a file of an external-memory search.";
+				}
+				if (written > 0)
+				{
+					bytes += written;
+					size -= (std::size_t)written;
+				}
+			}
+		}
+
+		void flush()
+		{
+			writeBytes(buffer.data(), buffer.size() * sizeof(RecordType));
+			buffer.clear();
+		}
+
+	public:
+		RecordWriter(const std::string& path, std::size_t buffer_bytes = 1 << 16)
+			: descriptor{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600)}
+		{
+			if (descriptor < 0)
+			{
+				throw "Could not create a file of an external-memory search.";
+			}
+			buffer.reserve(buffer_bytes / sizeof(RecordType) + 1);
+		}
+
+		RecordWriter(const RecordWriter&) = delete;
+		RecordWriter& operator=(const RecordWriter&) = delete;
+
+		~RecordWriter()
+		{
+			if (descriptor >= 0)
+			{
+				::close(descriptor);
+			}
+		}
+
+		void add(const RecordType& record)
+		{
+			buffer.push_back(record);
+			++count;
+			if (buffer.size() == buffer.capacity())
+			{
+				flush();
+			}
+		}
+
+		/* Write an array of records directly, without copying them to the buffer. */
+		void add(const RecordType* records, std::size_t record_count)
+		{
+			flush();
+			writeBytes(records, record_count * sizeof(RecordType));
+			count += record_count;
+		}
+
+		/* Return the number of records added, which is also the index of the next record. */
+		std::size_t size() const
+		{
+			return count;
+		}
+
+		void close()
+		{
+			flush();
+			::close(descriptor);
+			descriptor = -1;
+		}
+	};
+
+	/* Map a file of records written by RecordWriter into memory, read-only. */
+	template <typename RecordType>
+	class MappedRecords
+	{
+		const RecordType* records{nullptr};
+		std::size_t count{0};
+
+	public:
+		explicit MappedRecords(const std::string& path)
+		{
+			int descriptor = ::open(path.c_str(), O_RDONLY);
+			struct stat status;
+
+			if (descriptor < 0 || ::fstat(descriptor, &status) != 0)
+			{
+				if (descriptor >= 0)
+				{
+					::close(descriptor);
+				}
+				throw "Could not open a file of an external-memory search.";
+			}
+			count = (std::size_t)status.st_size / sizeof(RecordType);
+			if (count > 0)
+			{
+				void* memory = ::mmap(nullptr, count * sizeof(RecordType), PROT_READ, MAP_PRIVATE, descriptor, 0);
+				if (memory == MAP_FAILED)
+				{
+					::close(descriptor);
+					throw "Could not map a file of an external-memory search.";
+				}
+				records = static_cast<const RecordType*>(memory);
+			}
+			::close(descriptor);  // The mapping keeps the file open.
+		}
+
+		MappedRecords(const MappedRecords&) = delete;
+		MappedRecords& operator=(const MappedRecords&) = delete;
+
+		~MappedRecords()
+		{
+			if (records != nullptr)
+			{
+				::munmap(const_cast<RecordType*>(records), count * sizeof(RecordType));
+			}
+		}
+
+		const RecordType& operator[](std::size_t index) const
+		{
+			return records[index];
+		}
+
+		std::size_t size() const
+		{
+			return count;
+		}
+	};
+
+	/*
+	Return the index of the first record at or after "position" in a file sorted by bytesLess that is not less than
+	"value."  Search forward in steps that double, and then binary search the last step, so that a series of calls for
+	increasing values reads only the parts of the file near the values.
+	*/
+	template <typename RecordType>
+	std::size_t seekSorted(const MappedRecords<RecordType>& file, std::size_t position, const RecordType& value)
+	{
+		std::size_t low = position;
+		std::size_t high = position;
+		std::size_t step = 1;
+
+		while (high < file.size() && bytesLess(file[high], value))
+		{
+			low = high + 1;
+			high += step;
+			step *= 2;
+		}
+		high = std::min(high, file.size());
+		if (low >= high)
+		{
+			return low;
+		}
+		return std::lower_bound(&file[low], &file[0] + high, value, bytesLess<RecordType>) - &file[0];
+	}
+
+	/*
+	Merge files of records, each sorted by "less," and pass the records to "output" in sorted order until it returns
+	false.  Only the front record of each file is in a heap at once.
+	*/
+	template <typename RecordType, typename Less, typename Output>
+	void mergeFiles(const std::vector<std::string>& paths, Less less, Output output)
+	{
+		struct Cursor
+		{
+			const MappedRecords<RecordType>* file;
+			std::size_t position;
+		};
+
+		std::vector<std::unique_ptr<MappedRecords<RecordType>>> files;
+		auto later = [&less](const Cursor& a, const Cursor& b) {
+			return less((*b.file)[b.position], (*a.file)[a.position]);
+		};
+		std::priority_queue<Cursor, std::vector<Cursor>, decltype(later)> heap{later};
+
+		for (const std::string& path : paths)
+		{
+			files.emplace_back(new MappedRecords<RecordType>{path});
+			if (files.back()->size() > 0)
+			{
+				heap.push(Cursor{files.back().get(), 0});
+			}
+		}
+		while (!heap.empty())
+		{
+			Cursor cursor = heap.top();
+			heap.pop();
+			if (!output((*cursor.file)[cursor.position]))
+			{
+				return;
+			}
+			if (++cursor.position < cursor.file->size())
+			{
+				heap.push(cursor);
+			}
+		}
+	}
+} // End of the graphsearch namespace.
+
+#endif
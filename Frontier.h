@@ -7,6 +7,15 @@ for ensuring frontiers have a standard interface, which in turn reduces code.  F
 first search should use a queue as the frontier; a depth-first search, a stack.  In both cases, we
 need to be able to add nodes to the frontier and get/remove the next node.  The C++ standard
 template library provides queues and stacks, but they use different method names for these operations.
+Uniform-cost and A* searches use a priority queue (a binary heap) as the frontier, indexed by state so that each
+state has at most one node on it.  A bounded frontier is a priority queue with a ceiling on its nodes, which drops
+the worst nodes to stay under it.  Parallel depth-first searches give each thread a double-ended queue that other
+threads can steal from.
+
+Besides the Frontier interface, the final frontier classes have "clear," which empties the frontier but keeps as much
+of its memory as the container allows, so that a problem can reuse a frontier for its next search.  They take an
+allocator as their last template variable, for their containers, and can be constructed with an instance of it.  See
+Arena.h.
 
 TODO - This code has room for improvement.  Three of the four overridden methods are identical.
 I would like to have the container member as part of the base class.  Then I could define those
@@ -16,16 +25,30 @@ use multiple inheritance with the child classes.
 
 #pragma once
 
+#include <algorithm>     // std::push_heap, std::pop_heap, std::max
+#include <cstddef>       // std::size_t
+#include <cstdint>       // std::uint32_t
+#include <deque>
+#include <initializer_list>
+#include <memory>        // std::allocator
+#include <mutex>
 #include <queue>
 #include <stack>
+#include <utility>       // std::move, std::swap
+#include <vector>
 
 namespace graphsearch
 {
-	/* This abstract base class specifies an interface for use in GraphSearch.h. */
+	/*
+	This abstract base class specifies an interface for use in GraphSearch.h.  The frontier classes below are final,
+	so a search that knows which one it has can call their methods without virtual dispatch.
+	*/
 	template <typename NodeType>
 	class Frontier
 	{
 	public:
+		virtual ~Frontier() = default;
+
 		virtual void add(const NodeType& node) = 0;
 
 		virtual const NodeType& next() const = 0;
@@ -35,12 +58,16 @@ namespace graphsearch
 		virtual bool isEmpty() const = 0;
 	};
 
-	template <typename NodeType>
-	class DepthFirstFrontier : public Frontier<NodeType>
+	template <typename NodeType, typename AllocatorType = std::allocator<NodeType>>
+	class DepthFirstFrontier final : public Frontier<NodeType>
 	{
-		std::stack<NodeType> container;
+		std::stack<NodeType, std::deque<NodeType, AllocatorType>> container;
 
 	public:
+		explicit DepthFirstFrontier(const AllocatorType& allocator = AllocatorType()) : container(allocator)
+		{
+		}
+
 		void add(const NodeType& node) override
 		{
 			container.push(node);
@@ -60,14 +87,26 @@ namespace graphsearch
 		{
 			return container.empty();
 		}
+
+		void clear()
+		{
+			while (!container.empty())
+			{
+				container.pop();
+			}
+		}
 	};
 
-	template <typename NodeType>
-	class BreadthFirstFrontier : public Frontier<NodeType>
+	template <typename NodeType, typename AllocatorType = std::allocator<NodeType>>
+	class BreadthFirstFrontier final : public Frontier<NodeType>
 	{
-		std::queue<NodeType> container;
+		std::queue<NodeType, std::deque<NodeType, AllocatorType>> container;
 
 	public:
+		explicit BreadthFirstFrontier(const AllocatorType& allocator = AllocatorType()) : container(allocator)
+		{
+		}
+
 		void add(const NodeType& node) override
 		{
 			container.push(node);
@@ -87,5 +126,530 @@ namespace graphsearch
 		{
 			return container.empty();
 		}
+
+		void clear()
+		{
+			while (!container.empty())
+			{
+				container.pop();
+			}
+		}
+	};
+
+	/*
+	A priority frontier is a binary heap.  The template variable "Compare" follows the convention of
+	std::priority_queue:  Compare(a, b) returns true if node "a" should be removed from the frontier after node "b."
+
+	This is a plain heap:  nodes cannot be re-prioritized once they are on the frontier, and nothing stops the frontier
+	from holding several nodes for the same state.  A search that needs to lower the priority of a state on the frontier,
+	as uniform-cost and A* search do, should use IndexedPriorityFrontier instead.
+
+	The heap is a vector managed with the standard heap algorithms, as std::priority_queue does, so that "clear" can
+	keep its capacity.
+	*/
+	template <typename NodeType, typename Compare, typename AllocatorType = std::allocator<NodeType>>
+	class PriorityFrontier final : public Frontier<NodeType>
+	{
+		std::vector<NodeType, AllocatorType> container;
+		Compare compare;
+
+	public:
+		explicit PriorityFrontier(const AllocatorType& allocator = AllocatorType()) : container(allocator)
+		{
+		}
+
+		void add(const NodeType& node) override
+		{
+			container.push_back(node);
+			std::push_heap(container.begin(), container.end(), compare);
+		}
+
+		const NodeType& next() const override
+		{
+			return container.front();
+		}
+
+		void pop() override
+		{
+			std::pop_heap(container.begin(), container.end(), compare);
+			container.pop_back();
+		}
+
+		bool isEmpty() const override
+		{
+			return container.empty();
+		}
+
+		void clear()
+		{
+			container.clear();
+		}
+	};
+
+	/*
+	A bounded frontier is a priority frontier that holds at most "max_nodes" nodes.  "Compare" is as for
+	PriorityFrontier, and an instance can be passed to the constructor if it needs state.  Adding a node to a full
+	frontier drops the node that would be removed last, either the new node or the worst node on the frontier, and
+	counts it in "pruned."  A search that uses it is neither complete nor optimal, but the frontier's memory never
+	exceeds its ceiling.  "nodesWithin" converts a ceiling in bytes to nodes.
+
+	The nodes are a min-max heap, a binary heap whose even levels are ordered by the node to remove first and whose
+	odd levels by the node to remove last, so that "next," "pop," and dropping the worst node are all cheap.  The
+	frontier reserves room for max_nodes nodes when the first is added, so that growing the vector never briefly
+	holds two copies of it.
+	*/
+	template <typename NodeType, typename Compare, typename AllocatorType = std::allocator<NodeType>>
+	class BoundedFrontier final : public Frontier<NodeType>
+	{
+		std::vector<NodeType, AllocatorType> heap;
+		std::size_t max_nodes;
+		std::size_t pruned_nodes{0};
+		Compare compare;
+
+		/* Return true if node "a" should be removed before node "b." */
+		bool before(const NodeType& a, const NodeType& b) const
+		{
+			return compare(b, a);
+		}
+
+		static bool onFirstLevel(std::size_t position)
+		{
+			unsigned level = 0;
+
+			for (++position; position > 1; position >>= 1)
+			{
+				++level;
+			}
+			return level % 2 == 0;
+		}
+
+		/*
+		Move the node at "position" up through the levels of its own kind while it belongs above its grandparent:  on
+		the first levels, while it should be removed before it, and on the last levels, after it.
+		*/
+		void bubbleUp(std::size_t position, bool first_level)
+		{
+			while (position > 2)
+			{
+				std::size_t grandparent = ((position - 1) / 2 - 1) / 2;
+				if (first_level ? !before(heap[position], heap[grandparent]) : !before(heap[grandparent], heap[position]))
+				{
+					break;
+				}
+				std::swap(heap[position], heap[grandparent]);
+				position = grandparent;
+			}
+		}
+
+		void siftUp(std::size_t position)
+		{
+			if (position == 0)
+			{
+				return;
+			}
+
+			std::size_t parent = (position - 1) / 2;
+			bool first_level = onFirstLevel(position);
+			if (first_level ? before(heap[parent], heap[position]) : before(heap[position], heap[parent]))
+			{
+				std::swap(heap[position], heap[parent]);
+				bubbleUp(parent, !first_level);
+			}
+			else
+			{
+				bubbleUp(position, first_level);
+			}
+		}
+
+		/*
+		Move the node at "position" down until it belongs there.  On a first level, it goes below the child or grandchild
+		that should be removed first, if that one should be removed before it; on a last level, the same for the child
+		or grandchild to remove last.
+		*/
+		void siftDown(std::size_t position)
+		{
+			bool first_level = onFirstLevel(position);
+
+			for (;;)
+			{
+				std::size_t child = 2 * position + 1;
+				if (child >= heap.size())
+				{
+					return;
+				}
+
+				// Find the child or grandchild that belongs on top.
+				std::size_t top = child;
+				for (std::size_t candidate : { child + 1, 2 * child + 1, 2 * child + 2, 2 * child + 3, 2 * child + 4 })
+				{
+					if (candidate < heap.size() && (first_level ? before(heap[candidate], heap[top]) :
+						before(heap[top], heap[candidate])))
+					{
+						top = candidate;
+					}
+				}
+				if (!(first_level ? before(heap[top], heap[position]) : before(heap[position], heap[top])))
+				{
+					return;
+				}
+				std::swap(heap[position], heap[top]);
+				if (top <= child + 1)
+				{
+					return;  // A child has no children of its kind below it to compare with.
+				}
+
+				// The node moved down to a grandchild's place.  Keep it on the right side of its new parent.
+				std::size_t parent = (top - 1) / 2;
+				if (first_level ? before(heap[parent], heap[top]) : before(heap[top], heap[parent]))
+				{
+					std::swap(heap[top], heap[parent]);
+				}
+				position = top;
+			}
+		}
+
+		/* Return the position of the node to remove last. */
+		std::size_t worst() const
+		{
+			if (heap.size() < 3)
+			{
+				return heap.size() - 1;
+			}
+			return before(heap[1], heap[2]) ? 2 : 1;
+		}
+
+		/* Remove the node at "position," which is the next node or the worst. */
+		void removeAt(std::size_t position)
+		{
+			heap[position] = std::move(heap.back());
+			heap.pop_back();
+			if (position < heap.size())
+			{
+				siftDown(position);
+			}
+		}
+
+	public:
+		explicit BoundedFrontier(std::size_t the_max_nodes, const Compare& the_compare = Compare(),
+			const AllocatorType& allocator = AllocatorType())
+			: heap(allocator), max_nodes{the_max_nodes}, compare(the_compare)
+		{
+			if (max_nodes == 0)
+			{
+				throw "A bounded frontier needs room for at least one node.";
+			}
+		}
+
+		/* Return the number of nodes that fit in the given number of bytes, or 1 if none do. */
+		static std::size_t nodesWithin(std::size_t bytes)
+		{
+			return std::max(bytes / sizeof(NodeType), std::size_t{1});
+		}
+
+		void add(const NodeType& node) override
+		{
+			if (heap.capacity() < max_nodes)
+			{
+				heap.reserve(max_nodes);
+			}
+			if (heap.size() == max_nodes)
+			{
+				++pruned_nodes;
+				std::size_t position = worst();
+				if (!before(node, heap[position]))
+				{
+					return;  // The new node is no better than the worst.
+				}
+				removeAt(position);
+			}
+			heap.push_back(node);
+			siftUp(heap.size() - 1);
+		}
+
+		const NodeType& next() const override
+		{
+			return heap.front();
+		}
+
+		void pop() override
+		{
+			removeAt(0);
+		}
+
+		bool isEmpty() const override
+		{
+			return heap.empty();
+		}
+
+		std::size_t size() const
+		{
+			return heap.size();
+		}
+
+		/* Return the number of nodes dropped to stay under the ceiling since the frontier was constructed or cleared. */
+		std::size_t pruned() const
+		{
+			return pruned_nodes;
+		}
+
+		void clear()
+		{
+			heap.clear();
+			pruned_nodes = 0;
+		}
+	};
+
+	/*
+	An indexed priority frontier is a binary heap of nodes that each have a key, such as the index of the node's state
+	in a state table, with an index of the position of each key's node in the heap.  A key has at most one node on the
+	frontier:  "push" adds a node for a key that has none, and for a key that has one, replaces it with the new node if
+	the new node should be removed first.  "update" replaces it either way, and "erase" removes it.  "Compare" is as for
+	PriorityFrontier.
+
+	It doesn't implement the Frontier interface, whose "add" has no key.  Keys should be small integers, because the
+	index is a vector with an entry for every key up to the largest.  "clear" keeps the capacity of both vectors.
+	*/
+	template <typename NodeType, typename Compare, typename AllocatorType = std::allocator<NodeType>>
+	class IndexedPriorityFrontier
+	{
+		struct Entry
+		{
+			NodeType node;
+			std::uint32_t key;
+		};
+
+		typedef typename std::allocator_traits<AllocatorType>::template rebind_alloc<Entry> EntryAllocator;
+		typedef typename std::allocator_traits<AllocatorType>::template rebind_alloc<std::uint32_t> KeyAllocator;
+
+		static const std::uint32_t absent = UINT32_MAX;
+
+		std::vector<Entry, EntryAllocator> heap;
+		std::vector<std::uint32_t, KeyAllocator> positions;  // The position in "heap" of each key's node, or "absent"
+		Compare compare;
+
+		void place(std::size_t position, Entry&& entry)
+		{
+			positions[entry.key] = (std::uint32_t)position;
+			heap[position] = std::move(entry);
+		}
+
+		/* Move the entry at "position" up until its parent should be removed before it. */
+		void siftUp(std::size_t position)
+		{
+			Entry entry = std::move(heap[position]);
+
+			while (position > 0)
+			{
+				std::size_t parent = (position - 1) / 2;
+				if (!compare(heap[parent].node, entry.node))
+				{
+					break;
+				}
+				place(position, std::move(heap[parent]));
+				position = parent;
+			}
+			place(position, std::move(entry));
+		}
+
+		/* Move the entry at "position" down until it should be removed before both of its children. */
+		void siftDown(std::size_t position)
+		{
+			Entry entry = std::move(heap[position]);
+
+			for (;;)
+			{
+				std::size_t child = 2 * position + 1;
+				if (child >= heap.size())
+				{
+					break;
+				}
+				if (child + 1 < heap.size() && compare(heap[child].node, heap[child + 1].node))
+				{
+					++child;
+				}
+				if (!compare(entry.node, heap[child].node))
+				{
+					break;
+				}
+				place(position, std::move(heap[child]));
+				position = child;
+			}
+			place(position, std::move(entry));
+		}
+
+		/* Move the entry at "position," whose node has changed, up or down to where it belongs. */
+		void restore(std::size_t position)
+		{
+			if (position > 0 && compare(heap[(position - 1) / 2].node, heap[position].node))
+			{
+				siftUp(position);
+			}
+			else
+			{
+				siftDown(position);
+			}
+		}
+
+	public:
+		explicit IndexedPriorityFrontier(const AllocatorType& allocator = AllocatorType())
+			: heap(EntryAllocator(allocator)), positions(KeyAllocator(allocator))
+		{
+		}
+
+		bool contains(std::uint32_t key) const
+		{
+			return key < positions.size() && positions[key] != absent;
+		}
+
+		/*
+		Add a node for a key.  If the key already has a node on the frontier, replace it if the new node should be
+		removed first, and otherwise keep it.  Return true unless the old node was kept.
+		*/
+		bool push(std::uint32_t key, const NodeType& node)
+		{
+			if (key >= positions.size())
+			{
+				positions.resize(std::size_t{key} + 1, std::uint32_t{absent});
+			}
+			if (positions[key] == absent)
+			{
+				heap.push_back(Entry{node, key});
+				siftUp(heap.size() - 1);
+				return true;
+			}
+
+			Entry& entry = heap[positions[key]];
+			if (!compare(entry.node, node))
+			{
+				return false;
+			}
+			entry.node = node;
+			siftUp(positions[key]);
+			return true;
+		}
+
+		/* Add a node for a key, or replace the key's node with it, whether or not the new node should be removed first. */
+		void update(std::uint32_t key, const NodeType& node)
+		{
+			if (!contains(key))
+			{
+				push(key, node);
+				return;
+			}
+			heap[positions[key]].node = node;
+			restore(positions[key]);
+		}
+
+		/* Remove the key's node, if it has one. */
+		void erase(std::uint32_t key)
+		{
+			if (!contains(key))
+			{
+				return;
+			}
+
+			std::size_t position = positions[key];
+			positions[key] = absent;
+			if (position + 1 < heap.size())
+			{
+				place(position, std::move(heap.back()));
+				heap.pop_back();
+				restore(position);
+			}
+			else
+			{
+				heap.pop_back();
+			}
+		}
+
+		const NodeType& next() const
+		{
+			return heap.front().node;
+		}
+
+		/* Return the key of the next node. */
+		std::uint32_t nextKey() const
+		{
+			return heap.front().key;
+		}
+
+		void pop()
+		{
+			positions[heap.front().key] = absent;
+			if (heap.size() > 1)
+			{
+				place(0, std::move(heap.back()));
+				heap.pop_back();
+				siftDown(0);
+			}
+			else
+			{
+				heap.pop_back();
+			}
+		}
+
+		bool isEmpty() const
+		{
+			return heap.empty();
+		}
+
+		std::size_t size() const
+		{
+			return heap.size();
+		}
+
+		void clear()
+		{
+			heap.clear();
+			positions.clear();
+		}
+	};
+
+	/*
+	A work-stealing frontier belongs to one thread of a parallel search.  The owner adds and takes nodes at the back,
+	last-in-first-out like DepthFirstFrontier.  Threads that run out of nodes steal from the front, where the nodes
+	closest to the start of the search are, which tend to lead to the most work.  A mutex guards the container.
+
+	This class does not implement the Frontier interface.  With other threads stealing, a reference from "next" could
+	be invalidated before "pop" is called, so "take" and "steal" remove a node and copy it out in one step.
+	*/
+	template <typename NodeType>
+	class WorkStealingFrontier
+	{
+		std::deque<NodeType> container;
+		std::mutex mutex;
+
+	public:
+		void add(const NodeType& node)
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			container.push_back(node);
+		}
+
+		/* Remove the newest node, and copy it to "node."  Return false if the frontier is empty. */
+		bool take(NodeType& node)
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			if (container.empty())
+			{
+				return false;
+			}
+			node = container.back();
+			container.pop_back();
+			return true;
+		}
+
+		/* Remove the oldest node, and copy it to "node."  Return false if the frontier is empty. */
+		bool steal(NodeType& node)
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			if (container.empty())
+			{
+				return false;
+			}
+			node = container.front();
+			container.pop_front();
+			return true;
+		}
 	};
 } // End of the graphsearch namespace.
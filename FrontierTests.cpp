@@ -5,7 +5,10 @@ You are welcome to use this code pursuant to the GNU General Public license.  Se
 This code tests Frontier.h.
 */
 
+#include <algorithm>       // std::min_element, std::max_element
 #include <memory>          // std::unique_ptr
+#include <random>
+#include <vector>
 #include "cute.h"
 #include "Frontier.h"
 #include "FrontierTests.h"
@@ -42,3 +45,129 @@ void DepthFirstFrontierTest() {
 	ASSERTM("A depth-first frontier should not be first-in-first-out (FIFO).", !(frontier->next() == SimpleStruct{1}));
 	frontierTestsHelper2(frontier.get());
 }
+
+/* Order SimpleStruct instances for a PriorityFrontier so that the lowest value of x is next. */
+struct SimpleStructGreater
+{
+	bool operator()(const SimpleStruct& a, const SimpleStruct& b) const
+	{
+		return a.x > b.x;
+	}
+};
+
+void PriorityFrontierTest() {
+	std::unique_ptr<graphsearch::PriorityFrontier<SimpleStruct, SimpleStructGreater>> frontier{new graphsearch::PriorityFrontier<SimpleStruct, SimpleStructGreater>};
+	frontierTestsHelper1(frontier.get());
+	ASSERTM("A priority frontier should return the node with the lowest priority first.", (frontier->next() == SimpleStruct{1}));
+	frontier->add(SimpleStruct{0});
+	ASSERTM("A priority frontier should not be first-in-first-out (FIFO).", (frontier->next() == SimpleStruct{0}));
+	frontier->pop();
+	ASSERTM("A priority frontier should not be last-in-first-out (LIFO).", (frontier->next() == SimpleStruct{1}));
+	frontierTestsHelper2(frontier.get());
+}
+
+void BoundedFrontierTest() {
+	typedef graphsearch::BoundedFrontier<SimpleStruct, SimpleStructGreater> Bounded;
+	Bounded frontier{3};
+
+	frontierTestsHelper1(&frontier);
+	ASSERTM("A bounded frontier should return the node with the lowest priority first.", (frontier.next() == SimpleStruct{1}));
+	frontier.add(SimpleStruct{5});
+	frontier.add(SimpleStruct{4});
+	ASSERTM("A full frontier should drop its worst node.", frontier.size() == 3 && frontier.pruned() == 1);
+	frontier.add(SimpleStruct{6});
+	ASSERTM("A full frontier should drop a new node worse than its nodes.", frontier.size() == 3 && frontier.pruned() == 2);
+	frontier.pop();
+	ASSERTM("The remaining nodes should come out in order.", (frontier.next() == SimpleStruct{2}));
+	frontier.pop();
+	ASSERTM("The remaining nodes should come out in order.", (frontier.next() == SimpleStruct{4}));
+	frontier.pop();
+	ASSERTM("The frontier should now be empty.", frontier.isEmpty());
+	ASSERT_EQUAL(2, Bounded::nodesWithin(2 * sizeof(SimpleStruct) + 1));
+	ASSERT_THROWSM("A frontier with no room should raise an exception.", Bounded{0}, const char*);
+
+	// Compare a random series of adds and pops with a vector that drops its largest value when it is full.
+	std::mt19937 random{7};
+	std::uniform_int_distribution<int> any_value{0, 99};
+	std::vector<int> expected;
+	std::size_t expected_pruned = 0;
+	Bounded large{37};
+	for (int i = 0; i < 5000; ++i)
+	{
+		if (random() % 3 != 0)
+		{
+			int x = any_value(random);
+			large.add(SimpleStruct{x});
+			if (expected.size() == 37)
+			{
+				++expected_pruned;
+				std::vector<int>::iterator largest = std::max_element(expected.begin(), expected.end());
+				if (x >= *largest)
+				{
+					continue;
+				}
+				expected.erase(largest);
+			}
+			expected.push_back(x);
+		}
+		else if (!expected.empty())
+		{
+			std::vector<int>::iterator smallest = std::min_element(expected.begin(), expected.end());
+			ASSERTM("The next node should have the lowest value.", large.next() == SimpleStruct{*smallest});
+			expected.erase(smallest);
+			large.pop();
+		}
+		ASSERTM("The frontier should hold the expected number of nodes.", large.size() == expected.size());
+	}
+	ASSERT_EQUAL(expected_pruned, large.pruned());
+	large.clear();
+	ASSERTM("Clearing the frontier should reset it.", large.isEmpty() && large.pruned() == 0);
+}
+
+void IndexedPriorityFrontierTest() {
+	graphsearch::IndexedPriorityFrontier<SimpleStruct, SimpleStructGreater> frontier;
+
+	ASSERTM("The frontier should start out empty.", frontier.isEmpty() && !frontier.contains(0));
+	ASSERTM("Pushing a node for a new key should add it.", frontier.push(7, SimpleStruct{5}) && frontier.contains(7));
+	frontier.push(3, SimpleStruct{4});
+	frontier.push(5, SimpleStruct{6});
+	ASSERT_EQUAL(3, frontier.size());
+	ASSERTM("The node with the lowest priority should be next.", frontier.next() == SimpleStruct{4} && frontier.nextKey() == 3);
+	ASSERTM("A node that would be removed later should not replace the key's node.", !frontier.push(5, SimpleStruct{8}));
+	ASSERTM("A node that would be removed sooner should replace the key's node.", frontier.push(5, SimpleStruct{1}));
+	ASSERT_EQUAL(3, frontier.size());
+	ASSERTM("The replaced node should move up the heap.", frontier.next() == SimpleStruct{1} && frontier.nextKey() == 5);
+	frontier.pop();
+	ASSERTM("A popped key should no longer be on the frontier.", !frontier.contains(5) && frontier.contains(3));
+	ASSERTM("The remaining nodes should come out in order.", frontier.nextKey() == 3);
+	frontier.pop();
+	ASSERTM("The remaining nodes should come out in order.", frontier.nextKey() == 7 && frontier.next() == SimpleStruct{5});
+	ASSERTM("A popped key should be pushed again as a new key.", frontier.push(5, SimpleStruct{9}) && frontier.size() == 2);
+	frontier.push(2, SimpleStruct{7});
+	frontier.update(7, SimpleStruct{10});
+	ASSERTM("Updating a key should replace its node even if it comes later.", frontier.nextKey() == 2);
+	frontier.update(5, SimpleStruct{0});
+	ASSERTM("Updating a key should replace its node if it comes first.", frontier.nextKey() == 5 && frontier.size() == 3);
+	frontier.erase(5);
+	frontier.erase(5);
+	ASSERTM("Erasing a key should remove its node.", !frontier.contains(5) && frontier.size() == 2 && frontier.nextKey() == 2);
+	frontier.pop();
+	ASSERTM("The heap should stay in order after an erase.", frontier.nextKey() == 7 && frontier.next() == SimpleStruct{10});
+	frontier.clear();
+	ASSERTM("Clearing the frontier should remove every key.", frontier.isEmpty() && !frontier.contains(7) && !frontier.contains(5));
+}
+
+void WorkStealingFrontierTest() {
+	graphsearch::WorkStealingFrontier<SimpleStruct> frontier;
+	SimpleStruct node;
+
+	ASSERTM("Taking from an empty frontier should fail.", !frontier.take(node));
+	ASSERTM("Stealing from an empty frontier should fail.", !frontier.steal(node));
+	frontier.add(SimpleStruct{1});
+	frontier.add(SimpleStruct{2});
+	frontier.add(SimpleStruct{3});
+	ASSERTM("The owner should take the newest node (LIFO).", frontier.take(node) && node == SimpleStruct{3});
+	ASSERTM("A thief should steal the oldest node (FIFO).", frontier.steal(node) && node == SimpleStruct{1});
+	ASSERTM("The last node should be available to the owner.", frontier.take(node) && node == SimpleStruct{2});
+	ASSERTM("The frontier should now be empty.", !frontier.take(node) && !frontier.steal(node));
+}
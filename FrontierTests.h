@@ -25,3 +25,7 @@ struct SimpleStruct
 // Test function prototypes:
 void BreadthFirstFrontierTest();
 void DepthFirstFrontierTest();
+void PriorityFrontierTest();
+void BoundedFrontierTest();
+void IndexedPriorityFrontierTest();
+void WorkStealingFrontierTest();
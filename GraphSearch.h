@@ -1,231 +1,3155 @@
-/*
-(C) David J. Kalbfleisch 2016
-You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
-
-This code implements an abstract base class for graph searching using algorithms presented in, "AI: A Modern Approach,"
-by Stuart Russell and Peter Norvig.  The code makes use of C++1x features, including the standard template library.
-
-A good reference for understanding the algorithms:
-http://www.cs.cornell.edu/courses/CS2112/2012sp/lectures/lec24/lec24-12sp.html
-*/
-
-#pragma once
-
-#include <algorithm>     // std::reverse
-#include <functional>    // std::hash
-#include <memory>        // std::unique_ptr
-#include <queue>
-#include <stack>
-#include <unordered_set>
-#include <vector>
-#include "Frontier.h"
-
-namespace graphsearch
-{
-	/*
-	This enumerated class is used below in the Problem class template.  Any other enumerated type used with the Problem
-	class template should also have a member named "start_state" because that value is hard-coded in the Problem class.
-	TODO - Can I avoid this hard-coded value?
-	*/
-	enum class DefaultActions { start_state };
-												 
-	/*
-	This is an abstract base class representing a graph search problem.  Subclass it.  At a minimum, you must implement
-	the methods "actions" and "result."
-
-	This implementation assumes that states are unique, although they can be reached by different sequences of actions.
-	Additionally, path costs are not considered.  It assumes that actions are deterministic.  Taking a given action
-	from a given state must yield one successor state that is not the same state.  It also assumes that all paths have
-	equal cost, and it does not use heuristics to estimate the best path.
-	
-	TODO - Address these limitations.  The book deals with all of them.
-
-	The type used for the template variable "StateType," which is likely to be a structure, must implement the equality
-	(==) operator to work with the unordered_set container type.  It must also have an appropriate hashing class,
-	which is the third template type variable, and it must implement the assignment (=) operator.
-	*/
-	template<typename StateType, typename ActionsType = DefaultActions, typename StateHashType = std::hash<StateType>>
-	class Problem
-	{
-		typedef std::unordered_set<StateType, StateHashType> StateSet;
-		typedef std::vector<ActionsType> SolutionVector;
-		typedef std::vector<StateType> PathVector;
-
-		/*
-		A node includes a state plus additional information needed to describe the transition from some initial state
-		to some goal state, which are parameters for a search method (below).  Graph search methods create instances
-		of Node as necessary.
-		*/
-		struct Node
-		{
-			StateType state;
-			int parent_index;    // The index into the "Problem::nodes" private member vector
-			ActionsType action;
-
-			Node() = default;
-
-			Node(StateType the_state, int the_parent_index, ActionsType the_action)
-				: state{the_state}, parent_index{the_parent_index}, action{the_action}
-			{
-			}
-		};
-
-		// Searches populate these private members, which are used the generation solution and path vectors.
-		bool solution_found{false};  // Did the last search find a solution?
-		std::vector<Node> nodes;
-
-		/* Populate a vector with the actions that can be executed from the given state. */
-		virtual void actions(StateType state, std::vector<ActionsType>& available_actions) const = 0;
-
-		/*
-		Return the state reached by taking a given action in a given state.  This implementation assumes that
-		actions are deterministic (i.e. that the return type is a single value rather than a container).
-		TODO - Support non-deterministic actions.
-		*/
-		virtual const StateType result(StateType state, ActionsType action) = 0;
-
-		/*
-		Return a vector of Node instances reachable from a given state.  The vector can be empty.  This
-		implementation assumes a deterministic outcome; there is only one successor for a given action.
-		TODO - Support non-deterministic actions.
-		*/
-		void expand(StateType state, int parent_index, std::vector<Node>& successors)
-		{
-			std::vector<ActionsType> available_actions;
-			actions(state, available_actions);  // Populates available_actions.
-			successors.clear();
-			for (ActionsType the_action : available_actions)
-			{
-				successors.emplace_back(result(state, the_action), parent_index, the_action);
-			}
-		}
-
-	public:
-		/*
-		The solution is the sequence of actions an agent must take to progress from the start state
-		to a goal state.  Return the solution to the most recent search as a vector of actions.
-
-		// TODO - For non-deterministic actions, the solution is a contingency plan.
-		*/
-		void solution(SolutionVector& the_solution)
-		{
-			if (!solution_found)
-			{
-				throw "You asked for a solution, but no solution was found.";  // TODO - Throw a standard exception?
-			}
-
-			the_solution.clear();  // Remove any previous solutions.
-
-			// The last node added to "nodes" contains a goal state.
-			int index = (int)nodes.size() - 1;
-
-			while (nodes[index].action != ActionsType::start_state)
-			{
-				the_solution.emplace_back(nodes[index].action);
-				index = nodes[index].parent_index;
-			}
-			std::reverse(the_solution.begin(), the_solution.end());  // Re-orders in place.
-		}
-
-		/*
-		The path is the sequence of states through which an agent must progress from the start state
-		to a goal state.  Return the path of the most recent search as a vector of states.
-		*/
-		void path(PathVector& the_path)
-		{
-			if (!solution_found)
-			{
-				throw "You asked for a path, but no path was found.";  // TODO - Throw a standard exception?
-			}
-
-			the_path.clear();  // Remove the path for any previous solutions.
-
-			// The last node added to "nodes" contains a goal state.
-			int index = (int)nodes.size() - 1;
-
-			while (index > 0)
-			{
-				the_path.emplace_back(nodes[index].state);
-				index = nodes[index].parent_index;
-			}
-			the_path.emplace_back(nodes[0].state);           // Add the start state.
-			std::reverse(the_path.begin(), the_path.end());  // Re-orders in place.
-		}
-
-		/*
-		Perform a graph search using a Frontier instance passed as a pointer.  Return True if a solution to the
-		problem is found.  Otherwise, return False.  Upon success/true, the private member "solution" is populated,
-		and the "path" or "solution" method can be called without raising an exception.
-
-		To search to exhaustion--all available states have been expanded--set goal_states to an empty set.  You
-		could use this to traverse all states while computing side effects of some sort.
-		*/
-		bool search(StateType initial_state, const StateSet& goal_states, Frontier<Node>* frontier)
-		{
-			Node current_node;
-			std::vector<Node> children;
-			int current_index;
-			StateSet explored;             // Contains states already expanded; don't revisit them.
-			std::vector<Node> successors;  // For a given state, these are the states that can be reached with the available actions.
-
-			// Clear remnants of prior searches.
-			nodes.clear();
-			solution_found = false;
-
-			// Push a node for the problem's initial state onto the frontier, which is a container for unexplored nodes.
-			frontier->add(Node{initial_state, 0, ActionsType::start_state});
-			explored.insert(initial_state);
-
-			// Expand nodes until the frontier is empty or until a goal state is found (whichever is sooner).
-			while (!frontier->isEmpty())
-			{
-				current_node = frontier->next();           // References the next node on the frontier.
-				nodes.emplace_back(current_node);          // Remember the current node.
-				current_index = (int)nodes.size() - 1;     // The index of the current node in Problem::nodes
-
-				if (goal_states.count(current_node.state) == 1)
-				{
-					// Found a goal state.
-					solution_found = true;
-					return true;
-				}
-
-				// The current node is not a goal.  Find its successors/children, and remove it from the frontier.
-				expand(current_node.state, current_index, successors);
-				frontier->pop();  // Pops the current node, and returns void.  Do this before pushing successors.
-
-				// Push unexplored successors onto the frontier.
-				for (const Node& successor : successors)
-				{
-					if (explored.count(successor.state) == 0)
-					{
-						// This successor is unexplored.
-						frontier->add(successor);
-						explored.insert(current_node.state);
-					}
-				}
-				successors.clear();  // Prepare for next iteration.
-			}
-
-			// The frontier is empty, and we didn't reach a goal node.
-			return false;
-		}
-
-		/* Perform a standard depth-first search.  This is the general search using a stack as the frontier. */
-		bool searchDepthFirst(StateType initial_state, const StateSet& goal_states)
-		{
-			std::unique_ptr<DepthFirstFrontier<Node>> frontier{new DepthFirstFrontier<Node>};
-			return search(initial_state, goal_states, frontier.get());
-		}
-
-		/* Perform a standard breadth-first search.  This is the general search using a queue as the frontier. */
-		bool searchBreadthFirst(StateType initial_state, const StateSet& goal_states)
-		{
-			std::unique_ptr<BreadthFirstFrontier<Node>> frontier{new BreadthFirstFrontier<Node>};
-			return search(initial_state, goal_states, frontier.get());
-		}
-
-		// TODO - Best-first search
-		// TODO - A* search (best-first search with back-tracking)
-	};
-} // End of the graphsearch namespace.
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code implements an abstract base class for graph searching using algorithms presented in, "AI: A Modern Approach,"
+by Stuart Russell and Peter Norvig.  The code makes use of C++1x features, including the standard template library.
+
+A good reference for understanding the algorithms:
+http://www.cs.cornell.edu/courses/CS2112/2012sp/lectures/lec24/lec24-12sp.html
+*/
+
+#pragma once
+
+#include <algorithm>     // std::min, std::reverse
+#include <atomic>
+#include <cstddef>       // std::size_t
+#include <cstdint>       // std::uint32_t
+#include <exception>     // std::exception_ptr
+#include <functional>    // std::hash
+#include <limits>        // std::numeric_limits
+#include <memory>        // std::allocator, std::allocator_traits, std::unique_ptr
+#include <mutex>
+#include <queue>
+#include <stack>
+#include <thread>
+#include <type_traits>   // std::is_trivially_copyable
+#include <unordered_set>
+#include <vector>
+#include "Bitmap.h"
+#include "ExternalMemory.h"
+#include "Frontier.h"
+#include "SearchLimits.h"
+#include "SearchStats.h"
+#include "StateTable.h"
+#include "SuccessorCache.h"
+
+namespace graphsearch
+{
+	/*
+	This enumerated class is used below in the Problem class template.  Any other enumerated type used with the Problem
+	class template should also have a member named "start_state" because that value is hard-coded in the Problem class.
+	TODO - Can I avoid this hard-coded value?
+	*/
+	enum class DefaultActions { start_state };
+
+	/*
+	What a search records about the solution it finds.  With "path," the default, it keeps the nodes it expands, and
+	"solution" and "path" return the solution.  With "distance," it keeps only the solution's cost, which "distance"
+	returns, and with "reachability," only whether there is a solution, which the search returns.  Both skip the
+	nodes, so the search needs memory only for the states it has seen and its frontier.
+	*/
+	enum class ResultKind { path, distance, reachability };
+
+	/*
+	When the depth-first and breadth-first searches mark a state as seen.  With "on_generation," the default, they mark
+	a state when they first generate it, so it enters the frontier at most once, and the frontier never holds more
+	nodes than there are states.  With "on_expansion," they mark a state when they expand it, and skip the nodes of
+	states already expanded when they reach the front, so a state can be on the frontier once for each state that
+	generates it before it is expanded.  That keeps the order of a depth-first search, which expands the newest path
+	to a state rather than the first one found.  The uniform-cost and A* searches keep one node per state regardless.
+	*/
+	enum class StateMarking { on_generation, on_expansion };
+
+	template <typename StatsType, typename AllocatorType> class CsrProblem;  // See CsrProblem.h.
+												 
+	/*
+	This is an abstract base class representing a graph search problem.  Subclass it.  At a minimum, you must implement
+	the methods "actions" and "result," or the method "successors."
+
+	This implementation assumes that states are unique, although they can be reached by different sequences of actions.
+	It assumes that actions are deterministic.  Taking a given action from a given state must yield one successor state
+	that is not the same state.  The breadth- and depth-first searches ignore path costs.  The uniform-cost and A*
+	searches use the costs given by "stepCost," and A* also uses the estimates given by "heuristic."  Override those
+	methods to use them.
+
+	TODO - Address the remaining limitations.  The book deals with all of them.
+
+	Thread safety:  searchBreadthFirstParallel and searchDepthFirstParallel call "successors" from several threads at
+	once, and the default "successors" calls "actions" and "result."  Overrides of those methods must be safe to call
+	concurrently:  they must not modify the problem or any other shared data without synchronizing.  (The default
+	"successors" keeps a buffer per thread.)  The other searches call them from the calling thread only.  Don't call
+	two searches on the same problem at once.
+
+	The type used for the template variable "StateType," which is likely to be a structure, must implement the equality
+	(==) operator to work with the unordered_set container type.  It must also have an appropriate hashing class,
+	which is the third template type variable, and it must implement the assignment (=) operator.
+
+	The fourth template variable is the table searches use to store states and to detect states they have already
+	seen.  See StateTable.h.  FlatStateTable is usually faster than the default.
+
+	A problem keeps its state table, its nodes, and the buffers of the serial searches from one search to the next,
+	and clears them in time proportional to what the last search touched.  To answer many queries, reuse one problem
+	(per thread) rather than creating a problem per query.
+
+	The fifth template variable is the statistics every search collects, which "stats" returns.  See SearchStats.h.
+	The default, NoSearchStats, collects none and costs nothing.
+
+	The sixth template variable is the allocator for the states, the nodes, and the frontiers of the serial searches and
+	the bidirectional search.  A problem is constructed with an instance of it, and constructs its state tables with
+	that instance, so the state table type must use the same allocator.  See Arena.h.  The parallel searches allocate
+	the memory their threads share from the global allocator.
+
+	If "actions" and "result" are expensive, "setSuccessorCache" makes the problem keep the successors of the states it
+	expands, within a memory budget, for this and later searches.  See SuccessorCache.h.
+	*/
+	template<typename StateType, typename ActionsType = DefaultActions, typename StateHashType = std::hash<StateType>,
+		typename StateTableType = StateTable<StateType, StateHashType>, typename StatsType = NoSearchStats,
+		typename AllocatorType = std::allocator<StateType>>
+	class Problem
+	{
+		// CsrProblem implements searches of its own, which record their results in the private members.
+		template <typename, typename> friend class CsrProblem;
+
+		template <typename T>
+		using AllocatedVector = std::vector<T, typename std::allocator_traits<AllocatorType>::template rebind_alloc<T>>;
+
+		typedef std::unordered_set<StateType, StateHashType> StateSet;
+		typedef std::vector<ActionsType> SolutionVector;
+		typedef std::vector<StateType> PathVector;
+
+		/*
+		A node includes a state plus additional information needed to describe the transition from some initial state
+		to some goal state, which are parameters for a search method (below).  Graph search methods create instances
+		of Node as necessary.
+		*/
+		struct Node
+		{
+			StateType state;
+			std::uint32_t parent_index;  // The index of the parent node in the "Problem::node_parents" etc. vectors
+			ActionsType action;
+			std::uint32_t depth{0};      // The number of actions from the initial state (frontier and best-first searches only)
+
+			Node() = default;
+
+			Node(StateType the_state, std::uint32_t the_parent_index, ActionsType the_action)
+				: state{the_state}, parent_index{the_parent_index}, action{the_action}
+			{
+			}
+		};
+
+		/*
+		A node of a search ordered by cost, which adds the node's costs.  Only uniform-cost, A*, and beam search order
+		nodes by cost, so the other searches keep the smaller Node on their frontiers.
+		*/
+		struct CostNode : Node
+		{
+			double path_cost{0.0};       // The cost of the path from the initial state (uniform-cost and A* only)
+			double estimated_cost{0.0};  // The path cost plus the heuristic estimate to a goal (A* and beam search only)
+
+			CostNode() = default;
+
+			CostNode(const Node& node) : Node(node)
+			{
+			}
+		};
+
+		/*
+		Order nodes for a priority frontier so that the node with the lowest estimated cost is next.  Break ties in favor
+		of the node with the greater path cost, which is likely closer to a goal.
+		*/
+		struct NodeCostComparison
+		{
+			bool operator()(const CostNode& a, const CostNode& b) const
+			{
+				if (a.estimated_cost == b.estimated_cost)
+				{
+					return a.path_cost < b.path_cost;
+				}
+				return a.estimated_cost > b.estimated_cost;
+			}
+		};
+
+		typedef typename std::allocator_traits<AllocatorType>::template rebind_alloc<Node> NodeAllocator;
+		typedef typename std::allocator_traits<AllocatorType>::template rebind_alloc<CostNode> CostNodeAllocator;
+
+		AllocatorType allocator;
+
+		// Searches populate these private members, which are used the generation solution and path vectors.
+		ResultKind result_kind{ResultKind::path};
+		StateMarking state_marking{StateMarking::on_generation};
+
+		// The kind of search "resumeSearch" continues, if the last search stopped at a limit, and the settings it began with
+		enum class StoppedSearch { none, depth_first, breadth_first, uniform_cost, a_star };
+		StoppedSearch stopped_search{StoppedSearch::none};
+		ResultKind stopped_result_kind{ResultKind::path};
+		StateMarking stopped_marking{StateMarking::on_generation};
+
+		bool solution_found{false};  // Did the last search find a solution?
+		std::uint32_t goal_index{0};  // The index of the goal node in the node vectors, if the search kept its path
+		double solution_cost{0.0};    // Unless the search recorded only reachability
+		StateTableType states;  // Each state the last search reached, stored once
+
+		/*
+		The nodes expanded by the last search, stored as parallel vectors with one element per node, in the order
+		expanded.  A node refers to its state by its index in "states" and to its parent by its index in these vectors.
+		The searches keep them only when result_kind is "path."
+		*/
+		AllocatedVector<std::uint32_t> node_states;
+		AllocatedVector<std::uint32_t> node_parents;
+		AllocatedVector<ActionsType> node_actions;
+
+		StatsType search_stats;  // The statistics of the last search
+		typename StatsType::TimePoint search_start;
+		std::size_t progress_interval{0};  // Call "progress" every this many nodes expanded, unless it is 0
+
+	public:
+		typedef ConcurrentSuccessorCache<StateType, ActionsType, StateHashType> SuccessorCacheType;
+
+	private:
+		// The successor cache, if "setSuccessorCache" has turned it on.  The parallel searches share it.
+		std::unique_ptr<SuccessorCacheType> successor_cache;
+
+		/*
+		Populate a vector with the actions that can be executed from the given state.  Override this and "result,"
+		or override "successors" instead.
+		*/
+		virtual void actions(StateType /* state */, std::vector<ActionsType>& /* available_actions */) const
+		{
+			throw "Override either actions and result, or successors.";
+		}
+
+		/*
+		Return the state reached by taking a given action in a given state.  This implementation assumes that
+		actions are deterministic (i.e. that the return type is a single value rather than a container).
+		TODO - Support non-deterministic actions.
+		*/
+		virtual const StateType result(StateType /* state */, ActionsType /* action */)
+		{
+			throw "Override either actions and result, or successors.";
+		}
+
+		/*
+		Return the cost of taking a given action in a given state to reach next_state.  Costs must not be negative.
+		The default is a cost of 1 for every action, in which case a uniform-cost search finds the same path length
+		as a breadth-first search.
+		*/
+		virtual double stepCost(const StateType& /* state */, ActionsType /* action */,
+			const StateType& /* next_state */) const
+		{
+			return 1.0;
+		}
+
+		/*
+		Return an estimate of the cost of the cheapest path from the given state to a goal state.  A* search finds an
+		optimal solution if this estimate never exceeds the true cost.  The default estimate is 0, which reduces A* to
+		a uniform-cost search.
+		*/
+		virtual double heuristic(const StateType& /* state */) const
+		{
+			return 0.0;
+		}
+
+	protected:
+		/*
+		A successor sink receives the action and resulting state for each successor of a state being expanded.  It adds
+		them as nodes to a vector owned by the search, which keeps its capacity from one expansion to the next.
+		*/
+		class SuccessorSink
+		{
+			std::vector<Node>& children;
+			std::uint32_t parent_index;
+
+		public:
+			SuccessorSink(std::vector<Node>& the_children, std::uint32_t the_parent_index)
+				: children(the_children), parent_index{the_parent_index}
+			{
+			}
+
+			void add(ActionsType action, const StateType& state)
+			{
+				children.emplace_back(state, parent_index, action);
+			}
+		};
+
+		/*
+		Add the action and resulting state for each successor of the given state to the sink.  The default calls
+		"actions" and then "result" for each action.  Override this method instead of those two to avoid copying
+		the state for every call and filling a vector of actions.  A search then performs no allocations to expand
+		a node once its buffers have grown to the largest number of successors.
+		*/
+		virtual void successors(const StateType& state, SuccessorSink& sink)
+		{
+			static thread_local std::vector<ActionsType> action_buffer;  // Reused to avoid reallocation
+
+			action_buffer.clear();
+			actions(state, action_buffer);  // Populates action_buffer.
+			for (ActionsType the_action : action_buffer)
+			{
+				sink.add(the_action, result(state, the_action));
+			}
+		}
+
+		/*
+		Add an action and a state for each predecessor of the given state to the sink:  taking the action in the
+		predecessor state results in the given state.  Only searchBidirectional and the incremental search call this, so
+		override it to use those searches.  It must be consistent with "successors."
+		*/
+		virtual void predecessors(const StateType& /* state */, SuccessorSink& /* sink */)
+		{
+			throw "Override predecessors to use a bidirectional or incremental search.";
+		}
+
+		/*
+		Return true if a state is a goal.  The overloads of the searches without a set of goal states call this instead
+		of looking states up in the set, so override it to use them when the goals are a region too large to list, or
+		are easier to recognize than to enumerate.  Like "successors," it must be safe to call from several threads at
+		once if a parallel search calls it.
+		*/
+		virtual bool isGoal(const StateType& /* state */) const
+		{
+			throw "Override isGoal to search without a set of goal states.";
+		}
+
+		/*
+		Report the progress of a long search.  If StatsType collects statistics and "setProgressInterval" has set an
+		interval, the searches call this from the calling thread every "interval" nodes expanded, with the statistics
+		so far.  The parallel breadth-first search calls it between levels, and the parallel depth-first search doesn't
+		call it.  The default does nothing.  Override it to export the statistics.
+		*/
+		virtual void progress(const StatsType& /* stats */)
+		{
+		}
+
+		/*
+		Populate a vector with the Node instances reachable from a given state.  The vector can be empty.  This
+		implementation assumes a deterministic outcome; there is only one successor for a given action.
+		TODO - Support non-deterministic actions.
+		*/
+		void expand(const StateType& state, std::uint32_t parent_index, std::vector<Node>& children)
+		{
+			SuccessorSink sink{children, parent_index};
+			children.clear();
+			if (successor_cache)
+			{
+				expandCached(state, sink, children);
+			}
+			else
+			{
+				successors(state, sink);
+			}
+		}
+
+	private:
+
+		/*
+		Add the successors of a state to the sink from the successor cache, or call "successors" and add them to the
+		cache.  The cache locks only the shard of the state, and "successors" is called without a lock, so the threads
+		of a parallel search rarely wait for one another.
+		*/
+		void expandCached(const StateType& state, SuccessorSink& sink, const std::vector<Node>& children)
+		{
+			static thread_local typename SuccessorCacheType::SuccessorList list;  // Reused to avoid reallocation
+
+			auto addCached = [&sink](const typename SuccessorCacheType::Successor& successor) {
+				sink.add(successor.action, successor.state);
+			};
+
+			if (successor_cache->find(state, addCached))
+			{
+				return;
+			}
+
+			successors(state, sink);
+			list.clear();
+			for (const Node& child : children)
+			{
+				list.push_back(typename SuccessorCacheType::Successor{child.action, child.state});
+			}
+			successor_cache->insert(state, list);
+		}
+
+		/* Store an expanded node, and return its index. */
+		std::uint32_t addNode(std::uint32_t state_id, std::uint32_t parent_index, ActionsType action)
+		{
+			node_states.push_back(state_id);
+			node_parents.push_back(parent_index);
+			node_actions.push_back(action);
+			search_stats.nodesSize(node_states.size());
+			return (std::uint32_t)node_states.size() - 1;
+		}
+
+		bool recordsPath() const
+		{
+			return result_kind == ResultKind::path;
+		}
+
+		/* Record that the search found a solution with the given cost, whose goal node, if it kept one, is at "index." */
+		void recordGoal(std::uint32_t index, double cost)
+		{
+			solution_found = true;
+			goal_index = index;
+			solution_cost = cost;
+		}
+
+		/* Expand a node, and count its successors and the time taken to find them in "stats." */
+		void expandCounted(const StateType& state, std::uint32_t parent_index, std::vector<Node>& children, StatsType& stats)
+		{
+			typename StatsType::TimePoint start = StatsType::now();
+
+			expand(state, parent_index, children);
+			stats.generated(children.size(), start);
+		}
+
+		/* Call "progress" if the number of nodes expanded has passed a multiple of the interval since "before." */
+		void reportProgress(std::size_t before, std::size_t after)
+		{
+			if (StatsType::enabled && progress_interval != 0 && after / progress_interval != before / progress_interval)
+			{
+				search_stats.finish(search_start);
+				progress(search_stats);
+			}
+		}
+
+		/* Count a node expanded at the given depth. */
+		void countExpansion(std::uint32_t depth)
+		{
+			std::size_t expanded = search_stats.expanded(depth);
+			reportProgress(expanded - 1, expanded);
+		}
+
+		/* The budget of a search given no limits, which never runs out.  The compiler removes every call. */
+		struct NoSearchBudget
+		{
+			SearchStatus status{SearchStatus::not_found};
+
+			bool exhausted()
+			{
+				return false;
+			}
+
+			void expanded()
+			{
+			}
+		};
+
+		/* The budget of one call to a search given limits.  "status" is the limit that stopped it, if one did. */
+		struct SearchBudget
+		{
+			const SearchLimits& limits;
+			std::size_t expansions{0};
+			std::size_t next_clock_check{0};  // The number of expansions at which to read the clock next
+			SearchStatus status{SearchStatus::not_found};
+
+			explicit SearchBudget(const SearchLimits& the_limits) : limits(the_limits)
+			{
+			}
+
+			/* Return true if the search should stop before it expands another node. */
+			bool exhausted()
+			{
+				if (limits.cancellation != nullptr && limits.cancellation->isCancelled())
+				{
+					status = SearchStatus::cancelled;
+					return true;
+				}
+				if (expansions >= limits.max_expansions)
+				{
+					status = SearchStatus::budget_exhausted;
+					return true;
+				}
+				if (limits.deadline != SearchLimits::Clock::time_point::max() && expansions >= next_clock_check)
+				{
+					next_clock_check = expansions + SearchLimits::clock_interval;
+					if (SearchLimits::Clock::now() >= limits.deadline)
+					{
+						status = SearchStatus::deadline_passed;
+						return true;
+					}
+				}
+				return false;
+			}
+
+			void expanded()
+			{
+				++expansions;
+			}
+		};
+
+		/* Record the end of the search when the search returns or throws. */
+		struct SearchTimer
+		{
+			Problem& problem;
+
+			~SearchTimer()
+			{
+				problem.search_stats.finish(problem.search_start);
+			}
+		};
+
+		/*
+		One direction of a bidirectional search.  For each state reached, in order of their indexes in "table," it
+		records the index of the neighboring state it was reached from, the action between the two, and the number of
+		actions from the nearest root.  A root's action is "start_state."  "level" holds the indexes of the states to
+		expand next.
+		*/
+		struct SearchDirection
+		{
+			StateTableType table;
+			AllocatedVector<std::uint32_t> links;
+			AllocatedVector<ActionsType> link_actions;
+			AllocatedVector<std::uint32_t> depths;
+			AllocatedVector<std::uint32_t> level;
+
+			explicit SearchDirection(const AllocatorType& allocator)
+				: table(allocator), links(allocator), link_actions(allocator), depths(allocator), level(allocator)
+			{
+			}
+
+			void addRoot(const StateType& state)
+			{
+				if (table.intern(state) == links.size())
+				{
+					links.push_back((std::uint32_t)links.size());
+					link_actions.push_back(ActionsType::start_state);
+					depths.push_back(0);
+					level.push_back((std::uint32_t)links.size() - 1);
+				}
+			}
+		};
+
+		/*
+		Expand every state in the current level of one direction of a bidirectional search, forward with "successors"
+		or backward with "predecessors."  Whenever a state is new to this direction but the other direction has reached
+		it, it joins a path; keep the shortest such path in "best_length" and the two indexes of its meeting state.
+		*/
+		void expandDirection(SearchDirection& direction, const SearchDirection& other, bool forward,
+			std::uint32_t& best_length, std::uint32_t& direction_meeting, std::uint32_t& other_meeting)
+		{
+			AllocatedVector<std::uint32_t> next_level(allocator);
+			std::vector<Node> children;
+
+			for (std::uint32_t id : direction.level)
+			{
+				StateType state = direction.table[id];  // A copy, because interning children can move the states.
+
+				countExpansion(direction.depths[id]);
+				if (forward)
+				{
+					expandCounted(state, id, children, search_stats);
+				}
+				else
+				{
+					typename StatsType::TimePoint start = StatsType::now();
+					SuccessorSink sink{children, id};
+					children.clear();
+					predecessors(state, sink);
+					search_stats.generated(children.size(), start);
+				}
+
+				for (const Node& child : children)
+				{
+					std::uint32_t child_id = direction.table.intern(child.state);
+					if (child_id < direction.links.size())
+					{
+						search_stats.duplicate();
+						continue;  // This direction has already reached the state.
+					}
+					direction.links.push_back(id);
+					direction.link_actions.push_back(child.action);
+					direction.depths.push_back(direction.depths[id] + 1);
+					next_level.push_back(child_id);
+
+					std::uint32_t other_id = other.table.find(child.state);
+					if (other_id != StateTableType::not_found && direction.depths[child_id] + other.depths[other_id] < best_length)
+					{
+						best_length = direction.depths[child_id] + other.depths[other_id];
+						direction_meeting = child_id;
+						other_meeting = other_id;
+					}
+				}
+			}
+			direction.level.swap(next_level);
+		}
+
+		/*
+		The states and successors of a batched breadth-first search, by state index in "Problem::states."  The
+		successors of state i are successors[begin[i]] to successors[end[i] - 1], once it has been expanded.  "seen,"
+		"current," "next," and "goals" hold one bit per query of the current group:  the queries that have reached each
+		state, those that reached it at the current depth, those that reach it at the next, and those whose goal it is.
+		"level" and "next_level" hold the states with bits in "current" and "next."
+		*/
+		struct BatchCache
+		{
+			AllocatedVector<std::uint32_t> begin;
+			AllocatedVector<std::uint32_t> end;
+			AllocatedVector<std::uint32_t> successors;
+			AllocatedVector<std::uint64_t> seen;
+			AllocatedVector<std::uint64_t> current;
+			AllocatedVector<std::uint64_t> next;
+			AllocatedVector<std::uint64_t> goals;
+			AllocatedVector<std::uint32_t> level;
+			AllocatedVector<std::uint32_t> next_level;
+
+			explicit BatchCache(const AllocatorType& allocator)
+				: begin(allocator), end(allocator), successors(allocator), seen(allocator), current(allocator),
+				next(allocator), goals(allocator), level(allocator), next_level(allocator)
+			{
+			}
+
+			std::size_t size() const
+			{
+				return begin.size();
+			}
+
+			/* Return the index of a state, and make room for it if it is new. */
+			std::uint32_t intern(StateTableType& table, const StateType& state)
+			{
+				std::uint32_t id = table.intern(state);
+				if (id == begin.size())
+				{
+					begin.push_back(UINT32_MAX);
+					end.push_back(UINT32_MAX);
+					seen.push_back(0);
+					current.push_back(0);
+					next.push_back(0);
+					goals.push_back(0);
+				}
+				return id;
+			}
+
+			bool isExpanded(std::uint32_t id) const
+			{
+				return begin[id] != UINT32_MAX;
+			}
+
+			/* Forget the queries of the last group. */
+			void startGroup()
+			{
+				std::fill(seen.begin(), seen.end(), 0);
+				for (std::uint32_t id : level)
+				{
+					current[id] = 0;
+				}
+				level.clear();
+			}
+
+			/* Record that the queries with the given bits reach a state at the next depth, unless they already have. */
+			void reach(std::uint32_t id, std::uint64_t bits)
+			{
+				std::uint64_t fresh = bits & ~seen[id] & ~next[id];
+				if (fresh != 0)
+				{
+					if (next[id] == 0)
+					{
+						next_level.push_back(id);
+					}
+					next[id] |= fresh;
+				}
+			}
+
+			/* Make the next depth the current one. */
+			void advance()
+			{
+				for (std::uint32_t id : level)
+				{
+					current[id] = 0;
+				}
+				for (std::uint32_t id : next_level)
+				{
+					current[id] = next[id];
+					seen[id] |= next[id];
+					next[id] = 0;
+				}
+				level.swap(next_level);
+				next_level.clear();
+			}
+		};
+
+		/* Expand a state of a batched search, and store the indexes of its successors in the cache. */
+		void cacheSuccessors(BatchCache& cache, std::uint32_t id)
+		{
+			std::vector<Node>& children = context.children;
+			StateType state = states[id];  // A copy, because interning children can move the states.
+
+			expandCounted(state, id, children, search_stats);
+			cache.begin[id] = (std::uint32_t)cache.successors.size();
+			for (const Node& child : children)
+			{
+				cache.successors.push_back(cache.intern(states, child.state));
+			}
+			cache.end[id] = (std::uint32_t)cache.successors.size();
+		}
+
+		/* Return the index of the lowest set bit of a nonzero mask. */
+		static unsigned lowestBit(std::uint64_t bits)
+		{
+#if defined(__GNUC__)
+			return (unsigned)__builtin_ctzll(bits);
+#else
+			unsigned index = 0;
+			while ((bits & 1) == 0)
+			{
+				bits >>= 1;
+				++index;
+			}
+			return index;
+#endif
+		}
+
+#ifdef GRAPHSEARCH_EXTERNAL_MEMORY
+		/*
+		An external-memory breadth-first search writes each level to a file of these records, sorted by state.  A
+		record's parent is the index of the parent's record in the previous level's file.
+		*/
+		struct LevelRecord
+		{
+			StateType state;
+			std::uint64_t parent;
+			ActionsType action;
+		};
+
+		static bool recordLess(const LevelRecord& a, const LevelRecord& b)
+		{
+			return bytesLess(a.state, b.state);
+		}
+
+		/* A file of visited states, sorted by bytesLess, mapped into memory for as long as the file lasts. */
+		struct VisitedSegment
+		{
+			std::string file;
+			std::unique_ptr<MappedRecords<StateType>> states;
+
+			explicit VisitedSegment(const std::string& the_file)
+				: file{the_file}, states{new MappedRecords<StateType>{the_file}}
+			{
+			}
+		};
+
+		/* Sort a run of successors by state, and keep one record per state. */
+		void sortRun(std::vector<LevelRecord>& run)
+		{
+			std::size_t unique = 0;
+
+			std::sort(run.begin(), run.end(), recordLess);
+			for (std::size_t i = 0; i < run.size(); ++i)
+			{
+				if (unique > 0 && bytesEqual(run[i].state, run[unique - 1].state))
+				{
+					search_stats.duplicate();
+				}
+				else
+				{
+					run[unique++] = run[i];
+				}
+			}
+			run.resize(unique);
+		}
+
+		/* Sort a run of successors, write it to a new file, and empty it. */
+		void writeRun(TemporaryDirectory& files, std::vector<LevelRecord>& run, std::vector<std::string>& runs)
+		{
+			sortRun(run);
+			runs.push_back(files.newFile());
+			RecordWriter<LevelRecord> writer{runs.back(), 0};
+			writer.add(run.data(), run.size());
+			writer.close();
+			run.clear();
+		}
+
+		/*
+		Merge the runs of successors of the last level into the next level:  keep one record per state, and drop the
+		states already visited.  The runs are files, or if all of the successors fit in memory, the sorted run "run."
+		Remove and empty the runs.  Stop early at a goal state, and return its index in the next level,
+		or UINT64_MAX if there is none.
+
+		The visited states are kept in segments, files of states sorted by bytesLess, each at least twice as large as
+		the next.  A successor is looked up in each segment with seekSorted, and the states of the next level are added
+		as a new segment, which is merged with the segments before it until each is at least twice as large as the
+		next again.  That way each state is copied only a logarithmic number of times.
+		*/
+		std::uint64_t mergeLevel(TemporaryDirectory& files, std::vector<LevelRecord>& run, std::vector<std::string>& runs,
+			std::vector<std::string>& levels, std::vector<VisitedSegment>& visited, const StateSet& goal_states)
+		{
+			std::uint64_t goal_index = UINT64_MAX;
+			std::string level_file = files.newFile();
+			std::string segment_file = files.newFile();
+			{
+				std::vector<std::size_t> positions(visited.size(), 0);  // The position in each segment of the last lookup
+				RecordWriter<LevelRecord> level{level_file};
+				RecordWriter<StateType> segment{segment_file};
+				const LevelRecord* last = nullptr;
+
+				auto add = [&](const LevelRecord& record) {
+					if (last != nullptr && bytesEqual(record.state, last->state))
+					{
+						search_stats.duplicate();
+						return true;
+					}
+					last = &record;
+					for (std::size_t i = 0; i < visited.size(); ++i)
+					{
+						const MappedRecords<StateType>& states = *visited[i].states;
+						positions[i] = seekSorted(states, positions[i], record.state);
+						if (positions[i] < states.size() && bytesEqual(states[positions[i]], record.state))
+						{
+							search_stats.duplicate();
+							return true;
+						}
+					}
+					segment.add(record.state);
+					if (goal_states.count(record.state) == 1)
+					{
+						goal_index = level.size();
+					}
+					level.add(record);
+					return goal_index == UINT64_MAX;
+				};
+
+				if (runs.empty())
+				{
+					for (std::size_t i = 0; i < run.size() && add(run[i]); ++i)
+					{
+					}
+				}
+				else
+				{
+					mergeFiles<LevelRecord>(runs, recordLess, add);
+				}
+				level.close();
+				segment.close();
+			}
+			for (const std::string& run : runs)
+			{
+				files.remove(run);
+			}
+			runs.clear();
+			run.clear();
+			levels.push_back(level_file);
+			visited.emplace_back(segment_file);
+
+			// Merge the newest segments until each is at least twice as large as the next.
+			while (visited.size() >= 2 && visited[visited.size() - 2].states->size() < 2 * visited.back().states->size())
+			{
+				std::vector<std::string> pair{visited[visited.size() - 2].file, visited.back().file};
+				std::string merged_file = files.newFile();
+				{
+					RecordWriter<StateType> merged{merged_file};
+					mergeFiles<StateType>(pair, bytesLess<StateType>, [&merged](const StateType& state) {
+						merged.add(state);
+						return true;
+					});
+					merged.close();
+				}
+				visited.pop_back();
+				visited.pop_back();
+				files.remove(pair[0]);
+				files.remove(pair[1]);
+				visited.emplace_back(merged_file);
+			}
+			return goal_index;
+		}
+#endif
+
+		/*
+		A parallel breadth-first search records each node it generates as the index of the parent node in the previous
+		level and the action that leads from the parent's state to the node's state.  It keeps the states of the
+		current level only; "recordSolution" recovers the states on the solution path by repeating its actions.
+		*/
+		struct LevelEntry
+		{
+			std::uint32_t parent_index;
+			ActionsType action;
+		};
+
+		// One thread's share of the next level in a parallel breadth-first search
+		struct LevelOutput
+		{
+			std::vector<StateType> states;
+			std::vector<LevelEntry> entries;
+			StatsType stats;
+			std::exception_ptr error;
+		};
+
+		static const std::size_t level_chunk_size = 256;  // The number of nodes a thread claims at once
+		static const std::size_t no_goal = SIZE_MAX;
+
+		/*
+		Expand nodes of the current level, claiming chunks of "level_chunk_size" nodes until none remain, and add the
+		successors no thread has seen before to "output."  If a node's state is a goal, lower "goal_index" to its index,
+		and stop claiming chunks.  Nodes before the goal are all claimed by then, so "goal_index" ends up the index of
+		the first goal in the level.  Count the nodes at the given depth in the output's statistics.
+		*/
+		void expandLevel(const std::vector<StateType>& level, std::uint32_t depth, const StateSet& goal_states,
+			ConcurrentStateSet<StateType, StateHashType>& visited, std::atomic<std::size_t>& next_chunk,
+			std::atomic<std::size_t>& goal_index, std::atomic<bool>& stop, LevelOutput& output)
+		{
+			std::vector<Node> children;
+
+			try
+			{
+				while (!stop.load())
+				{
+					std::size_t begin = next_chunk.fetch_add(level_chunk_size);
+					std::size_t end = std::min(begin + level_chunk_size, level.size());
+
+					for (std::size_t i = begin; i < end; ++i)
+					{
+						if (goal_states.count(level[i]) == 1)
+						{
+							std::size_t lowest = goal_index.load();
+							while (i < lowest && !goal_index.compare_exchange_weak(lowest, i))
+							{
+							}
+							stop.store(true);
+							break;
+						}
+
+						output.stats.expanded(depth);
+						expandCounted(level[i], (std::uint32_t)i, children, output.stats);
+						for (const Node& child : children)
+						{
+							if (visited.insert(child.state))
+							{
+								output.states.push_back(child.state);
+								if (recordsPath())
+								{
+									output.entries.push_back(LevelEntry{child.parent_index, child.action});
+								}
+							}
+							else
+							{
+								output.stats.duplicate();
+							}
+						}
+					}
+					if (end == level.size())
+					{
+						break;
+					}
+				}
+			}
+			catch (...)
+			{
+				output.error = std::current_exception();
+				stop.store(true);
+			}
+		}
+
+		/*
+		A parallel depth-first search records each node it expands in the vector of the thread that expanded it.  A
+		node refers to its parent by the parent's thread number (in the high 32 bits) and its index in that thread's
+		vector (in the low 32 bits).  The frontier holds the state and depth of each node as well.  (The depth, which is
+		only for statistics, fits in what would otherwise be padding after the action.)
+		*/
+		struct TraversalEntry
+		{
+			std::uint64_t parent_ref;
+			ActionsType action;
+		};
+
+		struct TraversalNode
+		{
+			StateType state;
+			std::uint64_t parent_ref;
+			ActionsType action;
+			std::uint32_t depth;
+		};
+
+		// One thread of a parallel depth-first search
+		struct TraversalWorker
+		{
+			WorkStealingFrontier<TraversalNode> frontier;
+			std::vector<TraversalEntry> entries;
+			StatsType stats;
+			std::exception_ptr error;
+		};
+
+		/*
+		The shared state of a parallel depth-first search.  "pending" counts the nodes that have been added to a frontier
+		but not yet expanded, including nodes being expanded.  The search is over when it reaches 0.
+		*/
+		struct Traversal
+		{
+			const StateSet& goal_states;
+			ConcurrentStateSet<StateType, StateHashType> visited;
+			std::vector<TraversalWorker> workers;
+			std::atomic<std::size_t> pending{0};
+			std::atomic<std::uint64_t> goal_ref{UINT64_MAX};
+			std::uint32_t goal_depth{0};  // Written only by the worker that sets goal_ref
+			std::atomic<bool> stop{false};
+
+			Traversal(const StateSet& the_goal_states, unsigned num_threads)
+				: goal_states(the_goal_states), visited{num_threads}, workers(num_threads)
+			{
+			}
+		};
+
+		/*
+		Expand nodes from this worker's frontier, or stolen from the other workers' frontiers, until every frontier is
+		empty or some worker finds a goal.  Add each successor no worker has seen before to this worker's frontier.
+		*/
+		void traverse(Traversal& traversal, std::size_t worker_index)
+		{
+			TraversalWorker& worker = traversal.workers[worker_index];
+			TraversalNode current_node;
+			std::vector<Node> children;
+
+			try
+			{
+				while (!traversal.stop.load())
+				{
+					bool found_node = worker.frontier.take(current_node);
+
+					for (std::size_t i = 1; !found_node && i < traversal.workers.size(); ++i)
+					{
+						found_node = traversal.workers[(worker_index + i) % traversal.workers.size()].frontier.steal(current_node);
+					}
+					if (!found_node)
+					{
+						if (traversal.pending.load() == 0)
+						{
+							break;  // Every reachable state has been expanded.
+						}
+						std::this_thread::yield();
+						continue;
+					}
+
+					std::uint64_t current_ref = (std::uint64_t)worker_index << 32 | worker.entries.size();
+					if (recordsPath())
+					{
+						worker.entries.push_back(TraversalEntry{current_node.parent_ref, current_node.action});
+					}
+
+					if (traversal.goal_states.count(current_node.state) == 1)
+					{
+						std::uint64_t no_goal_ref = UINT64_MAX;
+						if (traversal.goal_ref.compare_exchange_strong(no_goal_ref, current_ref))
+						{
+							traversal.goal_depth = current_node.depth;
+						}
+						traversal.stop.store(true);
+						break;
+					}
+
+					worker.stats.expanded(current_node.depth);
+					expandCounted(current_node.state, 0, children, worker.stats);
+					for (const Node& child : children)
+					{
+						if (traversal.visited.insert(child.state))
+						{
+							++traversal.pending;
+							worker.frontier.add(TraversalNode{child.state, current_ref, child.action, current_node.depth + 1});
+						}
+						else
+						{
+							worker.stats.duplicate();
+						}
+					}
+					if (StatsType::enabled)
+					{
+						worker.stats.frontierSize(traversal.pending.load());
+					}
+					--traversal.pending;  // Only after adding the children, so that "pending" is never 0 too soon.
+				}
+			}
+			catch (...)
+			{
+				worker.error = std::current_exception();
+				traversal.stop.store(true);
+			}
+		}
+
+		/*
+		Populate the node vectors with the path from the initial state that takes the given actions, so that "solution"
+		and "path" work as they do after the other searches.  Repeat the actions from the initial state to get the
+		states.
+		*/
+		void recordSolution(StateType initial_state, const SolutionVector& the_actions)
+		{
+			std::vector<Node> children;
+			StateType state = initial_state;
+
+			addNode(states.intern(state), 0, ActionsType::start_state);
+			for (ActionsType the_action : the_actions)
+			{
+				expand(state, (std::uint32_t)node_states.size() - 1, children);
+				for (const Node& child : children)
+				{
+					if (child.action == the_action)
+					{
+						state = child.state;
+						break;
+					}
+				}
+				addNode(states.intern(state), (std::uint32_t)node_states.size() - 1, the_action);
+			}
+		}
+
+		/*
+		Hash the states of a batch of nodes for the state table, and prefetch their places in the table, before the
+		search looks any of them up.
+		*/
+		void hashStates(const std::vector<Node>& batch, std::vector<std::size_t>& hashes) const
+		{
+			hashes.clear();
+			for (const Node& node : batch)
+			{
+				hashes.push_back(states.hash(node.state));
+				states.prefetch(hashes.back());
+			}
+		}
+
+		/* Clear the solution and statistics of the last search, and start timing a new one. */
+		void clearResult()
+		{
+			solution_found = false;
+			node_states.clear();
+			node_parents.clear();
+			node_actions.clear();
+			search_stats.clear();
+			search_start = StatsType::now();
+		}
+
+		/* Clear remnants of prior searches, and start timing a new one. */
+		void clearSearch()
+		{
+			clearResult();
+			stopped_search = StoppedSearch::none;
+			incremental.active = false;
+			states.clear();
+			context.clear();
+		}
+
+		/* The goal test of a search given a set of goal states */
+		struct GoalSet
+		{
+			const StateSet& goal_states;
+
+			bool operator()(const StateType& state) const
+			{
+				return goal_states.count(state) == 1;
+			}
+		};
+
+		/* The goal test of a search without a set of goal states, which calls isGoal */
+		struct GoalPredicate
+		{
+			const Problem& problem;
+
+			bool operator()(const StateType& state) const
+			{
+				return problem.isGoal(state);
+			}
+		};
+
+		/* Start a best-first search by putting the initial state on the frontier. */
+		void startBestFirst(StateType initial_state, bool use_heuristic)
+		{
+			CostNode initial_node{Node{initial_state, 0, ActionsType::start_state}};
+
+			initial_node.estimated_cost = use_heuristic ? heuristic(initial_state) : 0.0;
+			context.best_first.push(states.intern(initial_state), initial_node);
+			search_stats.frontierSize(context.best_first.size());
+			context.best_costs.push_back(0.0);
+		}
+
+		/*
+		Expand the nodes of a best-first search, started by startBestFirst, until it finds a goal, the frontier is
+		empty, or the budget runs out.  BudgetType is NoSearchBudget or SearchBudget.  The search stops only before it
+		takes a node off the frontier, so a stopped search can be continued by calling this again.
+		*/
+		template <typename GoalTest, typename BudgetType>
+		SearchStatus continueBestFirst(const GoalTest& is_goal, bool use_heuristic, BudgetType& budget)
+		{
+			IndexedPriorityFrontier<CostNode, NodeCostComparison, CostNodeAllocator>& frontier = context.best_first;
+			CostNode current_node;
+			std::uint32_t current_id;
+			std::uint32_t current_index;
+			AllocatedVector<double>& best_costs = context.best_costs;  // The cheapest known path cost to each state in "states," by index
+			std::vector<Node>& children = context.children;  // For a given state, these are the states that can be reached with the available actions.
+			std::vector<std::size_t>& hashes = context.hashes;  // The hash of each child's state
+
+			while (!frontier.isEmpty())
+			{
+				if (budget.exhausted())
+				{
+					return budget.status;
+				}
+				current_node = frontier.next();
+				current_id = frontier.nextKey();
+				frontier.pop();
+
+				current_index = recordsPath() ? addNode(current_id, current_node.parent_index, current_node.action) : 0;
+
+				if (is_goal(current_node.state))
+				{
+					// Found a goal state.
+					recordGoal(current_index, current_node.path_cost);
+					return SearchStatus::found;
+				}
+
+				// Push successors onto the frontier unless a path to them at least as cheap is already known.
+				countExpansion(current_node.depth);
+				budget.expanded();
+				expandCounted(current_node.state, current_index, children, search_stats);
+				hashStates(children, hashes);
+				for (std::size_t i = 0; i < children.size(); ++i)
+				{
+					CostNode successor{children[i]};
+					std::uint32_t successor_id = states.intern(successor.state, hashes[i]);
+
+					successor.path_cost = current_node.path_cost + stepCost(current_node.state, successor.action, successor.state);
+					if (successor_id == best_costs.size())
+					{
+						best_costs.push_back(successor.path_cost);  // This successor was just added to "states."
+					}
+					else if (successor.path_cost < best_costs[successor_id])
+					{
+						best_costs[successor_id] = successor.path_cost;
+					}
+					else
+					{
+						search_stats.duplicate();
+						continue;
+					}
+
+					successor.depth = current_node.depth + 1;
+					successor.estimated_cost = successor.path_cost;
+					if (use_heuristic)
+					{
+						successor.estimated_cost += heuristic(successor.state);
+					}
+					frontier.push(successor_id, successor);
+				}
+				search_stats.frontierSize(frontier.size());
+				children.clear();  // Prepare for next iteration.
+			}
+
+			// The frontier is empty, and we didn't reach a goal node.
+			return SearchStatus::not_found;
+		}
+
+		/*
+		Perform a best-first search ordered by path cost, plus the heuristic estimate if use_heuristic is true.  The
+		frontier is indexed by state, so each state has at most one node on it:  when the search finds a cheaper path to
+		a state on the frontier, it replaces the state's node and moves it up, and when it finds a cheaper path to a
+		state already expanded, which an inconsistent heuristic allows, it puts the state back on the frontier.
+		GoalTest is GoalSet or GoalPredicate.  A goal is recognized when its node reaches the front, since a cheaper
+		path to it may still be found before then.
+		*/
+		template <typename GoalTest>
+		bool searchBestFirst(StateType initial_state, const GoalTest& is_goal, bool use_heuristic)
+		{
+			NoSearchBudget budget;
+
+			clearSearch();
+			SearchTimer timer{*this};
+			startBestFirst(initial_state, use_heuristic);
+			return continueBestFirst(is_goal, use_heuristic, budget) == SearchStatus::found;
+		}
+
+		/*
+		An iterative-deepening search keeps one frame for each node on the current path:  the node's state, the action
+		that reached it, its path cost, and its children, of which the first "next_child" have been tried.  Frames
+		deeper than the current path keep their children's capacity for the next time the path gets that deep.
+		*/
+		struct DepthFrame
+		{
+			StateType state;
+			ActionsType action;
+			double path_cost;
+			std::vector<Node> children;
+			std::size_t next_child;
+		};
+
+		/* Return true if the given state is the state of one of the first "depth" frames. */
+		static bool onPath(const std::vector<DepthFrame>& frames, std::size_t depth, const StateType& state)
+		{
+			for (std::size_t i = 0; i < depth; ++i)
+			{
+				if (frames[i].state == state)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/*
+		The buffers the serial searches use besides "states" and the node vectors.  The problem keeps them from one
+		search to the next, with their memory, so that a problem answering many small queries doesn't allocate once its
+		buffers have grown to fit them.  The parallel searches and the bidirectional search allocate their own.  The
+		buffers that grow with the search come from the problem's allocator; the others hold one node's children.
+		*/
+		struct SearchContext
+		{
+			DepthFirstFrontier<Node, NodeAllocator> depth_first;
+			BreadthFirstFrontier<Node, NodeAllocator> breadth_first;
+			IndexedPriorityFrontier<CostNode, NodeCostComparison, CostNodeAllocator> best_first;
+			std::vector<Node> children;
+			std::vector<std::size_t> hashes;
+			AllocatedVector<double> best_costs;
+			std::size_t frontier_size{0};  // The nodes on the frontier of searchFrontier, for statistics
+			std::vector<DepthFrame> frames;
+			StateTableType transpositions;
+			AllocatedVector<double> transposition_costs;
+
+			explicit SearchContext(const AllocatorType& allocator)
+				: depth_first(allocator), breadth_first(allocator), best_first(allocator), best_costs(allocator),
+				transpositions(allocator), transposition_costs(allocator)
+			{
+			}
+
+			void clear()
+			{
+				depth_first.clear();
+				breadth_first.clear();
+				best_first.clear();
+				children.clear();
+				best_costs.clear();
+				frontier_size = 0;
+				transpositions.clear();
+				transposition_costs.clear();
+			}
+		};
+
+		SearchContext context;
+
+		/* The priority of a state in an incremental search:  the lesser of its g and rhs, plus the heuristic, then without it */
+		struct IncrementalKey
+		{
+			double estimated_cost;
+			double path_cost;
+		};
+
+		/* Order keys for the frontier of an incremental search so that the lowest key is next. */
+		struct IncrementalKeyComparison
+		{
+			bool operator()(const IncrementalKey& a, const IncrementalKey& b) const
+			{
+				if (a.estimated_cost == b.estimated_cost)
+				{
+					return a.path_cost > b.path_cost;
+				}
+				return a.estimated_cost > b.estimated_cost;
+			}
+		};
+
+		typedef typename std::allocator_traits<AllocatorType>::template rebind_alloc<IncrementalKey> IncrementalKeyAllocator;
+
+		/*
+		What an incremental search keeps from one plan to the next, besides "states":  for each state, by index, g, its
+		path cost when it was last expanded, and rhs, the least path cost through one of its predecessors given their
+		g.  A state whose g and rhs differ is on the frontier.  "active" is false once another search has cleared the
+		states.
+		*/
+		struct IncrementalSearch
+		{
+			bool active{false};
+			StateType initial_state;
+			std::uint32_t goal_id;
+			AllocatedVector<double> g;
+			AllocatedVector<double> rhs;
+			IndexedPriorityFrontier<IncrementalKey, IncrementalKeyComparison, IncrementalKeyAllocator> frontier;
+			std::vector<Node> parents;  // The predecessors of one state
+
+			explicit IncrementalSearch(const AllocatorType& allocator)
+				: g(allocator), rhs(allocator), frontier(IncrementalKeyAllocator(allocator))
+			{
+			}
+		};
+
+		IncrementalSearch incremental;
+
+		/*
+		Perform a series of depth-first searches, each limited to nodes whose cost is within a bound, raising the bound
+		after each to the least cost that exceeded it, until a search finds a goal or the bound exceeds max_cost.  The
+		cost of a node is its depth, or, if use_heuristic is true, its path cost plus the heuristic estimate.
+
+		Only the current path is kept, and a node whose state is already on the path is skipped, so memory grows with
+		the depth rather than with the number of states.  If transposition_limit is not zero, up to that many states are
+		also kept, each with the cheapest path cost at which the current search has reached it; reaching one again at no
+		less cost is skipped.  For statistics, the nodes are the frames on the path, the frontier is their untried
+		children, and skipped children are duplicates.
+		*/
+		bool searchIterative(StateType initial_state, const StateSet& goal_states, double max_cost, bool use_heuristic,
+			std::size_t transposition_limit)
+		{
+			std::vector<DepthFrame>& frames = context.frames;
+			StateTableType& transpositions = context.transpositions;
+			AllocatedVector<double>& transposition_costs = context.transposition_costs;  // The cheapest path cost to each state in "transpositions," by index
+			double bound = use_heuristic ? heuristic(initial_state) : 0.0;
+			std::size_t untried = 0;  // The children on the path not yet tried, for statistics
+
+			clearSearch();
+			SearchTimer timer{*this};
+			if (frames.empty())
+			{
+				frames.emplace_back();
+			}
+
+			while (bound <= max_cost)
+			{
+				double next_bound = std::numeric_limits<double>::infinity();
+				std::size_t depth = 1;  // The number of frames on the current path
+				bool entered = true;    // Has the deepest frame just been added to the path?
+
+				frames[0].state = initial_state;
+				frames[0].action = ActionsType::start_state;
+				frames[0].path_cost = 0.0;
+				transpositions.clear();
+				transposition_costs.clear();
+
+				while (depth > 0)
+				{
+					DepthFrame& frame = frames[depth - 1];
+
+					if (entered)
+					{
+						entered = false;
+						if (goal_states.count(frame.state) == 1)
+						{
+							// Found a goal state.  The nodes on the current path are the solution.
+							for (std::size_t i = 0; recordsPath() && i < depth; ++i)
+							{
+								addNode(states.intern(frames[i].state), i == 0 ? 0 : (std::uint32_t)i - 1, frames[i].action);
+							}
+							recordGoal((std::uint32_t)depth - 1, frame.path_cost);
+							return true;
+						}
+						countExpansion((std::uint32_t)depth - 1);
+						expandCounted(frame.state, 0, frame.children, search_stats);
+						frame.next_child = 0;
+						untried += frame.children.size();
+						search_stats.frontierSize(untried);
+						search_stats.nodesSize(depth);
+					}
+
+					if (frame.next_child == frame.children.size())
+					{
+						--depth;  // Every child has been tried.  Backtrack.
+						continue;
+					}
+
+					const Node& child = frame.children[frame.next_child++];
+					--untried;
+					double path_cost = frame.path_cost + (use_heuristic ? stepCost(frame.state, child.action, child.state) : 1.0);
+					double cost = path_cost + (use_heuristic ? heuristic(child.state) : 0.0);
+
+					if (cost > bound)
+					{
+						next_bound = std::min(next_bound, cost);
+						continue;
+					}
+					if (onPath(frames, depth, child.state))
+					{
+						search_stats.duplicate();
+						continue;
+					}
+					if (transposition_limit > 0)
+					{
+						std::uint32_t id = transpositions.find(child.state);
+						if (id == StateTableType::not_found && transpositions.size() < transposition_limit)
+						{
+							transpositions.intern(child.state);
+							transposition_costs.push_back(path_cost);
+						}
+						else if (id != StateTableType::not_found)
+						{
+							if (path_cost >= transposition_costs[id])
+							{
+								search_stats.duplicate();
+								continue;
+							}
+							transposition_costs[id] = path_cost;
+						}
+					}
+
+					// Descend to the child.  Adding a frame can move the others, so refer to them by index from here.
+					std::size_t child_index = frame.next_child - 1;
+					if (depth == frames.size())
+					{
+						frames.emplace_back();
+					}
+					frames[depth].state = frames[depth - 1].children[child_index].state;
+					frames[depth].action = frames[depth - 1].children[child_index].action;
+					frames[depth].path_cost = path_cost;
+					++depth;
+					entered = true;
+				}
+
+				if (next_bound == std::numeric_limits<double>::infinity())
+				{
+					break;  // Nothing was cut off, so no greater bound would reach anything more.
+				}
+				bound = next_bound;
+			}
+
+			// The bound exceeds max_cost, or every reachable path has been tried, and we didn't reach a goal node.
+			return false;
+		}
+
+		/*
+		Start a search of searchFrontier by pushing a node for each initial state onto the frontier, which is a container
+		for unexplored nodes.  Test the initial states first if the others are tested when they are generated, and
+		return true if one is a goal.
+		*/
+		template <typename FrontierType, typename GoalTest>
+		bool startFrontier(const StateType* initial_states, std::size_t num_initial_states, const GoalTest& is_goal,
+			FrontierType& frontier, bool goal_on_generation)
+		{
+			bool mark_on_generation = state_marking == StateMarking::on_generation;
+
+			for (std::size_t i = 0; i < num_initial_states; ++i)
+			{
+				if (goal_on_generation && is_goal(initial_states[i]))
+				{
+					recordGoal(recordsPath() ? addNode(states.intern(initial_states[i]), 0, ActionsType::start_state) : 0, 0.0);
+					return true;
+				}
+				std::size_t states_before = states.size();
+				if (!mark_on_generation || states.intern(initial_states[i]) == states_before)
+				{
+					frontier.add(Node{initial_states[i], 0, ActionsType::start_state});
+					++context.frontier_size;
+				}
+			}
+			search_stats.frontierSize(context.frontier_size);
+			return false;
+		}
+
+		/*
+		Expand the nodes of a search started by startFrontier until it finds a goal, the frontier is empty, or the
+		budget runs out.  BudgetType is NoSearchBudget or SearchBudget.  The search stops only before it takes a node
+		off the frontier, so a stopped search can be continued by calling this again.
+		*/
+		template <typename FrontierType, typename GoalTest, typename BudgetType>
+		SearchStatus continueFrontier(const GoalTest& is_goal, FrontierType& frontier, bool goal_on_generation,
+			BudgetType& budget)
+		{
+			Node current_node;
+			std::uint32_t current_index;
+			std::vector<Node>& children = context.children;  // For a given state, these are the states that can be reached with the available actions.
+			std::vector<std::size_t>& hashes = context.hashes;  // The hash of each child's state
+			std::size_t frontier_size = context.frontier_size;  // For statistics
+			bool mark_on_generation = state_marking == StateMarking::on_generation;
+
+			// Expand nodes until the frontier is empty or until a goal state is found (whichever is sooner).
+			while (!frontier.isEmpty())
+			{
+				if (budget.exhausted())
+				{
+					context.frontier_size = frontier_size;
+					return budget.status;
+				}
+				current_node = frontier.next();  // References the next node on the frontier.
+
+				// Remember the current node, if the search keeps its path.  Mark its state, unless it was marked when
+				// it was generated, and skip it if another node of its state was expanded first.
+				std::uint32_t current_id;
+				if (mark_on_generation)
+				{
+					current_id = states.find(current_node.state);
+				}
+				else
+				{
+					std::size_t states_before = states.size();
+					current_id = states.intern(current_node.state);
+					if (current_id != states_before)
+					{
+						search_stats.duplicate();
+						frontier.pop();
+						--frontier_size;
+						continue;
+					}
+				}
+				current_index = recordsPath() ? addNode(current_id, current_node.parent_index, current_node.action) : 0;
+
+				if (!goal_on_generation && is_goal(current_node.state))
+				{
+					// Found a goal state.
+					recordGoal(current_index, current_node.depth);
+					return SearchStatus::found;
+				}
+
+				// The current node is not a goal.  Find its successors/children, and remove it from the frontier.
+				countExpansion(current_node.depth);
+				budget.expanded();
+				expandCounted(current_node.state, current_index, children, search_stats);
+				frontier.pop();  // Pops the current node, and returns void.  Do this before pushing successors.
+				--frontier_size;
+
+				// Push unseen successors onto the frontier.
+				hashStates(children, hashes);
+				for (std::size_t i = 0; i < children.size(); ++i)
+				{
+					bool unseen;
+					if (mark_on_generation)
+					{
+						std::size_t states_before = states.size();
+						unseen = states.intern(children[i].state, hashes[i]) == states_before;
+					}
+					else
+					{
+						unseen = states.find(children[i].state, hashes[i]) == StateTableType::not_found;
+					}
+					if (unseen)
+					{
+						children[i].depth = current_node.depth + 1;
+						if (goal_on_generation && is_goal(children[i].state))
+						{
+							// Found a goal state.  Keep its node, without adding it to the frontier.
+							std::uint32_t goal_id = states.intern(children[i].state, hashes[i]);
+							recordGoal(recordsPath() ? addNode(goal_id, current_index, children[i].action) : 0,
+								children[i].depth);
+							return SearchStatus::found;
+						}
+						frontier.add(children[i]);
+						++frontier_size;
+					}
+					else
+					{
+						search_stats.duplicate();
+					}
+				}
+				search_stats.frontierSize(frontier_size);
+				children.clear();  // Prepare for next iteration.
+			}
+
+			// The frontier is empty, and we didn't reach a goal node.
+			return SearchStatus::not_found;
+		}
+
+		/*
+		Perform a graph search, as described for the public "search" methods.  FrontierType is either the abstract
+		Frontier class, in which case the frontier's methods are called virtually, or a final frontier class, in which
+		case they can be inlined.
+
+		The states in "states" are the states seen:  those generated so far, or with StateMarking::on_expansion, those
+		expanded so far.  Don't add them to the frontier again.  The search starts from "num_initial_states" initial
+		states at once, each a root of its own path.  GoalTest is GoalSet or GoalPredicate.
+
+		If goal_on_generation is true, the search tests each unexplored successor as it is generated, and stops at the
+		first goal, rather than when the goal's node leaves the frontier.  A breadth-first search finds the same goal
+		either way, but without generating the rest of the goal's level.  Other frontiers, such as a priority queue,
+		need the test when a node leaves the frontier.
+		*/
+		template <typename FrontierType, typename GoalTest>
+		bool searchFrontier(const StateType* initial_states, std::size_t num_initial_states, const GoalTest& is_goal,
+			FrontierType& frontier, bool goal_on_generation)
+		{
+			NoSearchBudget budget;
+
+			clearSearch();
+			SearchTimer timer{*this};
+			if (startFrontier(initial_states, num_initial_states, is_goal, frontier, goal_on_generation))
+			{
+				return true;
+			}
+			return continueFrontier(is_goal, frontier, goal_on_generation, budget) == SearchStatus::found;
+		}
+
+		/*
+		Perform a dense breadth-first search, as described for searchBreadthFirstDense.  GoalTest is GoalSet or
+		GoalPredicate.  Each new state is tested for a goal when it is generated.
+		*/
+		template <typename GoalTest>
+		bool searchDense(StateType initial_state, const GoalTest& is_goal, std::size_t num_states)
+		{
+			static_assert(std::is_integral<StateType>::value, "A dense breadth-first search needs integer states.");
+
+			std::vector<Node>& children = context.children;
+			Bitmap visited{num_states}, level_bits, next_bits;  // The bitmaps are allocated when a level is large.
+			std::vector<StateType> level{initial_state}, next_level;
+			std::vector<StateType> parents;  // The state each state was reached from, if the search records its path
+			std::size_t level_size = 1;
+			std::uint32_t depth = 0;
+			bool dense = false;  // Is the current level a bitmap?
+
+			clearSearch();
+			SearchTimer timer{*this};
+			if ((std::size_t)initial_state >= num_states)
+			{
+				throw "A dense breadth-first search has a state outside its states.";
+			}
+			if (recordsPath())
+			{
+				parents.resize(num_states);
+			}
+			visited.set((std::size_t)initial_state);
+			if (is_goal(initial_state))
+			{
+				recordGoal(recordsPath() ? addNode(states.intern(initial_state), 0, ActionsType::start_state) : 0, 0.0);
+				return true;
+			}
+
+			for (; level_size > 0; ++depth)
+			{
+				bool next_dense = level_size >= num_states / 64;  // Most successors of a large level make a large level.
+				bool found = false;
+				StateType goal{};
+				auto expandState = [&](StateType state) {
+					if (found)
+					{
+						return;
+					}
+					countExpansion(depth);
+					expandCounted(state, 0, children, search_stats);
+					for (const Node& child : children)
+					{
+						std::size_t id = (std::size_t)child.state;
+						if (id >= num_states)
+						{
+							throw "A dense breadth-first search has a state outside its states.";
+						}
+						if (next_dense && parents.empty())
+						{
+							next_bits.set(id);  // The states already visited are removed after the level.
+							if (!visited.test(id) && is_goal(child.state))
+							{
+								found = true;
+								goal = child.state;
+								break;
+							}
+							continue;
+						}
+						if (next_dense ? visited.test(id) || !next_bits.testAndSet(id) : !visited.testAndSet(id))
+						{
+							search_stats.duplicate();
+							continue;
+						}
+						if (!parents.empty())
+						{
+							parents[id] = state;
+						}
+						if (!next_dense)
+						{
+							next_level.push_back(child.state);
+						}
+						if (is_goal(child.state))
+						{
+							found = true;
+							goal = child.state;
+							break;
+						}
+					}
+					children.clear();
+				};
+
+				search_stats.frontierSize(level_size);
+				if (next_dense && next_bits.size() == 0)
+				{
+					next_bits = Bitmap{num_states};
+				}
+				if (dense)
+				{
+					level_bits.forEach([&](std::size_t id) { expandState((StateType)id); });
+				}
+				else
+				{
+					for (StateType state : level)
+					{
+						expandState(state);
+					}
+				}
+
+				if (found)
+				{
+					if (!recordsPath())
+					{
+						recordGoal(0, depth + 1);
+						return true;
+					}
+
+					// Walk the parents back to the initial state, and add the path to the node vectors.
+					std::vector<StateType> the_path{goal};
+					while (the_path.back() != initial_state)
+					{
+						the_path.push_back(parents[(std::size_t)the_path.back()]);
+					}
+					addNode(states.intern(initial_state), 0, ActionsType::start_state);
+					for (std::size_t i = the_path.size() - 1; i > 0; --i)
+					{
+						ActionsType the_action = ActionsType::start_state;
+						expand(the_path[i], (std::uint32_t)node_states.size() - 1, children);
+						for (const Node& child : children)
+						{
+							if (child.state == the_path[i - 1])
+							{
+								the_action = child.action;
+								break;
+							}
+						}
+						children.clear();
+						addNode(states.intern(the_path[i - 1]), (std::uint32_t)node_states.size() - 1, the_action);
+					}
+					recordGoal((std::uint32_t)node_states.size() - 1, depth + 1);
+					return true;
+				}
+
+				// Make the next level the current level.
+				if (next_dense)
+				{
+					level_size = next_bits.mergeInto(visited);
+					level_bits.swap(next_bits);
+					if (next_bits.size() == 0)
+					{
+						next_bits = Bitmap{num_states};
+					}
+					else
+					{
+						next_bits.clear();
+					}
+				}
+				else
+				{
+					level.swap(next_level);
+					next_level.clear();
+					level_size = level.size();
+				}
+				dense = next_dense;
+			}
+
+			// Every reachable state has been expanded, and none is a goal.
+			return false;
+		}
+
+		/*
+		Perform a beam search, as described for searchBeam.  GoalTest is GoalSet or GoalPredicate.  Each new state is
+		tested for a goal when it is generated.
+		*/
+		template <typename GoalTest>
+		bool searchBeamWidth(StateType initial_state, const GoalTest& is_goal, std::size_t beam_width)
+		{
+			std::vector<Node> level;  // The nodes of the current level
+			std::vector<CostNode> candidates;  // The new successors of the states of the level, with their estimates
+			std::vector<Node>& children = context.children;  // For a given state, these are the states that can be reached with the available actions.
+			std::vector<std::uint32_t> indexes, next_indexes;  // The index of each node of the level in the node vectors
+			std::vector<std::size_t> order;  // The candidates by index, in order of their heuristic estimates
+			std::uint32_t depth = 0;
+
+			if (beam_width == 0)
+			{
+				throw "A beam search needs a beam width of at least 1.";
+			}
+			clearSearch();
+			SearchTimer timer{*this};
+
+			std::uint32_t initial_index = recordsPath() ? addNode(states.intern(initial_state), 0, ActionsType::start_state) : 0;
+			if (is_goal(initial_state))
+			{
+				recordGoal(initial_index, 0.0);
+				return true;
+			}
+			states.intern(initial_state);
+			level.emplace_back(initial_state, 0, ActionsType::start_state);
+			indexes.push_back(initial_index);
+			search_stats.frontierSize(1);
+
+			while (!level.empty())
+			{
+				// Expand the level, and collect the successors the search hasn't reached, testing each for a goal.
+				candidates.clear();
+				for (std::size_t i = 0; i < level.size(); ++i)
+				{
+					countExpansion(depth);
+					expandCounted(level[i].state, indexes[i], children, search_stats);
+					for (Node& child : children)
+					{
+						if (states.find(child.state) != StateTableType::not_found)
+						{
+							search_stats.duplicate();
+							continue;
+						}
+						if (is_goal(child.state))
+						{
+							std::uint32_t goal_id = states.intern(child.state);
+							recordGoal(recordsPath() ? addNode(goal_id, indexes[i], child.action) : 0, depth + 1);
+							return true;
+						}
+						candidates.push_back(child);
+						candidates.back().estimated_cost = heuristic(child.state);
+					}
+				}
+
+				// Keep the beam_width distinct successors with the lowest estimates, in the order generated among equals.
+				order.resize(candidates.size());
+				for (std::size_t i = 0; i < order.size(); ++i)
+				{
+					order[i] = i;
+				}
+				std::sort(order.begin(), order.end(), [&candidates](std::size_t a, std::size_t b) {
+					return candidates[a].estimated_cost < candidates[b].estimated_cost ||
+						(candidates[a].estimated_cost == candidates[b].estimated_cost && a < b);
+				});
+				level.clear();
+				next_indexes.clear();
+				std::size_t kept = 0;
+				for (; kept < order.size() && level.size() < beam_width; ++kept)
+				{
+					const CostNode& candidate = candidates[order[kept]];
+					std::size_t states_before = states.size();
+					std::uint32_t id = states.intern(candidate.state);
+					if (id != states_before)
+					{
+						search_stats.duplicate();  // Another state of the level generated it first.
+						continue;
+					}
+					level.push_back(candidate);
+					next_indexes.push_back(recordsPath() ? addNode(id, candidate.parent_index, candidate.action) : 0);
+				}
+				search_stats.pruned(order.size() - kept);
+				search_stats.frontierSize(level.size());
+				indexes.swap(next_indexes);
+				++depth;
+			}
+
+			// Every state of the last level was pruned or had no new successors, and we didn't reach a goal node.
+			return false;
+		}
+
+		/* Return the index of a state in "states," adding it with infinite g and rhs if the incremental search hasn't seen it. */
+		std::uint32_t incrementalIndex(const StateType& state)
+		{
+			std::uint32_t id = states.intern(state);
+
+			if (id == incremental.g.size())
+			{
+				incremental.g.push_back(std::numeric_limits<double>::infinity());
+				incremental.rhs.push_back(std::numeric_limits<double>::infinity());
+			}
+			return id;
+		}
+
+		IncrementalKey incrementalKey(std::uint32_t id, const StateType& state) const
+		{
+			double path_cost = std::min(incremental.g[id], incremental.rhs[id]);
+			return IncrementalKey{path_cost + heuristic(state), path_cost};
+		}
+
+		/* Put a state on the frontier with its current key if its g and rhs differ, and take it off if they don't. */
+		void queueIncremental(std::uint32_t id, const StateType& state)
+		{
+			if (incremental.g[id] != incremental.rhs[id])
+			{
+				incremental.frontier.update(id, incrementalKey(id, state));
+			}
+			else
+			{
+				incremental.frontier.erase(id);
+			}
+		}
+
+		/* Recompute the rhs of a state other than the initial state from the g of its predecessors. */
+		void updateRhs(std::uint32_t id, const StateType& state)
+		{
+			double rhs = std::numeric_limits<double>::infinity();
+
+			incremental.parents.clear();
+			SuccessorSink sink{incremental.parents, 0};
+			predecessors(state, sink);
+			for (const Node& parent : incremental.parents)
+			{
+				std::uint32_t parent_id = states.find(parent.state);
+				if (parent_id != StateTableType::not_found)
+				{
+					rhs = std::min(rhs, incremental.g[parent_id] + stepCost(parent.state, parent.action, state));
+				}
+			}
+			incremental.rhs[id] = rhs;
+		}
+
+		/*
+		Expand the states on the frontier of the incremental search, lowest key first, until the goal's g and rhs agree
+		and no state on the frontier has a lower key than the goal.  A state whose rhs is less than its g gets g = rhs,
+		and lowers the rhs of its successors.  A state whose rhs is greater gets an infinite g, and the successors whose
+		rhs came through it recompute theirs, so they go back on the frontier to be expanded again.
+		*/
+		void computeIncremental()
+		{
+			IncrementalKeyComparison comes_after;
+			std::vector<Node>& children = context.children;
+			AllocatedVector<double>& g = incremental.g;
+			AllocatedVector<double>& rhs = incremental.rhs;
+			std::uint32_t goal_id = incremental.goal_id;
+
+			while (!incremental.frontier.isEmpty() && (comes_after(incrementalKey(goal_id, states[goal_id]),
+				incremental.frontier.next()) || g[goal_id] != rhs[goal_id]))
+			{
+				std::uint32_t id = incremental.frontier.nextKey();
+				StateType state = states[id];  // A copy, because interning children can move the states.
+
+				incremental.frontier.pop();
+				countExpansion(0);
+				expandCounted(state, 0, children, search_stats);
+				if (g[id] > rhs[id])
+				{
+					g[id] = rhs[id];
+					for (const Node& child : children)
+					{
+						std::uint32_t child_id = incrementalIndex(child.state);
+						double path_cost = g[id] + stepCost(state, child.action, child.state);
+						if (path_cost < rhs[child_id])
+						{
+							rhs[child_id] = path_cost;
+							queueIncremental(child_id, child.state);
+						}
+						else
+						{
+							search_stats.duplicate();
+						}
+					}
+				}
+				else
+				{
+					double old_g = g[id];
+					g[id] = std::numeric_limits<double>::infinity();
+					queueIncremental(id, state);
+					for (const Node& child : children)
+					{
+						std::uint32_t child_id = incrementalIndex(child.state);
+						if (!(child.state == incremental.initial_state) &&
+							rhs[child_id] == old_g + stepCost(state, child.action, child.state))
+						{
+							updateRhs(child_id, child.state);
+							queueIncremental(child_id, child.state);
+						}
+					}
+				}
+				search_stats.frontierSize(incremental.frontier.size());
+			}
+		}
+
+		/*
+		Record the solution of the incremental search, if the goal's g is finite.  For the path, go back from the goal
+		to the predecessor whose g plus the cost of its action matches the state's g.
+		*/
+		bool recordIncremental()
+		{
+			std::uint32_t goal_id = incremental.goal_id;
+			double cost = incremental.g[goal_id];
+
+			if (cost == std::numeric_limits<double>::infinity())
+			{
+				return false;
+			}
+			if (recordsPath())
+			{
+				std::vector<std::pair<std::uint32_t, ActionsType>> steps;  // From the goal back, each state and the action that reached it
+				std::uint32_t id = goal_id;
+				StateType state = states[id];
+
+				while (!(state == incremental.initial_state))
+				{
+					double best = std::numeric_limits<double>::infinity();
+					std::uint32_t best_id = id;
+					ActionsType best_action = ActionsType::start_state;
+
+					incremental.parents.clear();
+					SuccessorSink sink{incremental.parents, 0};
+					predecessors(state, sink);
+					for (const Node& parent : incremental.parents)
+					{
+						std::uint32_t parent_id = states.find(parent.state);
+						if (parent_id != StateTableType::not_found)
+						{
+							double path_cost = incremental.g[parent_id] + stepCost(parent.state, parent.action, state);
+							if (path_cost < best)
+							{
+								best = path_cost;
+								best_id = parent_id;
+								best_action = parent.action;
+							}
+						}
+					}
+					if (best_id == id || steps.size() == states.size())
+					{
+						throw "The incremental search's path is broken.  Are the changed edges all reported?";
+					}
+					steps.emplace_back(id, best_action);
+					id = best_id;
+					state = states[id];
+				}
+				addNode(id, 0, ActionsType::start_state);
+				for (std::size_t i = steps.size(); i-- > 0;)
+				{
+					addNode(steps[i].first, (std::uint32_t)node_states.size() - 1, steps[i].second);
+				}
+			}
+			recordGoal(recordsPath() ? (std::uint32_t)node_states.size() - 1 : 0, cost);
+			return true;
+		}
+
+		/*
+		Continue a search of the given kind, which was started or stopped before, until it finishes or the budget runs
+		out, and remember the kind if it stops.
+		*/
+		template <typename GoalTest>
+		SearchStatus continueLimited(StoppedSearch kind, const GoalTest& is_goal, SearchBudget& budget)
+		{
+			SearchStatus status;
+
+			stopped_search = StoppedSearch::none;  // In case the search throws
+			switch (kind)
+			{
+			case StoppedSearch::depth_first:
+				status = continueFrontier(is_goal, context.depth_first, false, budget);
+				break;
+			case StoppedSearch::breadth_first:
+				status = continueFrontier(is_goal, context.breadth_first, true, budget);
+				break;
+			default:
+				status = continueBestFirst(is_goal, kind == StoppedSearch::a_star, budget);
+			}
+			if (stoppedEarly(status))
+			{
+				stopped_search = kind;
+			}
+			return status;
+		}
+
+		/* Start a search of the given kind within limits, as described for the public searches given SearchLimits. */
+		template <typename GoalTest>
+		SearchStatus searchLimited(StoppedSearch kind, StateType initial_state, const GoalTest& is_goal,
+			const SearchLimits& limits)
+		{
+			SearchBudget budget{limits};
+			bool initial_goal = false;
+
+			clearSearch();
+			SearchTimer timer{*this};
+			stopped_result_kind = result_kind;
+			stopped_marking = state_marking;
+			if (kind == StoppedSearch::depth_first)
+			{
+				initial_goal = startFrontier(&initial_state, 1, is_goal, context.depth_first, false);
+			}
+			else if (kind == StoppedSearch::breadth_first)
+			{
+				initial_goal = startFrontier(&initial_state, 1, is_goal, context.breadth_first, true);
+			}
+			else
+			{
+				startBestFirst(initial_state, kind == StoppedSearch::a_star);
+			}
+			return initial_goal ? SearchStatus::found : continueLimited(kind, is_goal, budget);
+		}
+
+		/* Resume the search that stopped at a limit, as described for resumeSearch. */
+		template <typename GoalTest>
+		SearchStatus resumeLimited(const GoalTest& is_goal, const SearchLimits& limits)
+		{
+			SearchBudget budget{limits};
+
+			if (stopped_search == StoppedSearch::none)
+			{
+				throw "There is no stopped search to resume.";
+			}
+			if (result_kind != stopped_result_kind || state_marking != stopped_marking)
+			{
+				throw "Resume a stopped search with the result kind and state marking it began with.";
+			}
+			search_start = search_stats.resumedStart();
+			SearchTimer timer{*this};
+			return continueLimited(stopped_search, is_goal, budget);
+		}
+
+	public:
+		// The type of node on a frontier, for callers that pass their own Frontier instance to "search."
+		typedef Node NodeType;
+
+		explicit Problem(const AllocatorType& the_allocator = AllocatorType())
+			: allocator{the_allocator}, states(the_allocator), node_states(the_allocator), node_parents(the_allocator),
+			node_actions(the_allocator), context(the_allocator), incremental(the_allocator)
+		{
+		}
+
+		/* Return the statistics of the most recent search.  They are empty unless StatsType collects them. */
+		const StatsType& stats() const
+		{
+			return search_stats;
+		}
+
+		/* Have searches call "progress" every given number of nodes expanded.  The default, 0, never calls it. */
+		void setProgressInterval(std::size_t interval)
+		{
+			progress_interval = interval;
+		}
+
+		/*
+		Keep the successors of the states the searches expand, in a cache of about memory_budget bytes, so that later
+		expansions of the same states, in this search or the next, don't call "successors."  A budget of 0 turns the
+		cache off.  Setting a budget starts an empty cache.  Turn the cache off and on again after anything changes
+		the successors of states.
+		*/
+		void setSuccessorCache(std::size_t memory_budget)
+		{
+			successor_cache.reset(memory_budget == 0 ? nullptr : new SuccessorCacheType{memory_budget});
+		}
+
+		/* Return the successor cache, for its counters, or nullptr if it is off. */
+		const SuccessorCacheType* successorCache() const
+		{
+			return successor_cache.get();
+		}
+
+		/* Choose what the following searches record about their solutions.  See ResultKind. */
+		void setResultKind(ResultKind kind)
+		{
+			result_kind = kind;
+		}
+
+		/* Choose when the following depth-first and breadth-first searches mark states as seen.  See StateMarking. */
+		void setStateMarking(StateMarking marking)
+		{
+			state_marking = marking;
+		}
+
+		/*
+		Return the cost of the solution of the most recent search:  the sum of "stepCost" over its actions for the
+		uniform-cost, A*, IDA*, and incremental searches, and the number of its actions for the others, which ignore step
+		costs.
+		*/
+		double distance() const
+		{
+			if (!solution_found)
+			{
+				throw "You asked for a distance, but no solution was found.";
+			}
+			if (result_kind == ResultKind::reachability)
+			{
+				throw "You asked for a distance, but the search recorded only reachability.";
+			}
+			return solution_cost;
+		}
+
+		/*
+		The solution is the sequence of actions an agent must take to progress from the start state
+		to a goal state.  Return the solution to the most recent search as a vector of actions.
+
+		// TODO - For non-deterministic actions, the solution is a contingency plan.
+		*/
+		void solution(SolutionVector& the_solution)
+		{
+			if (!solution_found)
+			{
+				throw "You asked for a solution, but no solution was found.";  // TODO - Throw a standard exception?
+			}
+			if (!recordsPath())
+			{
+				throw "You asked for a solution, but the search did not record its path.";
+			}
+
+			the_solution.clear();  // Remove any previous solutions.
+
+			std::uint32_t index = goal_index;
+
+			while (node_actions[index] != ActionsType::start_state)
+			{
+				the_solution.emplace_back(node_actions[index]);
+				index = node_parents[index];
+			}
+			std::reverse(the_solution.begin(), the_solution.end());  // Re-orders in place.
+		}
+
+		/*
+		The path is the sequence of states through which an agent must progress from the start state
+		to a goal state.  Return the path of the most recent search as a vector of states.
+		*/
+		void path(PathVector& the_path)
+		{
+			if (!solution_found)
+			{
+				throw "You asked for a path, but no path was found.";  // TODO - Throw a standard exception?
+			}
+			if (!recordsPath())
+			{
+				throw "You asked for a path, but the search did not record it.";
+			}
+
+			the_path.clear();  // Remove the path for any previous solutions.
+
+			std::uint32_t index = goal_index;
+
+			while (node_actions[index] != ActionsType::start_state)
+			{
+				the_path.emplace_back(states[node_states[index]]);
+				index = node_parents[index];
+			}
+			the_path.emplace_back(states[node_states[index]]);   // Add the start state.
+			std::reverse(the_path.begin(), the_path.end());  // Re-orders in place.
+		}
+
+		/*
+		Perform a graph search using a Frontier instance passed as a pointer.  Return True if a solution to the
+		problem is found.  Otherwise, return False.  Upon success/true, the private member "solution" is populated,
+		and the "path" or "solution" method can be called without raising an exception.
+
+		To search to exhaustion--all available states have been expanded--set goal_states to an empty set.  You
+		could use this to traverse all states while computing side effects of some sort.
+
+		The frontier's methods are called virtually.  Prefer the overload below when the frontier type is known at
+		compile time.
+		*/
+		bool search(StateType initial_state, const StateSet& goal_states, Frontier<Node>* frontier)
+		{
+			return searchFrontier(&initial_state, 1, GoalSet{goal_states}, *frontier, false);
+		}
+
+		/*
+		Perform the same graph search using a frontier of the class template FrontierPolicy, such as
+		DepthFirstFrontier, which is created on the stack.  Because the frontier's type is known, the compiler can
+		inline its methods in the search loop.  For example:  problem.search<BreadthFirstFrontier>(start, goals)
+		*/
+		template <template <typename...> class FrontierPolicy>
+		bool search(StateType initial_state, const StateSet& goal_states)
+		{
+			FrontierPolicy<Node> frontier;
+			return searchFrontier(&initial_state, 1, GoalSet{goal_states}, frontier, false);
+		}
+
+		/*
+		Perform a standard depth-first search.  This is the general search using a stack as the frontier.  The problem
+		keeps the frontier for its next search.
+		*/
+		bool searchDepthFirst(StateType initial_state, const StateSet& goal_states)
+		{
+			return searchFrontier(&initial_state, 1, GoalSet{goal_states}, context.depth_first, false);
+		}
+
+		/* Perform the same depth-first search for the goals that isGoal recognizes. */
+		bool searchDepthFirst(StateType initial_state)
+		{
+			return searchFrontier(&initial_state, 1, GoalPredicate{*this}, context.depth_first, false);
+		}
+
+		/*
+		Perform the same depth-first search within limits on the nodes it expands and the time it takes, and let another
+		thread cancel it.  Return SearchStatus::found or not_found if it finishes, or the limit that stopped it.  A
+		stopped search keeps its frontier, states, and nodes, and resumeSearch continues it where it left off.
+		*/
+		SearchStatus searchDepthFirst(StateType initial_state, const StateSet& goal_states, const SearchLimits& limits)
+		{
+			return searchLimited(StoppedSearch::depth_first, initial_state, GoalSet{goal_states}, limits);
+		}
+
+		/* Perform the same depth-first search within limits for the goals that isGoal recognizes. */
+		SearchStatus searchDepthFirst(StateType initial_state, const SearchLimits& limits)
+		{
+			return searchLimited(StoppedSearch::depth_first, initial_state, GoalPredicate{*this}, limits);
+		}
+
+		/*
+		Perform a standard breadth-first search.  This is the general search using a queue as the frontier, except that
+		it tests each new state for a goal when it generates it, rather than after the rest of the state's level has
+		been generated.  The problem keeps the frontier for its next search.
+		*/
+		bool searchBreadthFirst(StateType initial_state, const StateSet& goal_states)
+		{
+			return searchFrontier(&initial_state, 1, GoalSet{goal_states}, context.breadth_first, true);
+		}
+
+		/* Perform the same breadth-first search for the goals that isGoal recognizes. */
+		bool searchBreadthFirst(StateType initial_state)
+		{
+			return searchFrontier(&initial_state, 1, GoalPredicate{*this}, context.breadth_first, true);
+		}
+
+		/*
+		Perform the same breadth-first search within limits on the nodes it expands and the time it takes, and let another
+		thread cancel it.  Return SearchStatus::found or not_found if it finishes, or the limit that stopped it.  A
+		stopped search keeps its frontier, states, and nodes, and resumeSearch continues it where it left off.
+		*/
+		SearchStatus searchBreadthFirst(StateType initial_state, const StateSet& goal_states, const SearchLimits& limits)
+		{
+			return searchLimited(StoppedSearch::breadth_first, initial_state, GoalSet{goal_states}, limits);
+		}
+
+		/* Perform the same breadth-first search within limits for the goals that isGoal recognizes. */
+		SearchStatus searchBreadthFirst(StateType initial_state, const SearchLimits& limits)
+		{
+			return searchLimited(StoppedSearch::breadth_first, initial_state, GoalPredicate{*this}, limits);
+		}
+
+		/*
+		Perform a breadth-first search from several initial states at once, as if from a single state with an action
+		to each.  This finds a goal with the fewest actions from the nearest initial state, and the path starts at the
+		initial state that reached it.  The problem keeps the frontier for its next search.
+		*/
+		bool searchBreadthFirstMultiSource(const std::vector<StateType>& initial_states, const StateSet& goal_states)
+		{
+			return searchFrontier(initial_states.data(), initial_states.size(), GoalSet{goal_states}, context.breadth_first,
+				true);
+		}
+
+		/* Perform the same breadth-first search for the goals that isGoal recognizes. */
+		bool searchBreadthFirstMultiSource(const std::vector<StateType>& initial_states)
+		{
+			return searchFrontier(initial_states.data(), initial_states.size(), GoalPredicate{*this}, context.breadth_first,
+				true);
+		}
+
+		/*
+		Perform a breadth-first search of a problem whose states are the integers from 0 to num_states - 1, keeping the
+		states visited in a Bitmap rather than the state table.  Like searchBreadthFirst, it finds a solution with the
+		fewest actions, but marking a state takes one bit instead of a table entry, and it goes one level at a time.
+
+		A level with fewer states than one per 64 holds them in a vector, and the search tests each successor's bit.
+		A larger level, as in the middle of a search of a graph with a small diameter, is itself a Bitmap:  the search
+		sets the successors' bits without testing them, and then removes the states already visited, adds the rest to
+		the visited states, and counts them in one pass over the words.  If the search keeps its path, it records the
+		state each state was reached from in an array of num_states states.  Like searchBreadthFirst, it tests each new
+		state for a goal when it generates it.
+
+		A successor outside the states raises an exception.
+		*/
+		bool searchBreadthFirstDense(StateType initial_state, const StateSet& goal_states, std::size_t num_states)
+		{
+			return searchDense(initial_state, GoalSet{goal_states}, num_states);
+		}
+
+		/* Perform the same dense breadth-first search for the goals that isGoal recognizes. */
+		bool searchBreadthFirstDense(StateType initial_state, std::size_t num_states)
+		{
+			return searchDense(initial_state, GoalPredicate{*this}, num_states);
+		}
+
+		/*
+		Perform a beam search:  a breadth-first search that keeps only the beam_width new successors of each level with
+		the lowest "heuristic" estimates, and prunes the rest, which SearchStats counts in nodes_pruned.  The search
+		keeps at most beam_width states per level, so its memory grows with the beam width times the depth of the
+		search rather than with the size of the levels.  It trades completeness and optimality for that bound:  it can
+		miss every goal, and the path it finds can be longer than the shortest.  Like searchBreadthFirst, it tests each
+		new state for a goal when it generates it, and "distance" is the number of actions of the path.
+		*/
+		bool searchBeam(StateType initial_state, const StateSet& goal_states, std::size_t beam_width)
+		{
+			return searchBeamWidth(initial_state, GoalSet{goal_states}, beam_width);
+		}
+
+		/* Perform the same beam search for the goals that isGoal recognizes. */
+		bool searchBeam(StateType initial_state, std::size_t beam_width)
+		{
+			return searchBeamWidth(initial_state, GoalPredicate{*this}, beam_width);
+		}
+
+		/* The distance the batched searches report for a goal that can't be reached */
+		static const std::uint32_t unreachable = UINT32_MAX;
+
+		/*
+		Perform one breadth-first search from all of "sources" at once, and find the source nearest each of "goals":
+		store its index in "sources" in nearest_sources, and the fewest actions from it in "distances," both by index
+		in "goals," or "unreachable" for both if no source reaches the goal.  The search stops once it has reached every
+		goal, so it answers for every goal for the cost of a single search.  "solution" and "path" are not available
+		afterward.
+		*/
+		void searchBreadthFirstNearest(const std::vector<StateType>& sources, const std::vector<StateType>& goals,
+			std::vector<std::uint32_t>& nearest_sources, std::vector<std::uint32_t>& distances)
+		{
+			StateTableType goal_table(allocator);  // The goal states, indexed in the order first listed
+			AllocatedVector<std::uint32_t> goal_indexes(allocator);  // The first index in "goals" of each goal state
+			AllocatedVector<std::uint32_t> labels(allocator);  // The index of the source that reached each state
+			AllocatedVector<std::uint32_t> depths(allocator);
+			AllocatedVector<std::uint32_t> level(allocator), next_level(allocator);
+			std::vector<Node>& children = context.children;
+			std::size_t remaining;  // The goal states not yet reached
+
+			clearSearch();
+			SearchTimer timer{*this};
+			nearest_sources.assign(goals.size(), (std::uint32_t)unreachable);
+			distances.assign(goals.size(), (std::uint32_t)unreachable);
+			for (std::size_t j = 0; j < goals.size(); ++j)
+			{
+				if (goal_table.intern(goals[j]) == goal_indexes.size())
+				{
+					goal_indexes.push_back((std::uint32_t)j);
+				}
+			}
+			remaining = goal_indexes.size();
+
+			// Record a newly reached state, and whether it is a goal.
+			auto reach = [&](std::uint32_t id, std::uint32_t label, std::uint32_t depth) {
+				labels.push_back(label);
+				depths.push_back(depth);
+				next_level.push_back(id);
+				std::uint32_t goal_id = goal_table.find(states[id]);
+				if (goal_id != StateTableType::not_found)
+				{
+					nearest_sources[goal_indexes[goal_id]] = label;
+					distances[goal_indexes[goal_id]] = depth;
+					--remaining;
+				}
+			};
+
+			for (std::size_t i = 0; i < sources.size(); ++i)
+			{
+				std::uint32_t id = states.intern(sources[i]);
+				if (id == labels.size())
+				{
+					reach(id, (std::uint32_t)i, 0);
+				}
+			}
+			level.swap(next_level);
+
+			while (remaining > 0 && !level.empty())
+			{
+				search_stats.frontierSize(level.size());
+				for (std::uint32_t id : level)
+				{
+					StateType state = states[id];  // A copy, because interning children can move the states.
+
+					countExpansion(depths[id]);
+					expandCounted(state, id, children, search_stats);
+					for (const Node& child : children)
+					{
+						std::uint32_t child_id = states.intern(child.state);
+						if (child_id < labels.size())
+						{
+							search_stats.duplicate();
+						}
+						else
+						{
+							reach(child_id, labels[id], depths[id] + 1);
+						}
+					}
+				}
+				level.clear();
+				level.swap(next_level);
+			}
+
+			// Fill in the goals listed more than once.
+			for (std::size_t j = 0; j < goals.size(); ++j)
+			{
+				std::uint32_t first = goal_indexes[goal_table.find(goals[j])];
+				nearest_sources[j] = nearest_sources[first];
+				distances[j] = distances[first];
+			}
+			search_stats.nodesSize(labels.size());
+		}
+
+		/*
+		Answer a batch of queries, each for the fewest actions from sources[i] to goals[i], and store the answers in
+		"distances," by query, or "unreachable."  This gives the same answers as a breadth-first search per query, but
+		the queries share their work.
+
+		The search goes breadth-first for up to 64 queries at once, with one bit per query in a mask for each state, so
+		a state that several of those queries reach at the same depth is visited once for all of them.  It also keeps
+		the successors of each state it expands, as state indexes, for the rest of the batch, so no state is expanded
+		twice in a batch, and the later visits are cheap.  A query drops out of its group when it reaches its goal.  The
+		successors take memory in proportion to the edges among the states the batch reaches, until it returns.
+		"solution" and "path" are not available afterward.
+		*/
+		void searchBreadthFirstBatch(const std::vector<StateType>& sources, const std::vector<StateType>& goals,
+			std::vector<std::uint32_t>& distances)
+		{
+			BatchCache cache{allocator};
+			AllocatedVector<std::uint32_t>& level = cache.level;
+			std::vector<std::uint32_t> goal_ids;  // The state index of the goal of each query in the group
+
+			if (sources.size() != goals.size())
+			{
+				throw "A batch needs one goal per source.";
+			}
+			clearSearch();
+			SearchTimer timer{*this};
+			distances.assign(sources.size(), (std::uint32_t)unreachable);
+
+			for (std::size_t group = 0; group < sources.size(); group += 64)
+			{
+				std::size_t group_size = std::min<std::size_t>(64, sources.size() - group);
+				std::uint64_t active = group_size == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << group_size) - 1;
+
+				cache.startGroup();
+				goal_ids.clear();
+				for (std::size_t i = 0; i < group_size; ++i)
+				{
+					goal_ids.push_back(cache.intern(states, goals[group + i]));
+					cache.goals[goal_ids.back()] |= std::uint64_t{1} << i;
+				}
+				for (std::size_t i = 0; i < group_size; ++i)
+				{
+					cache.reach(cache.intern(states, sources[group + i]), std::uint64_t{1} << i);
+				}
+				cache.advance();
+
+				for (std::uint32_t depth = 0; !level.empty() && active != 0; ++depth)
+				{
+					// Record the queries that reach their goals at this depth, and drop them.
+					for (std::uint32_t id : level)
+					{
+						for (std::uint64_t bits = cache.current[id] & cache.goals[id] & active; bits != 0; bits &= bits - 1)
+						{
+							distances[group + lowestBit(bits)] = depth;
+						}
+						active &= ~(cache.current[id] & cache.goals[id]);
+					}
+					if (active == 0)
+					{
+						break;
+					}
+
+					// Pass each state's queries on to its successors that those queries have not reached yet.
+					search_stats.frontierSize(level.size());
+					for (std::uint32_t id : level)
+					{
+						std::uint64_t bits = cache.current[id] & active;
+						if (bits == 0)
+						{
+							continue;
+						}
+						if (!cache.isExpanded(id))
+						{
+							countExpansion(depth);
+							cacheSuccessors(cache, id);
+						}
+						for (std::uint32_t k = cache.begin[id]; k < cache.end[id]; ++k)
+						{
+							cache.reach(cache.successors[k], bits);
+						}
+					}
+					cache.advance();
+				}
+				for (std::uint32_t id : goal_ids)
+				{
+					cache.goals[id] = 0;
+				}
+			}
+			search_stats.nodesSize(cache.successors.size());
+		}
+
+#ifdef GRAPHSEARCH_EXTERNAL_MEMORY
+		/*
+		Perform a breadth-first search that keeps its levels on disk, in a new directory inside "directory," for state
+		spaces whose levels don't fit in memory.  StateType must be trivially copyable, and equal states must have equal
+		bytes.  See ExternalMemory.h.
+
+		The search detects duplicates late:  it collects the successors of a level in a buffer of about memory_budget
+		bytes, and whenever the buffer fills, it sorts the buffer and writes it to a file.  At the end of the level, it
+		merges those files, and drops the states in the files of states visited so far, to write the next level.  Each record of a level
+		holds the index of its parent in the previous level, so "solution" and "path" work as after the other searches.
+		Like searchBreadthFirst, this finds a solution with the fewest actions.  The files are removed when it returns,
+		and if the search does not record its path (see ResultKind), each level's file is removed once the level is expanded.
+		*/
+		bool searchBreadthFirstExternal(StateType initial_state, const StateSet& goal_states, const std::string& directory,
+			std::size_t memory_budget)
+		{
+			static_assert(std::is_trivially_copyable<StateType>::value, "An external-memory search needs trivially copyable states.");
+
+			TemporaryDirectory files{directory};
+			std::vector<std::string> levels;  // The file of each level so far
+			std::vector<std::string> runs;    // The files of sorted successors of the current level
+			std::vector<VisitedSegment> visited;  // The visited states; see mergeLevel
+			std::vector<LevelRecord> run;     // The successors not yet written to a file
+			std::vector<Node>& children = context.children;
+			std::size_t run_capacity = std::max<std::size_t>(memory_budget / sizeof(LevelRecord), 1);
+			std::uint64_t goal_index = UINT64_MAX;
+
+			clearSearch();
+			SearchTimer timer{*this};
+			run.reserve(run_capacity);
+
+			levels.push_back(files.newFile());
+			{
+				std::string visited_file = files.newFile();
+				RecordWriter<LevelRecord> level{levels.back()};
+				RecordWriter<StateType> first_visited{visited_file};
+				level.add(LevelRecord{initial_state, 0, ActionsType::start_state});
+				first_visited.add(initial_state);
+				level.close();
+				first_visited.close();
+				visited.emplace_back(visited_file);
+			}
+			if (goal_states.count(initial_state) == 1)
+			{
+				goal_index = 0;
+			}
+
+			for (std::uint32_t depth = 0; goal_index == UINT64_MAX; ++depth)
+			{
+				{
+					MappedRecords<LevelRecord> level{levels.back()};
+					if (level.size() == 0)
+					{
+						return false;  // The last level had no new states.
+					}
+					search_stats.frontierSize(level.size());
+					for (std::size_t i = 0; i < level.size(); ++i)
+					{
+						countExpansion(depth);
+						expandCounted(level[i].state, 0, children, search_stats);
+						for (const Node& child : children)
+						{
+							run.push_back(LevelRecord{child.state, i, child.action});
+							if (run.size() == run_capacity)
+							{
+								writeRun(files, run, runs);
+							}
+						}
+					}
+				}
+				if (!recordsPath())
+				{
+					files.remove(levels.back());  // Only the path needs the levels before the next.
+				}
+				if (runs.empty())
+				{
+					sortRun(run);
+				}
+				else if (!run.empty())
+				{
+					writeRun(files, run, runs);
+				}
+				goal_index = mergeLevel(files, run, runs, levels, visited, goal_states);
+			}
+
+			if (!recordsPath())
+			{
+				recordGoal(0, (double)(levels.size() - 1));
+				return true;
+			}
+
+			// Follow the parents back from the goal, one level at a time, and add the path to the node vectors.
+			std::vector<LevelRecord> path_records;
+			for (std::size_t depth = levels.size(); depth-- > 0; )
+			{
+				MappedRecords<LevelRecord> level{levels[depth]};
+				path_records.push_back(level[goal_index]);
+				goal_index = path_records.back().parent;
+			}
+			for (std::size_t i = path_records.size(); i-- > 0; )
+			{
+				addNode(states.intern(path_records[i].state), node_states.empty() ? 0 : (std::uint32_t)node_states.size() - 1,
+					path_records[i].action);
+			}
+			recordGoal((std::uint32_t)node_states.size() - 1, (double)(levels.size() - 1));
+			return true;
+		}
+#endif
+
+		/*
+		Perform a bidirectional breadth-first search:  one search forward from the initial state and another backward
+		from the goal states, using "predecessors," which you must override.  Each step expands a whole level of the
+		direction with the smaller frontier, and the search stops after the first level in which the two directions
+		meet.  Like searchBreadthFirst, this finds a solution with the fewest actions, but it expands about as many
+		nodes as two breadth-first searches to half the depth.  Goal states must be listed; an empty set finds nothing.
+		*/
+		bool searchBidirectional(StateType initial_state, const StateSet& goal_states)
+		{
+			SearchDirection forward{allocator}, backward{allocator};
+			std::uint32_t best_length = UINT32_MAX;
+			std::uint32_t forward_meeting = 0, backward_meeting = 0;
+
+			clearSearch();
+			SearchTimer timer{*this};
+			forward.addRoot(initial_state);
+			for (const StateType& goal_state : goal_states)
+			{
+				backward.addRoot(goal_state);
+			}
+
+			if (goal_states.count(initial_state) == 1)
+			{
+				best_length = 0;
+				backward_meeting = backward.table.find(initial_state);
+			}
+
+			while (best_length == UINT32_MAX && !forward.level.empty() && !backward.level.empty())
+			{
+				if (forward.level.size() <= backward.level.size())
+				{
+					expandDirection(forward, backward, true, best_length, forward_meeting, backward_meeting);
+				}
+				else
+				{
+					expandDirection(backward, forward, false, best_length, backward_meeting, forward_meeting);
+				}
+				search_stats.frontierSize(forward.level.size() + backward.level.size());
+				search_stats.nodesSize(forward.links.size() + backward.links.size());
+			}
+
+			if (best_length == UINT32_MAX)
+			{
+				return false;  // One direction ran out of states without meeting the other.
+			}
+			if (!recordsPath())
+			{
+				recordGoal(0, best_length);
+				return true;
+			}
+
+			// Join the forward path to the meeting state and the backward path from it.
+			std::vector<std::uint32_t> forward_path;
+			for (std::uint32_t id = forward_meeting; forward.link_actions[id] != ActionsType::start_state; id = forward.links[id])
+			{
+				forward_path.push_back(id);
+			}
+			std::reverse(forward_path.begin(), forward_path.end());
+
+			addNode(states.intern(initial_state), 0, ActionsType::start_state);
+			for (std::uint32_t id : forward_path)
+			{
+				addNode(states.intern(forward.table[id]), (std::uint32_t)node_states.size() - 1, forward.link_actions[id]);
+			}
+			for (std::uint32_t id = backward_meeting; backward.link_actions[id] != ActionsType::start_state; id = backward.links[id])
+			{
+				addNode(states.intern(backward.table[backward.links[id]]), (std::uint32_t)node_states.size() - 1,
+					backward.link_actions[id]);
+			}
+			recordGoal((std::uint32_t)node_states.size() - 1, best_length);
+			return true;
+		}
+
+		/*
+		Perform an iterative-deepening depth-first search:  a depth-first search that goes no deeper than 0 actions,
+		then one that goes no deeper than 1, and so on up to max_depth actions.  Like searchBreadthFirst, this finds a
+		solution with the fewest actions, but it keeps only the current path instead of every node it expands.  It
+		re-expands the shallow nodes in every round, and it can expand a state once per path that reaches it.
+
+		If transposition_limit is not zero, the search also remembers up to that many states, and does not expand a
+		state again in a round unless it reaches the state by a shorter path.  That trades memory for fewer expansions.
+		*/
+		bool searchIterativeDeepening(StateType initial_state, const StateSet& goal_states, std::uint32_t max_depth,
+			std::size_t transposition_limit = 0)
+		{
+			return searchIterative(initial_state, goal_states, max_depth, false, transposition_limit);
+		}
+
+		/*
+		Perform an iterative-deepening A* search.  Each round is a depth-first search that cuts off nodes whose path
+		cost plus "heuristic" estimate exceeds a bound.  The first bound is the estimate for the initial state, and
+		each round raises it to the least cost cut off in the last, until a round finds a goal or the bound exceeds
+		max_cost.  Like searchAStar, this finds a cheapest path if the heuristic never overestimates, but its memory
+		grows with the depth of the solution rather than with the number of states.  See searchIterativeDeepening for
+		transposition_limit.
+		*/
+		bool searchIDAStar(StateType initial_state, const StateSet& goal_states,
+			double max_cost = std::numeric_limits<double>::infinity(), std::size_t transposition_limit = 0)
+		{
+			return searchIterative(initial_state, goal_states, max_cost, true, transposition_limit);
+		}
+
+		/*
+		Perform a uniform-cost search.  This is a best-first search that expands the node with the cheapest path cost
+		first, as given by "stepCost."  The solution is a cheapest path to a goal.
+		*/
+		bool searchUniformCost(StateType initial_state, const StateSet& goal_states)
+		{
+			return searchBestFirst(initial_state, GoalSet{goal_states}, false);
+		}
+
+		/* Perform the same uniform-cost search for the goals that isGoal recognizes. */
+		bool searchUniformCost(StateType initial_state)
+		{
+			return searchBestFirst(initial_state, GoalPredicate{*this}, false);
+		}
+
+		/*
+		Perform the same uniform-cost search within limits on the nodes it expands and the time it takes, and let another
+		thread cancel it.  Return SearchStatus::found or not_found if it finishes, or the limit that stopped it.  A
+		stopped search keeps its frontier, states, and nodes, and resumeSearch continues it where it left off.
+		*/
+		SearchStatus searchUniformCost(StateType initial_state, const StateSet& goal_states, const SearchLimits& limits)
+		{
+			return searchLimited(StoppedSearch::uniform_cost, initial_state, GoalSet{goal_states}, limits);
+		}
+
+		/* Perform the same uniform-cost search within limits for the goals that isGoal recognizes. */
+		SearchStatus searchUniformCost(StateType initial_state, const SearchLimits& limits)
+		{
+			return searchLimited(StoppedSearch::uniform_cost, initial_state, GoalPredicate{*this}, limits);
+		}
+
+		/*
+		Perform an A* search.  This is a best-first search that expands the node with the lowest sum of path cost and
+		"heuristic" estimate first.  The solution is a cheapest path to a goal if the heuristic never overestimates.
+		*/
+		bool searchAStar(StateType initial_state, const StateSet& goal_states)
+		{
+			return searchBestFirst(initial_state, GoalSet{goal_states}, true);
+		}
+
+		/* Perform the same A* search for the goals that isGoal recognizes. */
+		bool searchAStar(StateType initial_state)
+		{
+			return searchBestFirst(initial_state, GoalPredicate{*this}, true);
+		}
+
+		/*
+		Perform the same A* search within limits on the nodes it expands and the time it takes, and let another
+		thread cancel it.  Return SearchStatus::found or not_found if it finishes, or the limit that stopped it.  A
+		stopped search keeps its frontier, states, and nodes, and resumeSearch continues it where it left off.
+		*/
+		SearchStatus searchAStar(StateType initial_state, const StateSet& goal_states, const SearchLimits& limits)
+		{
+			return searchLimited(StoppedSearch::a_star, initial_state, GoalSet{goal_states}, limits);
+		}
+
+		/* Perform the same A* search within limits for the goals that isGoal recognizes. */
+		SearchStatus searchAStar(StateType initial_state, const SearchLimits& limits)
+		{
+			return searchLimited(StoppedSearch::a_star, initial_state, GoalPredicate{*this}, limits);
+		}
+
+		/*
+		Continue the last search, if it stopped at one of its limits, within new limits, and return its status as the
+		search given limits does.  Pass the goal states the search began with.  A search that stopped can't be resumed
+		after another search begins, or with a different result kind or state marking.  Its statistics count the whole
+		search, but not the time between the calls.
+		*/
+		SearchStatus resumeSearch(const StateSet& goal_states, const SearchLimits& limits)
+		{
+			return resumeLimited(GoalSet{goal_states}, limits);
+		}
+
+		/* Continue the last search, which was searching for the goals that isGoal recognizes, within new limits. */
+		SearchStatus resumeSearch(const SearchLimits& limits)
+		{
+			return resumeLimited(GoalPredicate{*this}, limits);
+		}
+
+		/*
+		Perform a breadth-first search with "num_threads" threads, one level at a time.  The threads expand the nodes
+		of a level in parallel, each adding the new successors it finds to its own share of the next level, and they
+		share a ConcurrentStateSet of the states seen so far.  Small levels are expanded by the calling thread alone.
+
+		Like searchBreadthFirst, this finds a solution with the fewest actions, although when there are several, it may
+		not find the same one.  See the thread safety notes above.
+		*/
+		bool searchBreadthFirstParallel(StateType initial_state, const StateSet& goal_states, unsigned num_threads)
+		{
+			ConcurrentStateSet<StateType, StateHashType> visited{num_threads};
+			std::vector<StateType> level{initial_state};    // The states of the nodes in the current level
+			std::vector<std::vector<LevelEntry>> history;   // The nodes of every level so far, if the search records its path
+			std::uint32_t depth = 0;                        // The depth of the current level
+			std::vector<LevelOutput> outputs(std::max(num_threads, 1u));
+			std::vector<std::thread> threads;
+			std::size_t history_size = 1;  // The number of entries in "history," for statistics
+
+			clearSearch();
+			SearchTimer timer{*this};
+			visited.insert(initial_state);
+			if (recordsPath())
+			{
+				history.push_back(std::vector<LevelEntry>{LevelEntry{0, ActionsType::start_state}});
+			}
+
+			while (!level.empty())
+			{
+				std::atomic<std::size_t> next_chunk{0};
+				std::atomic<std::size_t> goal_index{no_goal};
+				std::atomic<bool> stop{false};
+				std::size_t level_threads = std::min<std::size_t>(outputs.size(), (level.size() + level_chunk_size - 1) / level_chunk_size);
+
+				// Expand the level.  The calling thread takes a share of the work, too.
+				search_stats.frontierSize(level.size());
+				for (std::size_t t = 1; t < level_threads; ++t)
+				{
+					threads.emplace_back(&Problem::expandLevel, this, std::cref(level), depth, std::cref(goal_states),
+						std::ref(visited), std::ref(next_chunk), std::ref(goal_index), std::ref(stop), std::ref(outputs[t]));
+				}
+				expandLevel(level, depth, goal_states, visited, next_chunk, goal_index, stop, outputs[0]);
+				for (std::thread& thread : threads)
+				{
+					thread.join();
+				}
+				threads.clear();
+
+				std::size_t expanded_before = search_stats.expandedCount();
+				for (LevelOutput& output : outputs)
+				{
+					if (output.error)
+					{
+						std::rethrow_exception(output.error);
+					}
+					search_stats.merge(output.stats);
+					output.stats.clear();
+				}
+				reportProgress(expanded_before, search_stats.expandedCount());
+
+				if (goal_index.load() != no_goal)
+				{
+					if (!recordsPath())
+					{
+						recordGoal(0, depth);
+						return true;
+					}
+
+					// Found a goal state.  Walk the parent indexes back to the initial state to get the solution.
+					SolutionVector the_actions;
+					std::size_t index = goal_index.load();
+
+					for (std::size_t level_depth = depth; level_depth > 0; --level_depth)
+					{
+						the_actions.push_back(history[level_depth][index].action);
+						index = history[level_depth][index].parent_index;
+					}
+					std::reverse(the_actions.begin(), the_actions.end());
+					recordSolution(initial_state, the_actions);
+					recordGoal((std::uint32_t)node_states.size() - 1, depth);
+					return true;
+				}
+
+				// Gather the threads' shares into the next level.
+				level.clear();
+				++depth;
+				if (recordsPath())
+				{
+					history.emplace_back();
+				}
+				for (LevelOutput& output : outputs)
+				{
+					level.insert(level.end(), output.states.begin(), output.states.end());
+					if (recordsPath())
+					{
+						history.back().insert(history.back().end(), output.entries.begin(), output.entries.end());
+					}
+					output.states.clear();
+					output.entries.clear();
+				}
+				history_size += level.size();
+				search_stats.nodesSize(history_size);
+			}
+
+			// Every reachable state has been expanded, and none is a goal.
+			return false;
+		}
+
+		/*
+		Traverse the states reachable from the initial state with "num_threads" threads, stopping as soon as any thread
+		expands a goal state.  Each thread searches depth-first from its own WorkStealingFrontier, and a thread whose
+		frontier is empty steals the oldest node from another's.  The threads share a ConcurrentStateSet of the states
+		seen so far, and a state is added to a frontier only the first time any thread sees it, so each reachable state
+		is expanded at most once.
+
+		Use this to find any goal, or, with an empty goal_states, to visit every reachable state.  The solution it
+		finds is not necessarily the shortest, and which one it finds can vary from run to run.  See the thread safety
+		notes above.
+		*/
+		bool searchDepthFirstParallel(StateType initial_state, const StateSet& goal_states, unsigned num_threads)
+		{
+			Traversal traversal{goal_states, std::max(num_threads, 1u)};
+			std::vector<std::thread> threads;
+			std::size_t entries_size = 0;  // For statistics
+
+			clearSearch();
+			SearchTimer timer{*this};
+			traversal.visited.insert(initial_state);
+			traversal.pending = 1;
+			traversal.workers[0].frontier.add(TraversalNode{initial_state, 0, ActionsType::start_state, 0});
+
+			// The calling thread is worker 0.
+			for (std::size_t t = 1; t < traversal.workers.size(); ++t)
+			{
+				threads.emplace_back(&Problem::traverse, this, std::ref(traversal), t);
+			}
+			traverse(traversal, 0);
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+
+			for (TraversalWorker& worker : traversal.workers)
+			{
+				if (worker.error)
+				{
+					std::rethrow_exception(worker.error);
+				}
+				search_stats.merge(worker.stats);
+				entries_size += worker.entries.size();
+			}
+			search_stats.nodesSize(entries_size);  // The vectors only grow, so this is their peak.
+
+			if (traversal.goal_ref.load() == UINT64_MAX)
+			{
+				return false;  // Every reachable state has been expanded, and none is a goal.
+			}
+			if (!recordsPath())
+			{
+				recordGoal(0, traversal.goal_depth);  // The threads are joined, so goal_depth is safe to read.
+				return true;
+			}
+
+			// Found a goal state.  Walk the parent references back to the initial state to get the solution.
+			SolutionVector the_actions;
+			std::uint64_t ref = traversal.goal_ref.load();
+			const TraversalEntry* entry = &traversal.workers[ref >> 32].entries[ref & UINT32_MAX];
+
+			while (entry->action != ActionsType::start_state)
+			{
+				the_actions.push_back(entry->action);
+				ref = entry->parent_ref;
+				entry = &traversal.workers[ref >> 32].entries[ref & UINT32_MAX];
+			}
+			std::reverse(the_actions.begin(), the_actions.end());
+			recordSolution(initial_state, the_actions);
+			recordGoal((std::uint32_t)node_states.size() - 1, traversal.goal_depth);
+			return true;
+		}
+
+		/*
+		Perform an incremental search, Lifelong Planning A*, for a cheapest path from the initial state to one goal
+		state.  The first search expands about the states an A* search would.  When the costs of some actions change
+		afterward, or actions are added or removed, report each one to "edgeChanged," and "replan" repairs the solution,
+		expanding again only the states whose path costs the changes affect, rather than searching from scratch.  The
+		problem keeps the search's states and their costs until another search begins.
+
+		The search needs "predecessors," and a heuristic that never overestimates and obeys the triangle inequality.
+		Like searchAStar, it finds a cheapest path, and "solution," "path," and "distance" return it.
+		*/
+		bool searchIncremental(StateType initial_state, StateType goal_state)
+		{
+			clearSearch();
+			SearchTimer timer{*this};
+			incremental.active = true;
+			incremental.initial_state = initial_state;
+			incremental.g.clear();
+			incremental.rhs.clear();
+			incremental.frontier.clear();
+
+			std::uint32_t initial_id = incrementalIndex(initial_state);
+			incremental.goal_id = incrementalIndex(goal_state);
+			incremental.rhs[initial_id] = 0.0;
+			queueIncremental(initial_id, initial_state);
+			computeIncremental();
+			return recordIncremental();
+		}
+
+		/*
+		Report that the cost of the action from one state to another has changed, or that the action has been added or
+		removed.  "stepCost," "successors," and "predecessors" must already reflect the change.  Call "replan" after
+		reporting the changes.
+		*/
+		void edgeChanged(const StateType& from_state, const StateType& to_state)
+		{
+			if (!incremental.active)
+			{
+				throw "There is no incremental search to update.";
+			}
+			if (states.find(from_state) == StateTableType::not_found || to_state == incremental.initial_state)
+			{
+				return;  // The search never reached the action's state, so the action affects no path cost yet.
+			}
+
+			std::uint32_t id = incrementalIndex(to_state);
+			updateRhs(id, to_state);
+			queueIncremental(id, to_state);
+		}
+
+		/*
+		Repair the solution of the incremental search after the changes reported to "edgeChanged," and return true if
+		the goal can still be reached.  The statistics count only this call.
+		*/
+		bool replan()
+		{
+			if (!incremental.active)
+			{
+				throw "There is no incremental search to replan.";
+			}
+			clearResult();
+			SearchTimer timer{*this};
+			computeIncremental();
+			return recordIncremental();
+		}
+	};
+} // End of the graphsearch namespace.
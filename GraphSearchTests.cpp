@@ -5,10 +5,15 @@ You are welcome to use this code pursuant to the GNU General Public license.  Se
 This code tests GraphSearch.h.
 */
 
+#include <atomic>
+#include <chrono>
+#include <cmath>           // std::isinf
+#include <cstdlib>         // std::abs
 #include <unordered_set>
 #include <vector>
 
 #include "cute.h"
+#include "CountingAllocator.h"  // ZeroAllocationExpandTest verifies that expanding a node does not allocate
 #include "GraphSearch.h"
 #include "GraphSearchTests.h"
 
@@ -386,3 +391,1369 @@ void SimpleStructDepthFirstSearchTest()
 	problem.path(the_path);
 	ASSERTM("Incorrect path.", (the_path == std::vector<SimpleStruct>({SimpleStruct{ 5 }, SimpleStruct{ 1 }, SimpleStruct{ 2 }})));
 }
+
+//------------------------------------------------------------------------------------------------------
+
+void WeightedProblem::actions(int state, std::vector<TestActions>& available_actions) const
+{
+	switch (state)
+	{
+	case 1:
+		available_actions = std::vector<TestActions>({ TestActions::down, TestActions::right });
+		break;
+	case 2:
+	case 3:
+		available_actions = std::vector<TestActions>({ TestActions::left, TestActions::right });
+		break;
+	case 4:
+		available_actions = std::vector<TestActions>({ TestActions::up, TestActions::left });
+		break;
+	default:
+		throw "Unrecognized state.";
+	}
+}
+
+const int WeightedProblem::result(int state, TestActions action)
+{
+	switch (action)
+	{
+	case TestActions::right:
+		return state + 1;
+	case TestActions::left:
+		return state - 1;
+	case TestActions::down:
+		return 4;
+	case TestActions::up:
+		return 1;
+	default:
+		throw "Unrecognized action.";
+	}
+}
+
+double WeightedProblem::stepCost(const int& /* state */, TestActions action, const int& /* next_state */) const
+{
+	return (action == TestActions::down || action == TestActions::up) ? 10.0 : 1.0;
+}
+
+double WeightedProblem::heuristic(const int& state) const
+{
+	// The number of cheap edges between the state and state 4, which never overestimates the cost to reach 4.
+	return 4.0 - state;
+}
+
+void WeightedBreadthFirstSearchTest()
+{
+	WeightedProblem problem;
+	std::unordered_set<int> goal_states({ 4 });
+	std::vector<TestActions> the_solution;
+	std::vector<int> the_path;
+
+	// Breadth-first search ignores costs, so it should find the path 1-4 with solution {down}.
+	ASSERTM("No solution found.", problem.searchBreadthFirst(1, goal_states));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>({ TestActions::down })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 1, 4 })));
+}
+
+void UniformCostSearchTest()
+{
+	WeightedProblem problem;
+	std::unordered_set<int> goal_states({ 4 });
+	std::vector<TestActions> the_solution;
+	std::vector<int> the_path;
+
+	// This search should find the cheapest path 1-2-3-4 with solution {right, right, right}.
+	ASSERTM("No solution found.", problem.searchUniformCost(1, goal_states));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>({ TestActions::right, TestActions::right, TestActions::right })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 1, 2, 3, 4 })));
+
+	// This search should find the path 4-3-2-1 with solution {left, left, left}.
+	ASSERTM("No solution found.", problem.searchUniformCost(4, std::unordered_set<int>({ 1 })));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>({ TestActions::left, TestActions::left, TestActions::left })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 4, 3, 2, 1 })));
+
+	ASSERTM("Searching without a goal should not cause errors.", !problem.searchUniformCost(2, std::unordered_set<int>()));
+}
+
+void AStarSearchTest()
+{
+	WeightedProblem problem;
+	std::unordered_set<int> goal_states({ 4 });
+	std::vector<TestActions> the_solution;
+	std::vector<int> the_path;
+
+	// This search should find the cheapest path 1-2-3-4 with solution {right, right, right}.
+	ASSERTM("No solution found.", problem.searchAStar(1, goal_states));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>({ TestActions::right, TestActions::right, TestActions::right })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 1, 2, 3, 4 })));
+
+	// This search should find the path 3 with solution {}.
+	ASSERTM("No solution found.", problem.searchAStar(3, std::unordered_set<int>({ 3 })));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>()));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 3 })));
+}
+
+//------------------------------------------------------------------------------------------------------
+
+void FrontierPolicySearchTest()
+{
+	SimpleCyclesProblem problem;
+	graphsearch::DepthFirstFrontier<SimpleCyclesProblem::NodeType> frontier;
+	std::unordered_set<int> goal_states({ 3 });
+	std::vector<TestActions> virtual_solution, policy_solution;
+	std::vector<int> virtual_path, policy_path;
+
+	// Searching with a frontier passed by pointer and with a frontier policy should give the same results.
+	ASSERTM("No solution found.", problem.search(8, goal_states, &frontier));
+	problem.solution(virtual_solution);
+	problem.path(virtual_path);
+	ASSERTM("No solution found.", problem.search<graphsearch::DepthFirstFrontier>(8, goal_states));
+	problem.solution(policy_solution);
+	problem.path(policy_path);
+	ASSERTM("Incorrect solution.", (virtual_solution == policy_solution));
+	ASSERTM("Incorrect path.", (virtual_path == policy_path));
+	ASSERTM("Incorrect path.", (policy_path == std::vector<int>({ 8, 9, 10, 5, 3 })));
+
+	ASSERTM("Searching without a goal should not cause errors.",
+			!problem.search<graphsearch::BreadthFirstFrontier>(9, std::unordered_set<int>()));
+}
+
+//------------------------------------------------------------------------------------------------------
+
+void SimpleSuccessorsProblem::successors(const int& state, SuccessorSink& sink)
+{
+	if (state < 5)
+	{
+		sink.add(TestActions::right, state + 1);
+	}
+	if (state > 1)
+	{
+		sink.add(TestActions::left, state - 1);
+	}
+}
+
+void SimpleSuccessorsProblem::expandState(int state, std::vector<NodeType>& children)
+{
+	expand(state, 0, children);
+}
+
+void SuccessorsSearchTest()
+{
+	SimpleSuccessorsProblem problem;
+	std::unordered_set<int> goal_states({ 1, 4 });
+	std::vector<TestActions> the_solution;
+	std::vector<int> the_path;
+
+	// This search should find the path 5-4 with solution {left}, as in SimpleBreadthFirstSearchTest.
+	ASSERTM("No solution found.", problem.searchBreadthFirst(5, goal_states));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>({ TestActions::left })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 5, 4 })));
+
+	// This search should find the path 2-1 with solution {left}.
+	ASSERTM("No solution found.", problem.searchDepthFirst(2, goal_states));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>({ TestActions::left })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 2, 1 })));
+}
+
+void ZeroAllocationExpandTest()
+{
+	SimpleSuccessorsProblem problem;
+	std::vector<SimpleSuccessorsProblem::NodeType> children;
+	std::size_t allocations_before;
+
+	// Warm up:  grow the vector to the largest number of successors.
+	allocations_before = allocation_count;
+	problem.expandState(3, children);
+	ASSERTM("State 3 should have two successors.", children.size() == 2);
+	ASSERTM("Growing the vector should allocate memory.", allocation_count > allocations_before);
+
+	allocations_before = allocation_count;
+	for (int state = 1; state <= 5; ++state)
+	{
+		problem.expandState(state, children);
+	}
+	ASSERTM("Expanding a node should not allocate memory after warming up.", allocation_count == allocations_before);
+	ASSERTM("State 5 should have one successor.", (children.size() == 1 && children[0].state == 4));
+}
+
+//------------------------------------------------------------------------------------------------------
+
+void FlatStateTableProblem::successors(const SimpleStruct& state, SuccessorSink& sink)
+{
+	sink.add(TestActions::left, SimpleStruct{ state.x == 1 ? 5 : state.x - 1 });
+	sink.add(TestActions::right, SimpleStruct{ state.x == 5 ? 1 : state.x + 1 });
+}
+
+void FlatStateTableSearchTest()
+{
+	FlatStateTableProblem problem;
+	std::unordered_set<SimpleStruct> goal_states({ SimpleStruct{2} });
+	std::vector<TestActions> the_solution;
+	std::vector<SimpleStruct> the_path;
+
+	// These searches should find the same paths as SimpleStructBreadthFirstSearchTest and SimpleStructDepthFirstSearchTest.
+	ASSERTM("No solution found.", problem.searchBreadthFirst(SimpleStruct{ 4 }, goal_states));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>({ TestActions::left, TestActions::left })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<SimpleStruct>({SimpleStruct{ 4 }, SimpleStruct{ 3 }, SimpleStruct{ 2 }})));
+
+	ASSERTM("No solution found.", problem.searchDepthFirst(SimpleStruct{ 5 }, goal_states));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>({ TestActions::right, TestActions::right })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<SimpleStruct>({SimpleStruct{ 5 }, SimpleStruct{ 1 }, SimpleStruct{ 2 }})));
+
+	ASSERTM("No solution found.", problem.searchUniformCost(SimpleStruct{ 5 }, goal_states));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<SimpleStruct>({SimpleStruct{ 5 }, SimpleStruct{ 1 }, SimpleStruct{ 2 }})));
+}
+
+void ReusedSearchAllocationTest()
+{
+	FlatStateTableProblem problem;
+	std::unordered_set<SimpleStruct> goal_states({ SimpleStruct{3} });
+	std::size_t allocations_before = 0;
+
+	// The first round of searches grows the problem's buffers.  The second should reuse them.
+	for (int round = 0; round < 2; ++round)
+	{
+		if (round == 1)
+		{
+			allocations_before = allocation_count;
+		}
+		for (int start = 1; start <= 5; ++start)
+		{
+			ASSERTM("No solution found.", problem.searchDepthFirst(SimpleStruct{ start }, goal_states));
+			ASSERTM("No solution found.", problem.searchUniformCost(SimpleStruct{ start }, goal_states));
+			ASSERTM("No solution found.", problem.searchIterativeDeepening(SimpleStruct{ start }, goal_states, 5));
+		}
+	}
+	ASSERTM("Searching again should not allocate memory.", allocation_count == allocations_before);
+}
+
+//------------------------------------------------------------------------------------------------------
+
+void OpenGridProblem::successors(const int& state, SuccessorSink& sink)
+{
+	int x = state % width;
+	int y = state / width;
+
+	++expanded;
+	if (y > 0)
+	{
+		sink.add(TestActions::up, state - width);
+	}
+	if (y < width - 1)
+	{
+		sink.add(TestActions::down, state + width);
+	}
+	if (x > 0)
+	{
+		sink.add(TestActions::left, state - 1);
+	}
+	if (x < width - 1)
+	{
+		sink.add(TestActions::right, state + 1);
+	}
+}
+
+void OpenGridProblem::predecessors(const int& state, SuccessorSink& sink)
+{
+	int x = state % width;
+	int y = state / width;
+
+	// Every move can be reversed, so the predecessors are the successors, with the opposite actions.
+	++expanded;
+	if (y > 0)
+	{
+		sink.add(TestActions::down, state - width);
+	}
+	if (y < width - 1)
+	{
+		sink.add(TestActions::up, state + width);
+	}
+	if (x > 0)
+	{
+		sink.add(TestActions::right, state - 1);
+	}
+	if (x < width - 1)
+	{
+		sink.add(TestActions::left, state + 1);
+	}
+}
+
+bool OpenGridProblem::isPath(const std::vector<int>& the_path, int start, int goal) const
+{
+	if (the_path.empty() || the_path.front() != start || the_path.back() != goal)
+	{
+		return false;
+	}
+	for (std::size_t i = 1; i < the_path.size(); ++i)
+	{
+		int step = the_path[i] - the_path[i - 1];
+		int x = the_path[i - 1] % width;
+		if (!(step == width || step == -width || (step == 1 && x < width - 1) || (step == -1 && x > 0)))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void ParallelBreadthFirstSearchTest()
+{
+	SimpleCyclesProblem problem;
+	std::vector<TestActions> the_solution;
+	std::vector<int> the_path;
+
+	// This search should find the path 3-2-1 with solution {left, left}.
+	ASSERTM("No solution found.", problem.searchBreadthFirstParallel(3, std::unordered_set<int>({ 1 }), 4));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>({ TestActions::left, TestActions::left })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 3, 2, 1 })));
+
+	// This search should find the path 11-7 with solution {right}.
+	ASSERTM("No solution found.", problem.searchBreadthFirstParallel(11, std::unordered_set<int>({ 7, 3 }), 2));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 11, 7 })));
+
+	// This search should find the path 9 with solution {}.
+	ASSERTM("No solution found.", problem.searchBreadthFirstParallel(9, std::unordered_set<int>({ 9 }), 1));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>()));
+
+	ASSERTM("Searching without a goal should not cause errors.",
+			!problem.searchBreadthFirstParallel(9, std::unordered_set<int>(), 4));
+}
+
+void ParallelGridSearchTest()
+{
+	const int width = 200;
+	OpenGridProblem problem{width};
+	std::unordered_set<int> goal_states({ width * width - 1 });
+	std::vector<TestActions> the_solution;
+	std::vector<int> the_path;
+
+	// The shortest paths from corner to corner take 2 * (width - 1) actions.
+	ASSERTM("No solution found.", problem.searchBreadthFirstParallel(0, goal_states, 4));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution length.", the_solution.size() == 2 * (width - 1));
+	problem.path(the_path);
+	ASSERTM("Incorrect path length.", the_path.size() == 2 * (width - 1) + 1);
+	ASSERTM("Incorrect path.", problem.isPath(the_path, 0, width * width - 1));
+
+	problem.expanded = 0;
+	ASSERTM("Searching without a goal should not cause errors.",
+			!problem.searchBreadthFirstParallel(width / 2, std::unordered_set<int>(), 4));
+	ASSERTM("Every state should be expanded once.", problem.expanded == width * width);
+}
+
+void ParallelDepthFirstSearchTest()
+{
+	SimpleCyclesProblem problem;
+	std::vector<TestActions> the_solution;
+	std::vector<int> the_path;
+
+	// With one thread, the search is an ordinary depth-first search.  It should find the path 4-1 with solution {up}.
+	ASSERTM("No solution found.", problem.searchDepthFirstParallel(4, std::unordered_set<int>({ 1 }), 1));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>({ TestActions::up })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 4, 1 })));
+
+	// With more threads, the search should find some path from 8 to 3.
+	ASSERTM("No solution found.", problem.searchDepthFirstParallel(8, std::unordered_set<int>({ 3 }), 4));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", the_path.front() == 8 && the_path.back() == 3);
+
+	// This search should find the path 9 with solution {}.
+	ASSERTM("No solution found.", problem.searchDepthFirstParallel(9, std::unordered_set<int>({ 9 }), 4));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>()));
+
+	ASSERTM("Searching without a goal should not cause errors.",
+			!problem.searchDepthFirstParallel(9, std::unordered_set<int>(), 4));
+}
+
+/*
+Run the parallel depth-first search repeatedly with more threads than there are likely to be cores, so that threads
+often steal from each other and often find goals at the same time.  Build the tests with -fsanitize=thread to check
+this test for data races.
+*/
+void ParallelTraversalStressTest()
+{
+	const int width = 100;
+	OpenGridProblem problem{width};
+	std::vector<TestActions> the_solution;
+	std::vector<int> the_path;
+
+	for (int repetition = 0; repetition < 20; ++repetition)
+	{
+		int start = (repetition * 7919) % (width * width);
+		int goal = (repetition * 104729 + 1) % (width * width);
+
+		problem.expanded = 0;
+		ASSERTM("Searching without a goal should not cause errors.",
+				!problem.searchDepthFirstParallel(start, std::unordered_set<int>(), 8));
+		ASSERTM("Every state should be expanded once.", problem.expanded == width * width);
+
+		ASSERTM("No solution found.", problem.searchDepthFirstParallel(start, std::unordered_set<int>({ goal }), 8));
+		problem.solution(the_solution);
+		problem.path(the_path);
+		ASSERTM("Incorrect path.", problem.isPath(the_path, start, goal));
+		ASSERTM("The path should have one more state than the solution has actions.", the_path.size() == the_solution.size() + 1);
+	}
+}
+
+void BidirectionalSearchTest()
+{
+	const int width = 200;
+	OpenGridProblem problem{width};
+	std::vector<TestActions> the_solution;
+	std::vector<int> the_path;
+
+	int start = (width / 2) * width + width / 4;
+	int goal = start + width / 2;
+	long breadth_first_expanded;
+
+	// The shortest paths from corner to corner take 2 * (width - 1) actions.
+	ASSERTM("No solution found.", problem.searchBidirectional(0, std::unordered_set<int>({ width * width - 1 })));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution length.", the_solution.size() == 2 * (width - 1));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", problem.isPath(the_path, 0, width * width - 1));
+
+	// Away from the edges, two searches to half the depth should expand about half as many nodes as one search.
+	problem.expanded = 0;
+	ASSERTM("No solution found.", problem.searchBreadthFirstParallel(start, std::unordered_set<int>({ goal }), 1));
+	breadth_first_expanded = problem.expanded;
+	problem.expanded = 0;
+	ASSERTM("No solution found.", problem.searchBidirectional(start, std::unordered_set<int>({ goal })));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution length.", the_solution.size() == width / 2);
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", problem.isPath(the_path, start, goal));
+	ASSERTM("The search should expand fewer nodes than breadth-first search.", problem.expanded < breadth_first_expanded * 7 / 10);
+
+	// This search should find the path 2-1-0 with solution {left, left}, which is shorter than the path to the other goal.
+	ASSERTM("No solution found.", problem.searchBidirectional(2, std::unordered_set<int>({ 0, 5 * width + 2 })));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>({ TestActions::left, TestActions::left })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 2, 1, 0 })));
+
+	// This search should find the path 7 with solution {}.
+	ASSERTM("No solution found.", problem.searchBidirectional(7, std::unordered_set<int>({ 7 })));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>()));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 7 })));
+
+	ASSERTM("Searching without a goal should find nothing.", !problem.searchBidirectional(7, std::unordered_set<int>()));
+}
+
+void IterativeDeepeningSearchTest()
+{
+	SimpleCyclesProblem problem;
+	OpenGridProblem grid{6};
+	std::vector<TestActions> the_solution;
+	std::vector<int> the_path;
+	long expanded_without_transpositions;
+
+	// This search should find the path 8-4-1-2-3 with solution {up, up, right, right}.  The path 8-9-10-5-3 is as short,
+	// but the search tries the actions in order, and "up" comes before "right."
+	ASSERTM("No solution found.", problem.searchIterativeDeepening(8, std::unordered_set<int>({ 3 }), 10));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>({ TestActions::up, TestActions::up, TestActions::right, TestActions::right })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 8, 4, 1, 2, 3 })));
+
+	// This search should find the path 9-8-4-1 with solution {left, up, up}.
+	ASSERTM("No solution found.", problem.searchIterativeDeepening(9, std::unordered_set<int>({ 1, 6 }), 10));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>({ TestActions::left, TestActions::up, TestActions::up })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 9, 8, 4, 1 })));
+
+	ASSERTM("The goal is deeper than the limit.", !problem.searchIterativeDeepening(8, std::unordered_set<int>({ 3 }), 3));
+	ASSERTM("Searching without a goal should not cause errors.", !problem.searchIterativeDeepening(9, std::unordered_set<int>(), 100));
+
+	// Remembering states should find the same length of solution while expanding fewer nodes.
+	ASSERTM("No solution found.", grid.searchIterativeDeepening(0, std::unordered_set<int>({ 35 }), 20));
+	grid.solution(the_solution);
+	ASSERTM("Incorrect solution length.", the_solution.size() == 10);
+	expanded_without_transpositions = grid.expanded;
+	grid.expanded = 0;
+	ASSERTM("No solution found.", grid.searchIterativeDeepening(0, std::unordered_set<int>({ 35 }), 20, 36));
+	grid.solution(the_solution);
+	ASSERTM("Incorrect solution length.", the_solution.size() == 10);
+	grid.path(the_path);
+	ASSERTM("Incorrect path.", grid.isPath(the_path, 0, 35));
+	ASSERTM("The search should expand fewer nodes with transpositions.", grid.expanded < expanded_without_transpositions);
+}
+
+void IDAStarSearchTest()
+{
+	WeightedProblem problem;
+	std::unordered_set<int> goal_states({ 4 });
+	std::vector<TestActions> the_solution;
+	std::vector<int> the_path;
+
+	// This search should find the cheapest path 1-2-3-4 with solution {right, right, right}.
+	ASSERTM("No solution found.", problem.searchIDAStar(1, goal_states));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>({ TestActions::right, TestActions::right, TestActions::right })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 1, 2, 3, 4 })));
+
+	// This search should find the path 3 with solution {}.
+	ASSERTM("No solution found.", problem.searchIDAStar(3, std::unordered_set<int>({ 3 })));
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", (the_solution == std::vector<TestActions>()));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 3 })));
+
+	ASSERTM("The cheapest path costs more than the limit.", !problem.searchIDAStar(1, goal_states, 2.0));
+	ASSERTM("Searching without a goal should not cause errors.", !problem.searchIDAStar(2, std::unordered_set<int>()));
+}
+
+//------------------------------------------------------------------------------------------------------
+
+void StatsLineProblem::successors(const int& state, SuccessorSink& sink)
+{
+	if (state > 0)
+	{
+		sink.add(TestActions::left, state - 1);
+	}
+	if (state < length - 1)
+	{
+		sink.add(TestActions::right, state + 1);
+	}
+}
+
+void StatsLineProblem::progress(const graphsearch::SearchStats& stats)
+{
+	progress_reports.push_back(stats.nodes_expanded);
+}
+
+void SearchStatsTest()
+{
+	StatsLineProblem problem{10};
+
+	// Breadth-first search from 0 to 9 expands 0 through 8.  Each node after the first finds its parent again.
+	ASSERTM("No solution found.", problem.searchBreadthFirst(0, std::unordered_set<int>({ 9 })));
+	ASSERTM("Incorrect nodes expanded.", problem.stats().nodes_expanded == 9);
+	ASSERTM("Incorrect nodes generated.", problem.stats().nodes_generated == 17);
+	ASSERTM("Incorrect duplicate hits.", problem.stats().duplicate_hits == 8);
+	ASSERTM("Incorrect peak frontier.", problem.stats().peak_frontier == 1);
+	ASSERTM("Incorrect peak nodes.", problem.stats().peak_nodes == 10);
+	ASSERTM("Incorrect maximum depth.", problem.stats().max_depth == 8);
+	ASSERTM("The search should take at least as long as its successors.",
+		problem.stats().search_time >= problem.stats().successor_time);
+	ASSERTM("No progress reports were requested.", problem.progress_reports.empty());
+
+	// Each search starts its statistics over.
+	problem.setProgressInterval(4);
+	ASSERTM("Searching without a goal should not cause errors.", !problem.searchUniformCost(0, std::unordered_set<int>()));
+	ASSERTM("Incorrect nodes expanded.", problem.stats().nodes_expanded == 10);
+	ASSERTM("Incorrect maximum depth.", problem.stats().max_depth == 9);
+	ASSERTM("Incorrect progress reports.", (problem.progress_reports == std::vector<std::size_t>({ 4, 8 })));
+
+	// Iterative deepening keeps only the path.  Its rounds to depths 0 through 3 expand 1, 2, 3, and 3 nodes (not the
+	// goal), and the rounds to depths 2 and 3 find a node's parent on the path 1 and 2 times.
+	problem.setProgressInterval(0);
+	ASSERTM("No solution found.", problem.searchIterativeDeepening(0, std::unordered_set<int>({ 3 }), 5));
+	ASSERTM("Incorrect nodes expanded.", problem.stats().nodes_expanded == 1 + 2 + 3 + 3);
+	ASSERTM("Incorrect peak nodes.", problem.stats().peak_nodes == 4);
+	ASSERTM("Incorrect maximum depth.", problem.stats().max_depth == 2);
+	ASSERTM("Incorrect duplicate hits.", problem.stats().duplicate_hits == 0 + 1 + 2);
+}
+
+void ParallelSearchStatsTest()
+{
+	StatsLineProblem problem{1000};
+
+	// The threads' counts add up to the same totals as a serial search.
+	ASSERTM("Searching without a goal should not cause errors.", !problem.searchBreadthFirstParallel(500, std::unordered_set<int>(), 4));
+	ASSERTM("Incorrect nodes expanded.", problem.stats().nodes_expanded == 1000);
+	ASSERTM("Incorrect nodes generated.", problem.stats().nodes_generated == 2 * 1000 - 2);
+	ASSERTM("Incorrect duplicate hits.", problem.stats().duplicate_hits == 1000 - 2 + 1);
+	ASSERTM("Incorrect maximum depth.", problem.stats().max_depth == 500);
+	ASSERTM("Incorrect peak nodes.", problem.stats().peak_nodes == 1000);
+
+	ASSERTM("Searching without a goal should not cause errors.", !problem.searchDepthFirstParallel(0, std::unordered_set<int>(), 4));
+	ASSERTM("Incorrect nodes expanded.", problem.stats().nodes_expanded == 1000);
+	ASSERTM("Incorrect maximum depth.", problem.stats().max_depth == 999);
+	ASSERTM("Incorrect peak nodes.", problem.stats().peak_nodes == 1000);
+}
+
+//------------------------------------------------------------------------------------------------------
+
+void ArenaGridProblem::successors(const int& state, SuccessorSink& sink)
+{
+	int x = state % width;
+	int y = state / width;
+
+	if (y > 0)
+	{
+		sink.add(TestActions::up, state - width);
+	}
+	if (y < width - 1)
+	{
+		sink.add(TestActions::down, state + width);
+	}
+	if (x > 0)
+	{
+		sink.add(TestActions::left, state - 1);
+	}
+	if (x < width - 1)
+	{
+		sink.add(TestActions::right, state + 1);
+	}
+}
+
+void ArenaGridProblem::predecessors(const int& state, SuccessorSink& sink)
+{
+	int x = state % width;
+	int y = state / width;
+
+	if (y > 0)
+	{
+		sink.add(TestActions::down, state - width);
+	}
+	if (y < width - 1)
+	{
+		sink.add(TestActions::up, state + width);
+	}
+	if (x > 0)
+	{
+		sink.add(TestActions::right, state - 1);
+	}
+	if (x < width - 1)
+	{
+		sink.add(TestActions::left, state + 1);
+	}
+}
+
+void ArenaSearchTest()
+{
+	graphsearch::MonotonicArena arena{1024};
+	OpenGridProblem reference{8};
+	std::unordered_set<int> goal_states({ 8 * 8 - 1 });
+	std::vector<int> the_path;
+	std::size_t allocations_before;
+	std::size_t reference_allocations;
+
+	// Every serial search and the bidirectional search should find a path with the arena, and a shortest one if it should.
+	{
+		ArenaGridProblem problem{arena, 8};
+
+		ASSERTM("No solution found.", problem.searchBreadthFirst(0, goal_states));
+		problem.path(the_path);
+		ASSERTM("Incorrect path.", reference.isPath(the_path, 0, 8 * 8 - 1) && the_path.size() == 15);
+		ASSERTM("No solution found.", problem.searchDepthFirst(0, goal_states));
+		problem.path(the_path);
+		ASSERTM("Incorrect path.", reference.isPath(the_path, 0, 8 * 8 - 1));
+		ASSERTM("No solution found.", problem.searchUniformCost(0, goal_states));
+		problem.path(the_path);
+		ASSERTM("Incorrect path.", reference.isPath(the_path, 0, 8 * 8 - 1) && the_path.size() == 15);
+		ASSERTM("No solution found.", problem.searchBidirectional(0, goal_states));
+		problem.path(the_path);
+		ASSERTM("Incorrect path.", reference.isPath(the_path, 0, 8 * 8 - 1) && the_path.size() == 15);
+		ASSERTM("No solution found.", problem.searchIterativeDeepening(0, std::unordered_set<int>({ 2 * 8 + 2 }), 4, 100));
+		problem.path(the_path);
+		ASSERTM("Incorrect path.", reference.isPath(the_path, 0, 2 * 8 + 2) && the_path.size() == 5);
+		ASSERTM("The problem should allocate from the arena.", arena.bytesAllocated() > 0);
+	}
+
+	// Once the problem is gone, the arena can be released all at once and reused.  A new problem that allocates from
+	// it should call the global allocator far less often than a problem that doesn't.
+	arena.release();
+	allocations_before = allocation_count;
+	{
+		OpenGridProblem problem{8};
+		ASSERTM("No solution found.", problem.searchBreadthFirst(0, goal_states));
+	}
+	reference_allocations = allocation_count - allocations_before;
+	allocations_before = allocation_count;
+	{
+		ArenaGridProblem problem{arena, 8};
+		ASSERTM("No solution found.", problem.searchBreadthFirst(0, goal_states));
+	}
+	ASSERTM("The arena should replace most allocations.", (allocation_count - allocations_before) * 4 < reference_allocations);
+}
+
+void ExternalBreadthFirstSearchTest()
+{
+	const int width = 100;
+	OpenGridProblem problem{width};
+	std::vector<int> the_path;
+	std::vector<TestActions> the_solution;
+
+	// A budget of 16 KB holds about 700 successors, a small fraction of the 10,000 states.
+	ASSERTM("No solution found.", problem.searchBreadthFirstExternal(0, std::unordered_set<int>({ width * width - 1 }), ".", 16 * 1024));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", problem.isPath(the_path, 0, width * width - 1) && the_path.size() == 2 * width - 1);
+	problem.solution(the_solution);
+	ASSERTM("Incorrect solution.", the_solution.size() == 2 * width - 2);
+
+	ASSERTM("No solution found.", problem.searchBreadthFirstExternal(5, std::unordered_set<int>({ 5 }), ".", 16 * 1024));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", the_path == std::vector<int>({ 5 }));
+
+	// An exhaustive search expands every state once.
+	problem.expanded = 0;
+	ASSERTM("Searching without a goal should not cause errors.", !problem.searchBreadthFirstExternal(0, std::unordered_set<int>(), ".", 16 * 1024));
+	ASSERTM("Incorrect nodes expanded.", problem.expanded == width * width);
+}
+
+void ResultKindTest()
+{
+	const int width = 8;
+	OpenGridProblem problem{width};
+	WeightedProblem weighted;
+	std::unordered_set<int> goal_states({ width * width - 1 });
+	std::vector<TestActions> the_solution;
+	std::vector<int> the_path;
+
+	// Every search should report the same distance with and without the path, and only the path mode keeps the path.
+	problem.setResultKind(graphsearch::ResultKind::distance);
+	ASSERTM("No solution found.", problem.searchBreadthFirst(0, goal_states));
+	ASSERTM("Incorrect distance.", problem.distance() == 2 * width - 2);
+	ASSERT_THROWSM("Asking for a path the search didn't record should raise an exception.", problem.path(the_path), const char*);
+	ASSERT_THROWSM("Asking for a solution the search didn't record should raise an exception.",
+			problem.solution(the_solution), const char*);
+	ASSERTM("No solution found.", problem.searchUniformCost(0, goal_states));
+	ASSERTM("Incorrect distance.", problem.distance() == 2 * width - 2);
+	ASSERTM("No solution found.", problem.searchAStar(0, goal_states));
+	ASSERTM("Incorrect distance.", problem.distance() == 2 * width - 2);
+	ASSERTM("No solution found.", problem.searchBidirectional(0, goal_states));
+	ASSERTM("Incorrect distance.", problem.distance() == 2 * width - 2);
+	ASSERTM("No solution found.", problem.searchIterativeDeepening(0, std::unordered_set<int>({ 2 * width + 2 }), 4, 100));
+	ASSERTM("Incorrect distance.", problem.distance() == 4);
+	ASSERTM("No solution found.", problem.searchBreadthFirstParallel(0, goal_states, 4));
+	ASSERTM("Incorrect distance.", problem.distance() == 2 * width - 2);
+	ASSERTM("No solution found.", problem.searchDepthFirstParallel(0, goal_states, 4));
+	ASSERTM("A depth-first distance is at least the shortest.", problem.distance() >= 2 * width - 2);
+	ASSERTM("No solution found.", problem.searchBreadthFirstExternal(0, goal_states, ".", 1024));
+	ASSERTM("Incorrect distance.", problem.distance() == 2 * width - 2);
+	ASSERTM("No solution found.", problem.searchBreadthFirst(5, std::unordered_set<int>({ 5 })));
+	ASSERTM("Incorrect distance.", problem.distance() == 0);
+
+	// Reachability records nothing but the answer.
+	problem.setResultKind(graphsearch::ResultKind::reachability);
+	ASSERTM("No solution found.", problem.searchBreadthFirst(0, goal_states));
+	ASSERT_THROWSM("Asking for a distance the search didn't record should raise an exception.", problem.distance(), const char*);
+	ASSERTM("A state off the grid should be unreachable.", !problem.searchDepthFirst(0, std::unordered_set<int>({ -1 })));
+	ASSERT_THROWSM("Asking for a distance when a solution isn't available should raise an exception.", problem.distance(), const char*);
+
+	// The path mode records the distance, too, as path cost for the searches that use step costs.
+	problem.setResultKind(graphsearch::ResultKind::path);
+	ASSERTM("No solution found.", problem.searchBreadthFirstParallel(0, goal_states, 4));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", problem.isPath(the_path, 0, width * width - 1) && problem.distance() == the_path.size() - 1);
+	ASSERTM("No solution found.", weighted.searchBreadthFirst(1, std::unordered_set<int>({ 4 })));
+	ASSERTM("Incorrect distance.", weighted.distance() == 1);
+	ASSERTM("No solution found.", weighted.searchUniformCost(1, std::unordered_set<int>({ 4 })));
+	ASSERTM("Incorrect distance.", weighted.distance() == 3);
+	ASSERTM("No solution found.", weighted.searchIDAStar(1, std::unordered_set<int>({ 4 })));
+	ASSERTM("Incorrect distance.", weighted.distance() == 3);
+}
+
+void MultiSourceSearchTest()
+{
+	const int width = 8;
+	OpenGridProblem problem{width};
+	std::vector<int> the_path;
+
+	// The goal is next to the last source, so the path should start there.
+	ASSERTM("No solution found.", problem.searchBreadthFirstMultiSource(std::vector<int>({ 0, 7, width * width - 1 }),
+			std::unordered_set<int>({ width * width - 2 })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ width * width - 1, width * width - 2 })));
+
+	// A source that is a goal is its own path.
+	ASSERTM("No solution found.", problem.searchBreadthFirstMultiSource(std::vector<int>({ 0, 9 }), std::unordered_set<int>({ 9 })));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", the_path == std::vector<int>({ 9 }));
+
+	ASSERTM("Searching from no sources should find nothing.", !problem.searchBreadthFirstMultiSource(std::vector<int>(),
+			std::unordered_set<int>({ 9 })));
+}
+
+void NearestSourceSearchTest()
+{
+	const int width = 8;
+	OpenGridProblem problem{width};
+	std::vector<int> sources({ 0, width - 1, width * width - 1, 0 });
+	std::vector<int> goals({ 1, 2 * width - 1, width * width - 2, 1, -1 });  // One goal twice and one off the grid
+	std::vector<std::uint32_t> nearest_sources, distances;
+
+	problem.searchBreadthFirstNearest(sources, goals, nearest_sources, distances);
+	ASSERTM("Incorrect nearest sources.", (nearest_sources == std::vector<std::uint32_t>({ 0, 1, 2, 0, OpenGridProblem::unreachable })));
+	ASSERTM("Incorrect distances.", (distances == std::vector<std::uint32_t>({ 1, 1, 1, 1, OpenGridProblem::unreachable })));
+
+	// The search stops once it has reached every goal.
+	problem.expanded = 0;
+	problem.searchBreadthFirstNearest(std::vector<int>({ 0 }), std::vector<int>({ 1 }), nearest_sources, distances);
+	ASSERTM("Incorrect nodes expanded.", problem.expanded == 1 && distances == std::vector<std::uint32_t>({ 1 }));
+}
+
+void BatchSearchTest()
+{
+	const int width = 8;
+	OpenGridProblem problem{width};
+	std::vector<int> sources, goals;
+	std::vector<std::uint32_t> distances;
+
+	// More than 64 queries take two groups.  The last two goals are off the grid and the same as the source.
+	for (int i = 0; i < 70; ++i)
+	{
+		sources.push_back(i * 5 % (width * width));
+		goals.push_back(i * 11 % (width * width));
+	}
+	goals[68] = -1;
+	goals[69] = sources[69];
+	problem.searchBreadthFirstBatch(sources, goals, distances);
+	ASSERTM("Incorrect number of distances.", distances.size() == sources.size());
+	for (std::size_t i = 0; i < sources.size(); ++i)
+	{
+		std::uint32_t expected = OpenGridProblem::unreachable;
+		if (goals[i] >= 0)
+		{
+			expected = std::abs(sources[i] % width - goals[i] % width) + std::abs(sources[i] / width - goals[i] / width);
+		}
+		ASSERTM("Incorrect distance.", distances[i] == expected);
+	}
+
+	// The batch expands each state at most once, however many queries reach it.
+	ASSERTM("Incorrect nodes expanded.", problem.expanded <= width * width);
+	ASSERT_THROWSM("A batch doesn't record a path.", problem.distance(), const char*);
+	ASSERT_THROWSM("A batch needs a goal per source.", problem.searchBreadthFirstBatch(sources, std::vector<int>(), distances),
+			const char*);
+}
+
+void SuccessorCacheSearchTest()
+{
+	const int width = 8;
+	OpenGridProblem problem{width};
+	std::unordered_set<int> goal_states({ width * width - 1 });
+	std::vector<int> the_path;
+	long first_expanded;
+
+	ASSERTM("The successor cache should be off by default.", problem.successorCache() == nullptr);
+	problem.setSuccessorCache(1 << 20);
+	ASSERTM("No solution found.", problem.searchUniformCost(0, goal_states));
+	first_expanded = problem.expanded;
+	ASSERTM("The first search should miss the cache for every state.", problem.successorCache()->hits() == 0
+			&& problem.successorCache()->misses() == (std::size_t)first_expanded);
+
+	// A second search of the same states should take all of their successors from the cache.
+	ASSERTM("No solution found.", problem.searchUniformCost(0, goal_states));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", problem.isPath(the_path, 0, width * width - 1) && the_path.size() == 2 * width - 1);
+	ASSERTM("The second search should not call successors.", problem.expanded == first_expanded);
+	ASSERTM("The second search should hit the cache for every state.", problem.successorCache()->hits() == (std::size_t)first_expanded);
+
+	// The parallel searches share the cache.
+	ASSERTM("No solution found.", problem.searchBreadthFirstParallel(0, goal_states, 4));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", problem.isPath(the_path, 0, width * width - 1) && the_path.size() == 2 * width - 1);
+	ASSERTM("Searching without a goal should not cause errors.", !problem.searchDepthFirstParallel(0, std::unordered_set<int>(), 4));
+	ASSERTM("Every state should now be cached.", problem.successorCache()->size() == width * width);
+
+	// A cache too small for every state should stay within its budget and still give correct successors.
+	problem.setSuccessorCache(1024);
+	ASSERTM("No solution found.", problem.searchUniformCost(0, goal_states));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", problem.isPath(the_path, 0, width * width - 1) && the_path.size() == 2 * width - 1);
+	ASSERTM("The cache should evict lists.", problem.successorCache()->bytesUsed() <= 1024 && problem.successorCache()->evictions() > 0);
+
+	problem.setSuccessorCache(0);
+	ASSERTM("A budget of 0 should turn the cache off.", problem.successorCache() == nullptr);
+}
+
+void DenseBreadthFirstSearchTest()
+{
+	// On the small grid most levels are large enough to be bitmaps, and on the large one, none are.
+	for (int width : { 20, 200 })
+	{
+		OpenGridProblem problem{width};
+		std::size_t num_states = (std::size_t)(width * width);
+		std::unordered_set<int> goal_states({ width * width - 1 });
+		std::vector<TestActions> the_solution;
+		std::vector<int> the_path;
+
+		ASSERTM("No solution found.", problem.searchBreadthFirstDense(0, goal_states, num_states));
+		problem.solution(the_solution);
+		ASSERTM("Incorrect solution length.", the_solution.size() == (std::size_t)(2 * (width - 1)));
+		problem.path(the_path);
+		ASSERTM("Incorrect path.", problem.isPath(the_path, 0, width * width - 1));
+		ASSERTM("Incorrect distance.", problem.distance() == 2 * (width - 1));
+
+		problem.setResultKind(graphsearch::ResultKind::distance);
+		ASSERTM("No solution found.", problem.searchBreadthFirstDense(width / 2, goal_states, num_states));
+		ASSERTM("Incorrect distance.", problem.distance() == 2 * (width - 1) - width / 2);
+
+		problem.expanded = 0;
+		ASSERTM("Searching without a goal should not cause errors.",
+				!problem.searchBreadthFirstDense(width / 2, std::unordered_set<int>(), num_states));
+		ASSERTM("Every state should be expanded once.", problem.expanded == width * width);
+		ASSERTM("The initial state should be a solution.", problem.searchBreadthFirstDense(5, std::unordered_set<int>({ 5 }),
+				num_states) && problem.distance() == 0.0);
+	}
+
+	OpenGridProblem problem{10};
+	ASSERT_THROWSM("A state outside the states should raise an exception.",
+			problem.searchBreadthFirstDense(0, std::unordered_set<int>({ 99 }), 50), const char*);
+}
+
+void GoalOnGenerationTest()
+{
+	const int width = 10;
+	OpenGridProblem problem{width};
+	std::vector<int> the_path;
+
+	// State 0 generates width, then 1.  The search stops at 1 without expanding width first.
+	ASSERTM("No solution found.", problem.searchBreadthFirst(0, std::unordered_set<int>({ 1 })));
+	ASSERTM("Only the initial state should be expanded.", problem.expanded == 1);
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 0, 1 })));
+
+	// A goal is still tested when its node leaves the frontier of a search with a frontier of its own.
+	problem.expanded = 0;
+	ASSERTM("No solution found.", problem.search<graphsearch::BreadthFirstFrontier>(0, std::unordered_set<int>({ 1 })));
+	ASSERTM("The states before the goal should be expanded.", problem.expanded == 2);
+
+	// The dense search expands the states of its path again to find their actions, unless it doesn't keep the path.
+	problem.expanded = 0;
+	problem.setResultKind(graphsearch::ResultKind::distance);
+	ASSERTM("No solution found.", problem.searchBreadthFirstDense(0, std::unordered_set<int>({ 1 }), width * width));
+	ASSERTM("Only the initial state should be expanded.", problem.expanded == 1);
+	problem.setResultKind(graphsearch::ResultKind::path);
+
+	problem.expanded = 0;
+	ASSERTM("No solution found.", problem.searchBreadthFirstMultiSource(std::vector<int>({ 55, 7 }),
+			std::unordered_set<int>({ 7 })));
+	ASSERTM("An initial goal should be found without expanding anything.", problem.expanded == 0);
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", (the_path == std::vector<int>({ 7 })));
+}
+
+bool BottomRowGridProblem::isGoal(const int& state) const
+{
+	return state >= width * (width - 1);
+}
+
+void GoalPredicateSearchTest()
+{
+	const int width = 30;
+	BottomRowGridProblem problem{width};
+	std::vector<int> the_path;
+
+	// The nearest goal from the middle of row 10 is straight down.
+	ASSERTM("No solution found.", problem.searchBreadthFirst(10 * width + width / 2));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", problem.isPath(the_path, 10 * width + width / 2, (width - 1) * width + width / 2));
+	ASSERTM("Incorrect distance.", problem.distance() == width - 11);
+
+	ASSERTM("No solution found.", problem.searchUniformCost(10 * width));
+	ASSERTM("Incorrect distance.", problem.distance() == width - 11);
+	ASSERTM("No solution found.", problem.searchAStar(10 * width));
+	ASSERTM("Incorrect distance.", problem.distance() == width - 11);
+	ASSERTM("No solution found.", problem.searchBreadthFirstDense(10 * width, width * width));
+	ASSERTM("Incorrect distance.", problem.distance() == width - 11);
+	ASSERTM("No solution found.", problem.searchBreadthFirstMultiSource(std::vector<int>({ 0, 20 * width })));
+	ASSERTM("Incorrect distance.", problem.distance() == width - 21);
+	ASSERTM("No solution found.", problem.searchDepthFirst(0));
+	problem.path(the_path);
+	ASSERTM("The path should end in the bottom row.", the_path.back() >= width * (width - 1));
+
+	// Given a set of goal states, the search doesn't call isGoal.
+	ASSERTM("No solution found.", problem.searchBreadthFirst(0, std::unordered_set<int>({ 2 })));
+	ASSERTM("Incorrect distance.", problem.distance() == 2);
+
+	OpenGridProblem no_predicate{width};
+	ASSERT_THROWSM("Searching without goal states or isGoal should raise an exception.", no_predicate.searchBreadthFirst(0),
+			const char*);
+}
+
+void CompleteGraphProblem::successors(const int& state, SuccessorSink& sink)
+{
+	for (int successor = 0; successor < size; ++successor)
+	{
+		if (successor != state)
+		{
+			sink.add(TestActions::right, successor);
+		}
+	}
+}
+
+void StateMarkingTest()
+{
+	const int size = 50;
+	CompleteGraphProblem problem{size};
+	std::vector<int> the_path;
+
+	// Marking states on generation, each state enters the frontier once.
+	ASSERTM("No solution found.", problem.searchBreadthFirst(0, std::unordered_set<int>({ size - 1 })));
+	ASSERTM("Incorrect distance.", problem.distance() == 1);
+	ASSERTM("No solution should be found.", !problem.searchBreadthFirst(0, std::unordered_set<int>({ size })));
+	ASSERTM("Every state should be expanded once.", problem.stats().nodes_expanded == size);
+	ASSERTM("The frontier should never hold more nodes than there are states.", problem.stats().peak_frontier < size);
+	ASSERTM("No solution should be found.", !problem.searchDepthFirst(0, std::unordered_set<int>({ size })));
+	ASSERTM("Every state should be expanded once.", problem.stats().nodes_expanded == size);
+	ASSERTM("The frontier should never hold more nodes than there are states.", problem.stats().peak_frontier < size);
+
+	// Marking states on expansion, a state enters the frontier once for each state expanded before it, but is still
+	// expanded once.
+	problem.setStateMarking(graphsearch::StateMarking::on_expansion);
+	ASSERTM("No solution should be found.", !problem.searchBreadthFirst(0, std::unordered_set<int>({ size })));
+	ASSERTM("Every state should be expanded once.", problem.stats().nodes_expanded == size);
+	ASSERTM("The frontier should hold duplicate nodes.", problem.stats().peak_frontier > std::size_t{size});
+	ASSERTM("No solution should be found.", !problem.searchDepthFirst(0, std::unordered_set<int>({ size })));
+	ASSERTM("Every state should be expanded once.", problem.stats().nodes_expanded == size);
+
+	// Depth-first search then follows the newest path to each state, so it reaches the last state generated first.
+	ASSERTM("No solution found.", problem.searchDepthFirst(0, std::unordered_set<int>({ 1 })));
+	problem.path(the_path);
+	ASSERTM("The path should go through every state.", the_path.size() == size);
+	ASSERTM("No solution found.", problem.searchBreadthFirst(0, std::unordered_set<int>({ size - 1 })));
+	ASSERTM("Incorrect distance.", problem.distance() == 1);
+}
+
+void SearchLimitsTest()
+{
+	const int width = 20;
+	typedef graphsearch::SearchStatus (OpenGridProblem::*LimitedSearch)(int, const std::unordered_set<int>&,
+		const graphsearch::SearchLimits&);
+	const LimitedSearch searches[] = { &OpenGridProblem::searchDepthFirst, &OpenGridProblem::searchBreadthFirst,
+		&OpenGridProblem::searchUniformCost, &OpenGridProblem::searchAStar };
+	OpenGridProblem problem{width};
+	std::unordered_set<int> goal_states({ width * width - 1 });
+	graphsearch::SearchLimits limits;
+	std::vector<int> the_path;
+
+	// Without limits, each search finishes as the unlimited one does.
+	for (LimitedSearch search : searches)
+	{
+		ASSERTM("The search should find the goal.", (problem.*search)(0, goal_states, limits) == graphsearch::SearchStatus::found);
+		problem.path(the_path);
+		ASSERTM("Incorrect path.", problem.isPath(the_path, 0, width * width - 1));
+		ASSERTM("The search should find that there is no goal.",
+			(problem.*search)(0, std::unordered_set<int>({ -1 }), limits) == graphsearch::SearchStatus::not_found);
+	}
+
+	// Each search stops after the nodes in its budget.
+	limits.max_expansions = 10;
+	for (LimitedSearch search : searches)
+	{
+		problem.expanded = 0;
+		ASSERTM("The search should stop at its budget.",
+			(problem.*search)(0, goal_states, limits) == graphsearch::SearchStatus::budget_exhausted);
+		ASSERTM("The search should expand the nodes in its budget.", problem.expanded == 10);
+		ASSERT_THROWSM("A stopped search has no path.", problem.path(the_path), const char*);
+	}
+
+	// A search stops at a deadline that has passed before it expands a node, and when it is cancelled.
+	graphsearch::CancellationToken token;
+	limits = graphsearch::SearchLimits();
+	limits.deadline = graphsearch::SearchLimits::Clock::now() - std::chrono::seconds(1);
+	problem.expanded = 0;
+	ASSERTM("The search should stop at its deadline.",
+		problem.searchBreadthFirst(0, goal_states, limits) == graphsearch::SearchStatus::deadline_passed);
+	limits = graphsearch::SearchLimits();
+	limits.cancellation = &token;
+	token.cancel();
+	ASSERTM("The search should be cancelled.",
+		problem.searchAStar(0, goal_states, limits) == graphsearch::SearchStatus::cancelled);
+	ASSERTM("Nothing should be expanded.", problem.expanded == 0);
+	token.reset();
+	ASSERTM("Once the token is reset, the search should finish.",
+		problem.searchAStar(0, goal_states, limits) == graphsearch::SearchStatus::found);
+	ASSERTM("Incorrect distance.", problem.distance() == 2 * (width - 1));
+	ASSERTM("A search that finishes didn't stop early.", !graphsearch::stoppedEarly(graphsearch::SearchStatus::found));
+}
+
+void ResumeSearchTest()
+{
+	const int width = 20;
+	typedef bool (OpenGridProblem::*Search)(int, const std::unordered_set<int>&);
+	typedef graphsearch::SearchStatus (OpenGridProblem::*LimitedSearch)(int, const std::unordered_set<int>&,
+		const graphsearch::SearchLimits&);
+	const Search searches[] = { &OpenGridProblem::searchDepthFirst, &OpenGridProblem::searchBreadthFirst,
+		&OpenGridProblem::searchUniformCost, &OpenGridProblem::searchAStar };
+	const LimitedSearch limited_searches[] = { &OpenGridProblem::searchDepthFirst, &OpenGridProblem::searchBreadthFirst,
+		&OpenGridProblem::searchUniformCost, &OpenGridProblem::searchAStar };
+	OpenGridProblem problem{width};
+	std::unordered_set<int> goal_states({ width * width - 1 });
+	graphsearch::SearchLimits limits;
+	std::vector<int> the_path, resumed_path;
+
+	// A search resumed in small steps does the same work, and finds the same path, as the search run at once.
+	limits.max_expansions = 7;
+	for (int i = 0; i < 4; ++i)
+	{
+		problem.expanded = 0;
+		ASSERTM("No solution found.", (problem.*searches[i])(0, goal_states));
+		long expanded = problem.expanded;
+		problem.path(the_path);
+
+		problem.expanded = 0;
+		graphsearch::SearchStatus status = (problem.*limited_searches[i])(0, goal_states, limits);
+		int calls = 1;
+		while (status == graphsearch::SearchStatus::budget_exhausted)
+		{
+			status = problem.resumeSearch(goal_states, limits);
+			++calls;
+		}
+		ASSERTM("The resumed search should find the goal.", status == graphsearch::SearchStatus::found);
+		ASSERTM("The resumed search should expand as many nodes.", problem.expanded == expanded);
+		ASSERTM("The search should take several calls.", calls > 1 && calls >= expanded / 7);
+		problem.path(resumed_path);
+		ASSERTM("The resumed search should find the same path.", resumed_path == the_path);
+		ASSERT_THROWSM("A finished search can't be resumed.", problem.resumeSearch(goal_states, limits), const char*);
+	}
+
+	// A search for the goals that isGoal recognizes resumes with them.
+	BottomRowGridProblem bottom_row{width};
+	ASSERTM("The search should stop at its budget.",
+		bottom_row.searchBreadthFirst(0, limits) == graphsearch::SearchStatus::budget_exhausted);
+	limits.max_expansions = std::numeric_limits<std::size_t>::max();
+	ASSERTM("The resumed search should find the goal.", bottom_row.resumeSearch(limits) == graphsearch::SearchStatus::found);
+	ASSERTM("Incorrect distance.", bottom_row.distance() == width - 1);
+
+	// A stopped search can't be resumed after another search begins, or with other settings.
+	limits.max_expansions = 7;
+	ASSERT_THROWSM("There is no search to resume yet.", OpenGridProblem{width}.resumeSearch(goal_states, limits),
+		const char*);
+	problem.searchUniformCost(0, goal_states, limits);
+	problem.searchBreadthFirst(0, goal_states);
+	ASSERT_THROWSM("Another search began.", problem.resumeSearch(goal_states, limits), const char*);
+	problem.searchUniformCost(0, goal_states, limits);
+	problem.setResultKind(graphsearch::ResultKind::distance);
+	ASSERT_THROWSM("The result kind changed.", problem.resumeSearch(goal_states, limits), const char*);
+	problem.setResultKind(graphsearch::ResultKind::path);
+	ASSERTM("With its result kind restored, the search should resume.",
+		problem.resumeSearch(goal_states, limits) == graphsearch::SearchStatus::budget_exhausted);
+}
+
+void CostGridProblem::successors(const int& state, SuccessorSink& sink)
+{
+	int x = state % width;
+	int y = state / width;
+
+	++expanded;
+	if (y > 0 && !std::isinf(costs[state - width]))
+	{
+		sink.add(TestActions::up, state - width);
+	}
+	if (y < width - 1 && !std::isinf(costs[state + width]))
+	{
+		sink.add(TestActions::down, state + width);
+	}
+	if (x > 0 && !std::isinf(costs[state - 1]))
+	{
+		sink.add(TestActions::left, state - 1);
+	}
+	if (x < width - 1 && !std::isinf(costs[state + 1]))
+	{
+		sink.add(TestActions::right, state + 1);
+	}
+}
+
+void CostGridProblem::predecessors(const int& state, SuccessorSink& sink)
+{
+	int x = state % width;
+	int y = state / width;
+
+	// A blocked cell has no predecessors.  An open cell can be entered from each of its neighbors.
+	if (std::isinf(costs[state]))
+	{
+		return;
+	}
+	if (y > 0)
+	{
+		sink.add(TestActions::down, state - width);
+	}
+	if (y < width - 1)
+	{
+		sink.add(TestActions::up, state + width);
+	}
+	if (x > 0)
+	{
+		sink.add(TestActions::right, state - 1);
+	}
+	if (x < width - 1)
+	{
+		sink.add(TestActions::left, state + 1);
+	}
+}
+
+double CostGridProblem::stepCost(const int& /* state */, TestActions /* action */, const int& next_state) const
+{
+	return costs[next_state];
+}
+
+double CostGridProblem::heuristic(const int& state) const
+{
+	return 2 * (width - 1) - state % width - state / width;
+}
+
+void CostGridProblem::setCost(int cell, double cost, bool report)
+{
+	int x = cell % width;
+	int y = cell / width;
+
+	costs[cell] = cost;
+	if (!report)
+	{
+		return;
+	}
+	for (int neighbor : { y > 0 ? cell - width : -1, y < width - 1 ? cell + width : -1, x > 0 ? cell - 1 : -1,
+		x < width - 1 ? cell + 1 : -1 })
+	{
+		if (neighbor >= 0)
+		{
+			edgeChanged(neighbor, cell);
+		}
+	}
+}
+
+double CostGridProblem::pathCost(const std::vector<int>& the_path) const
+{
+	double cost = 0.0;
+
+	if (!isPath(the_path, the_path.front(), the_path.back()))
+	{
+		return std::numeric_limits<double>::infinity();
+	}
+	for (std::size_t i = 1; i < the_path.size(); ++i)
+	{
+		cost += costs[the_path[i]];
+	}
+	return cost;
+}
+
+void IncrementalSearchTest()
+{
+	const int width = 20, goal = width * width - 1;
+	CostGridProblem problem{width}, fresh{width};
+	std::vector<int> the_path;
+
+	ASSERTM("No solution found.", problem.searchIncremental(0, goal));
+	ASSERTM("Incorrect distance.", problem.distance() == 2 * (width - 1));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", the_path.front() == 0 && problem.pathCost(the_path) == 2 * (width - 1));
+
+	// Build a wall across the grid with a gap at the bottom.  The repaired path should cost as much as a fresh A* path.
+	for (int y = 0; y < width - 1; ++y)
+	{
+		problem.setCost(y * width + width / 2, std::numeric_limits<double>::infinity(), true);
+		fresh.setCost(y * width + width / 2, std::numeric_limits<double>::infinity(), false);
+	}
+	problem.setCost(goal - 1, 5.0, true);
+	fresh.setCost(goal - 1, 5.0, false);
+	ASSERTM("No solution found.", problem.replan());
+	ASSERTM("No solution found.", fresh.searchAStar(0, std::unordered_set<int>({ goal })));
+	ASSERTM("The repaired path should cost as much as a fresh one.", problem.distance() == fresh.distance());
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", the_path.front() == 0 && problem.pathCost(the_path) == fresh.distance());
+
+	// A change that the search never reached expands nothing, and the solution stays the same.
+	problem.expanded = 0;
+	problem.setCost(width / 2 + 1, 3.0, true);
+	ASSERTM("No solution found.", problem.replan());
+	ASSERTM("Nothing should be expanded.", problem.expanded == 0);
+	ASSERTM("The distance should not change.", problem.distance() == fresh.distance());
+
+	// Close the gap, so the goal can't be reached, and open it again.
+	problem.setCost((width - 1) * width + width / 2, std::numeric_limits<double>::infinity(), true);
+	ASSERTM("No solution should be found.", !problem.replan());
+	ASSERT_THROWSM("There is no path.", problem.path(the_path), const char*);
+	problem.setCost((width - 1) * width + width / 2, 1.0, true);
+	for (int y = 0; y < width - 1; ++y)
+	{
+		problem.setCost(y * width + width / 2, 1.0, true);
+	}
+	ASSERTM("No solution found.", problem.replan());
+	ASSERTM("Incorrect distance.", problem.distance() == 2 * (width - 1));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", problem.pathCost(the_path) == problem.distance());
+
+	// Another search clears the incremental search.
+	problem.searchAStar(0, std::unordered_set<int>({ goal }));
+	ASSERT_THROWSM("There is no incremental search to replan.", problem.replan(), const char*);
+	ASSERT_THROWSM("There is no incremental search to update.", problem.setCost(0, 1.0, true), const char*);
+}
+
+void BeamSearchTest()
+{
+	const int width = 20, goal = width * width - 1;
+	CostGridProblem problem{width};
+	std::vector<int> the_path;
+
+	// On an open grid, the heuristic leads even the narrowest beam straight to the goal.
+	ASSERTM("No solution found.", problem.searchBeam(0, std::unordered_set<int>({ goal }), 1));
+	ASSERTM("Incorrect distance.", problem.distance() == 2 * (width - 1));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", problem.isPath(the_path, 0, goal));
+
+	// Behind a wall with a gap at the far end, a narrow beam finds a path, but not necessarily a shortest one.  A beam
+	// as wide as the grid is a breadth-first search.
+	for (int y = 1; y < width; ++y)
+	{
+		problem.setCost(y * width + width / 2, std::numeric_limits<double>::infinity(), false);
+	}
+	ASSERTM("No solution found.", problem.searchBreadthFirst(0, std::unordered_set<int>({ goal })));
+	double shortest = problem.distance();
+	ASSERTM("No solution found.", problem.searchBeam(0, std::unordered_set<int>({ goal }), 2));
+	problem.path(the_path);
+	ASSERTM("Incorrect path.", problem.pathCost(the_path) == problem.distance() && problem.distance() >= shortest);
+	ASSERTM("No solution found.", problem.searchBeam(0, std::unordered_set<int>({ goal }), width * width));
+	ASSERTM("A beam as wide as the grid should find a shortest path.", problem.distance() == shortest);
+
+	// The beam keeps at most its width of states per level, and counts the successors it drops.
+	const int size = 50;
+	CompleteGraphProblem complete{size};
+	ASSERTM("No solution should be found.", !complete.searchBeam(0, std::unordered_set<int>({ size }), 5));
+	ASSERTM("Every state should be expanded once.", complete.stats().nodes_expanded == size);
+	ASSERTM("The frontier should never be wider than the beam.", complete.stats().peak_frontier <= 5);
+	ASSERTM("The first level should drop all but 5 successors.", complete.stats().nodes_pruned >= size - 1 - 5);
+
+	// A search with a bounded frontier drops the deepest nodes beyond its ceiling.
+	struct DeeperNode
+	{
+		bool operator()(const OpenGridProblem::NodeType& a, const OpenGridProblem::NodeType& b) const
+		{
+			return a.depth > b.depth;
+		}
+	};
+	OpenGridProblem open{width};
+	graphsearch::BoundedFrontier<OpenGridProblem::NodeType, DeeperNode> bounded{8};
+	ASSERTM("No solution found.", open.search(0, std::unordered_set<int>({ goal }), &bounded));
+	open.path(the_path);
+	ASSERTM("Incorrect path.", open.isPath(the_path, 0, goal));
+	ASSERTM("The frontier should drop nodes.", bounded.pruned() > 0);
+
+	// A beam search for the goals that isGoal recognizes
+	BottomRowGridProblem bottom_row{width};
+	ASSERTM("No solution found.", bottom_row.searchBeam(0, 3));
+	ASSERTM("Incorrect distance.", bottom_row.distance() == width - 1);
+	ASSERT_THROWSM("A beam of no states should raise an exception.", bottom_row.searchBeam(0, 0), const char*);
+}
@@ -7,7 +7,10 @@ This code tests GraphSearch.h.
 
 #pragma once
 
+#include <atomic>
 #include <functional>      // std::hash
+#include <vector>
+#include "Arena.h"
 #include "GraphSearch.h"
 #include "FrontierTests.h" // SimpleStruct
 
@@ -40,6 +43,18 @@ class SimpleCyclesProblem : public graphsearch::Problem<int, TestActions>
 	const int result(int state, TestActions action) override;
 };
 
+/*
+This class defines the same graph as SimpleProblem, but it overrides "successors" rather than "actions" and "result."
+It makes "expand" public so that tests can count the allocations made while expanding a node.
+*/
+class SimpleSuccessorsProblem : public graphsearch::Problem<int, TestActions>
+{
+	void successors(const int& state, SuccessorSink& sink) override;
+
+public:
+	void expandState(int state, std::vector<NodeType>& children);
+};
+
 /*
 Test the graph search problem when nodes are structures rather than simple types.  Use the SimpleStruct defined in
 FrontierTests.h for this purpose.  Define a hasher to work with the default of the Problem class template's third variable.
@@ -68,6 +83,148 @@ class SimpleStructProblem : public graphsearch::Problem<SimpleStruct, TestAction
 	const SimpleStruct result(SimpleStruct state, TestActions action) override;
 };
 
+/*
+This class defines a problem with weighted edges:
+
+                              1 - 2 - 3 - 4
+                              |           |
+                              -----------
+
+The edges 1-2, 2-3, and 3-4 cost 1.  The edge from 1 to 4 (down from 1 and up from 4) costs 10.  A breadth-first search
+from 1 to 4 takes the expensive edge, but uniform-cost and A* searches take the cheap path through 2 and 3.
+*/
+class WeightedProblem : public graphsearch::Problem<int, TestActions>
+{
+	void actions(int state, std::vector<TestActions>& available_actions) const override;
+	const int result(int state, TestActions action) override;
+	double stepCost(const int& state, TestActions action, const int& next_state) const override;
+	double heuristic(const int& state) const override;
+};
+
+/*
+This class defines the same loop as SimpleStructProblem, but it uses a FlatStateTable to store states, and it overrides
+"successors" rather than "actions" and "result."
+*/
+class FlatStateTableProblem : public graphsearch::Problem<SimpleStruct, TestActions, std::hash<SimpleStruct>,
+	graphsearch::FlatStateTable<SimpleStruct>>
+{
+	void successors(const SimpleStruct& state, SuccessorSink& sink) override;
+};
+
+/*
+This class defines a square grid of integer states, numbered row by row from 0, with four-way movement and no
+obstacles.  It is large enough that parallel searches expand some levels with more than one thread.  It counts the
+nodes expanded, and the count is atomic because parallel searches expand nodes from several threads at once.
+*/
+class OpenGridProblem : public graphsearch::Problem<int, TestActions>
+{
+	void successors(const int& state, SuccessorSink& sink) override;
+	void predecessors(const int& state, SuccessorSink& sink) override;
+
+protected:
+	int width;
+
+public:
+	std::atomic<long> expanded{0};
+
+	OpenGridProblem(int the_width) : width{the_width}
+	{
+	}
+
+	/* Return true if the path starts at "start," ends at "goal," and moves one cell at a time. */
+	bool isPath(const std::vector<int>& the_path, int start, int goal) const;
+};
+
+/* This class defines the same grid as OpenGridProblem, with every state of the bottom row a goal. */
+class BottomRowGridProblem : public OpenGridProblem
+{
+	bool isGoal(const int& state) const override;
+
+public:
+	BottomRowGridProblem(int the_width) : OpenGridProblem{the_width}
+	{
+	}
+};
+
+/*
+This class defines the same grid as OpenGridProblem, but moving into a cell costs the cell's entry in "costs," and a
+cell whose cost is infinite is blocked.  The heuristic is the Manhattan distance to the last cell.
+*/
+class CostGridProblem : public OpenGridProblem
+{
+	void successors(const int& state, SuccessorSink& sink) override;
+	void predecessors(const int& state, SuccessorSink& sink) override;
+	double stepCost(const int& state, TestActions action, const int& next_state) const override;
+	double heuristic(const int& state) const override;
+
+public:
+	std::vector<double> costs;
+
+	CostGridProblem(int the_width) : OpenGridProblem{the_width}, costs(the_width * the_width, 1.0)
+	{
+	}
+
+	/* Change the cost of moving into a cell, and if "report" is true, report each move into it to "edgeChanged." */
+	void setCost(int cell, double cost, bool report);
+
+	/* Return the cost of a path, or infinity if it isn't a path through open cells. */
+	double pathCost(const std::vector<int>& the_path) const;
+};
+
+/* This class defines the same grid as OpenGridProblem, but the problem allocates its memory from a monotonic arena. */
+class ArenaGridProblem : public graphsearch::Problem<int, TestActions, std::hash<int>,
+	graphsearch::FlatStateTable<int, std::hash<int>, graphsearch::ArenaAllocator<int>>, graphsearch::NoSearchStats,
+	graphsearch::ArenaAllocator<int>>
+{
+	int width;
+
+	void successors(const int& state, SuccessorSink& sink) override;
+	void predecessors(const int& state, SuccessorSink& sink) override;
+
+public:
+	ArenaGridProblem(graphsearch::MonotonicArena& arena, int the_width)
+		: Problem(graphsearch::ArenaAllocator<int>{arena}), width{the_width}
+	{
+	}
+};
+
+/*
+This class defines a line of integer states from 0 to length - 1, with a move left and a move right, and collects
+search statistics.  It counts the calls to "progress."
+*/
+class StatsLineProblem : public graphsearch::Problem<int, TestActions, std::hash<int>, graphsearch::StateTable<int>,
+	graphsearch::SearchStats>
+{
+	int length;
+
+	void successors(const int& state, SuccessorSink& sink) override;
+	void progress(const graphsearch::SearchStats& stats) override;
+
+public:
+	std::vector<std::size_t> progress_reports;  // The nodes expanded at each call to "progress"
+
+	StatsLineProblem(int the_length) : length{the_length}
+	{
+	}
+};
+
+/*
+This class defines a complete graph of integer states from 0 to size - 1, with one move from every state to every
+other state, and collects search statistics.
+*/
+class CompleteGraphProblem : public graphsearch::Problem<int, TestActions, std::hash<int>, graphsearch::StateTable<int>,
+	graphsearch::SearchStats>
+{
+	int size;
+
+	void successors(const int& state, SuccessorSink& sink) override;
+
+public:
+	CompleteGraphProblem(int the_size) : size{the_size}
+	{
+	}
+};
+
 // Test function prototypes:
 void NoSolutionTest();
 void SimpleBreadthFirstSearchTest();
@@ -78,3 +235,48 @@ void SimpleCyclesDepthFirstSearchTest();
 
 void SimpleStructBreadthFirstSearchTest();
 void SimpleStructDepthFirstSearchTest();
+
+void WeightedBreadthFirstSearchTest();
+void UniformCostSearchTest();
+void AStarSearchTest();
+
+void FrontierPolicySearchTest();
+
+void SuccessorsSearchTest();
+void ZeroAllocationExpandTest();
+
+void FlatStateTableSearchTest();
+void ReusedSearchAllocationTest();
+
+void ParallelBreadthFirstSearchTest();
+void ParallelGridSearchTest();
+void ParallelDepthFirstSearchTest();
+void ParallelTraversalStressTest();
+
+void BidirectionalSearchTest();
+
+void IterativeDeepeningSearchTest();
+void IDAStarSearchTest();
+
+void SearchStatsTest();
+void ParallelSearchStatsTest();
+
+void ArenaSearchTest();
+
+void ExternalBreadthFirstSearchTest();
+
+void ResultKindTest();
+
+void MultiSourceSearchTest();
+void NearestSourceSearchTest();
+void BatchSearchTest();
+
+void SuccessorCacheSearchTest();
+void DenseBreadthFirstSearchTest();
+void GoalOnGenerationTest();
+void GoalPredicateSearchTest();
+void StateMarkingTest();
+void SearchLimitsTest();
+void ResumeSearchTest();
+void IncrementalSearchTest();
+void BeamSearchTest();
@@ -0,0 +1,73 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code implements the limits a caller can put on a search in GraphSearch.h:  a budget of nodes expanded, a
+deadline, and a token another thread can use to cancel the search.  A search given limits returns a SearchStatus
+rather than a bool, and a search that stops at a limit keeps its frontier, states, and nodes, so that
+Problem::resumeSearch can continue it later.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>       // std::size_t
+#include <limits>        // std::numeric_limits
+
+namespace graphsearch
+{
+	/*
+	How a search given limits ended:  it found a solution, it found that there is none, or it stopped at one of its
+	limits before it could tell.  A search that stopped can be resumed.
+	*/
+	enum class SearchStatus { found, not_found, budget_exhausted, deadline_passed, cancelled };
+
+	/* Return true if a search with the given status stopped at a limit and can be resumed. */
+	inline bool stoppedEarly(SearchStatus status)
+	{
+		return status != SearchStatus::found && status != SearchStatus::not_found;
+	}
+
+	/*
+	A flag any thread can set to cancel the searches that were given it in their SearchLimits.  A search checks it
+	before it expands each node.  "reset" clears it, so the token can be given to the next search.
+	*/
+	class CancellationToken
+	{
+		std::atomic<bool> cancelled{false};
+
+	public:
+		void cancel()
+		{
+			cancelled.store(true, std::memory_order_relaxed);
+		}
+
+		void reset()
+		{
+			cancelled.store(false, std::memory_order_relaxed);
+		}
+
+		bool isCancelled() const
+		{
+			return cancelled.load(std::memory_order_relaxed);
+		}
+	};
+
+	/*
+	The limits of one call to a search or to Problem::resumeSearch.  By default there are none.  The budget counts the
+	nodes the call expands, so a resumed search gets a new budget.  The search reads the clock only every
+	"clock_interval" nodes expanded, so it can run that many nodes past the deadline.  The token, if any, must outlive
+	the call.
+	*/
+	struct SearchLimits
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		static const std::size_t clock_interval = 32;
+
+		std::size_t max_expansions{std::numeric_limits<std::size_t>::max()};
+		Clock::time_point deadline{Clock::time_point::max()};
+		const CancellationToken* cancellation{nullptr};
+	};
+} // End of the graphsearch namespace.
@@ -0,0 +1,185 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code implements the statistics searches in GraphSearch.h collect about themselves.  Either class below is the
+fifth template variable of Problem, and every search records its statistics in it.  Call Problem::stats after a
+search to read them.
+
+SearchStats counts nodes and times the search.  NoSearchStats, the default, has the same methods, but they do nothing,
+so the compiler removes every call, and a search pays nothing for statistics it doesn't collect.
+*/
+
+#pragma once
+
+#include <algorithm>     // std::max
+#include <chrono>
+#include <cstddef>       // std::size_t
+#include <cstdint>       // std::uint32_t
+
+namespace graphsearch
+{
+	/*
+	The counts cover the last search only.  The parallel searches add up the counts and the successor time of all of
+	their threads, so their successor time can exceed their search time.
+	*/
+	struct SearchStats
+	{
+		static const bool enabled = true;
+
+		typedef std::chrono::steady_clock Clock;
+		typedef Clock::time_point TimePoint;
+
+		std::size_t nodes_generated{0};  // The successors found by expanding nodes
+		std::size_t nodes_expanded{0};
+		std::size_t duplicate_hits{0};   // The successors skipped because the search had already reached their states
+		std::size_t nodes_pruned{0};     // The successors a beam search dropped to keep its width
+		std::size_t peak_frontier{0};    // The most nodes waiting to be expanded at once
+		std::size_t peak_nodes{0};       // The most nodes the search kept for "solution" and "path" at once
+		std::uint32_t max_depth{0};      // The most actions from the initial state to a node expanded
+		Clock::duration successor_time{0};  // The time spent in "successors," or in "actions" and "result"
+		Clock::duration search_time{0};     // The time from the start of the search to the end
+
+		static TimePoint now()
+		{
+			return Clock::now();
+		}
+
+		/* Return the time spent outside "successors":  managing the frontier, the states, and the nodes. */
+		Clock::duration bookkeepingTime() const
+		{
+			return search_time - successor_time;
+		}
+
+		std::size_t expandedCount() const
+		{
+			return nodes_expanded;
+		}
+
+		/* Count a node expanded at the given depth, and return the number of nodes expanded so far. */
+		std::size_t expanded(std::uint32_t depth)
+		{
+			max_depth = std::max(max_depth, depth);
+			return ++nodes_expanded;
+		}
+
+		/* Count the successors of a node, which took from "start" until now to find. */
+		void generated(std::size_t count, TimePoint start)
+		{
+			nodes_generated += count;
+			successor_time += Clock::now() - start;
+		}
+
+		void duplicate()
+		{
+			++duplicate_hits;
+		}
+
+		void pruned(std::size_t count)
+		{
+			nodes_pruned += count;
+		}
+
+		void frontierSize(std::size_t size)
+		{
+			peak_frontier = std::max(peak_frontier, size);
+		}
+
+		void nodesSize(std::size_t size)
+		{
+			peak_nodes = std::max(peak_nodes, size);
+		}
+
+		/* Record the end of a search that began at "start." */
+		void finish(TimePoint start)
+		{
+			search_time = Clock::now() - start;
+		}
+
+		/* Return the start time of a search resumed now, which counts the search time so far. */
+		TimePoint resumedStart() const
+		{
+			return Clock::now() - search_time;
+		}
+
+		/* Add the counts of another thread of the same search. */
+		void merge(const SearchStats& other)
+		{
+			nodes_generated += other.nodes_generated;
+			nodes_expanded += other.nodes_expanded;
+			duplicate_hits += other.duplicate_hits;
+			nodes_pruned += other.nodes_pruned;
+			peak_frontier = std::max(peak_frontier, other.peak_frontier);
+			peak_nodes = std::max(peak_nodes, other.peak_nodes);
+			max_depth = std::max(max_depth, other.max_depth);
+			successor_time += other.successor_time;
+		}
+
+		void clear()
+		{
+			*this = SearchStats();
+		}
+	};
+
+	/* This class collects no statistics.  See SearchStats for its methods. */
+	struct NoSearchStats
+	{
+		static const bool enabled = false;
+
+		struct TimePoint
+		{
+		};
+
+		static TimePoint now()
+		{
+			return TimePoint{};
+		}
+
+		std::size_t expandedCount() const
+		{
+			return 0;
+		}
+
+		std::size_t expanded(std::uint32_t /* depth */)
+		{
+			return 0;
+		}
+
+		void generated(std::size_t /* count */, TimePoint /* start */)
+		{
+		}
+
+		void duplicate()
+		{
+		}
+
+		void pruned(std::size_t /* count */)
+		{
+		}
+
+		void frontierSize(std::size_t /* size */)
+		{
+		}
+
+		void nodesSize(std::size_t /* size */)
+		{
+		}
+
+		void finish(TimePoint /* start */)
+		{
+		}
+
+		TimePoint resumedStart() const
+		{
+			return TimePoint{};
+		}
+
+		void merge(const NoSearchStats& /* other */)
+		{
+		}
+
+		void clear()
+		{
+		}
+	};
+} // End of the graphsearch namespace.
@@ -0,0 +1,561 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code implements a table of states for use with GraphSearch.h.  The table stores each distinct state once and
+identifies it by a dense 32-bit index, so a search can refer to a state by its index wherever it would otherwise keep
+another copy of the state.  The table doubles as the set of states a search has seen.
+
+There are three tables with the same interface.  StateTable indexes the states with the standard library's hash set,
+which allocates a node per state and follows a pointer per lookup.  FlatStateTable indexes them with an open-addressing
+hash table in one contiguous array, which is faster and smaller.  DenseStateTable is for states that are small
+non-negative integers, such as the vertices of an explicit graph; it indexes them with an array with an entry per
+possible state, so a lookup is a single load and nothing is hashed.  Any of them is the fourth template variable of
+Problem.
+
+Besides "find" and "intern," each table has "hash," "prefetch," and overloads of "find" and "intern" that take a
+hash computed earlier.  A search uses them to look up a batch of states:  it hashes each state and prefetches its
+place in the table, and only then looks the states up, so that the cache misses for the batch overlap.
+
+All three tables take an allocator for all of their memory, and can be constructed with an instance of it.  It is the
+third template variable of StateTable and FlatStateTable, and the second of DenseStateTable, which hashes nothing.  Problem constructs its tables with its own allocator.  See Arena.h.
+
+ConcurrentStateSet is a set of states, rather than a table, that several threads can add states to at once.
+*/
+
+#pragma once
+
+#include <algorithm>     // std::max
+#include <cstddef>       // std::size_t
+#include <cstdint>       // std::uint32_t, std::uint64_t
+#include <functional>    // std::hash
+#include <memory>        // std::allocator, std::allocator_traits
+#include <mutex>
+#include <stdexcept>     // std::out_of_range
+#include <unordered_set>
+#include <utility>       // std::swap
+#include <vector>
+
+namespace graphsearch
+{
+	/*
+	The states are stored in a vector in the order they were added.  The index is a hash set of positions in that
+	vector, whose hash and equality functions look the states up in the vector.  To find a state that isn't in the
+	table, the table temporarily points at it and looks up the reserved position "probe_id."
+	*/
+	template <typename StateType, typename StateHashType = std::hash<StateType>,
+		typename AllocatorType = std::allocator<StateType>>
+	class StateTable
+	{
+		static const std::uint32_t probe_id = UINT32_MAX;
+
+		std::vector<StateType, typename std::allocator_traits<AllocatorType>::template rebind_alloc<StateType>> states;
+		mutable const StateType* probe{nullptr};  // The state being looked up, while "find" or "intern" runs
+
+		const StateType& resolve(std::uint32_t id) const
+		{
+			return id == probe_id ? *probe : states[id];
+		}
+
+		struct IdHash
+		{
+			const StateTable* table;
+
+			std::size_t operator()(std::uint32_t id) const
+			{
+				return StateHashType()(table->resolve(id));
+			}
+		};
+
+		struct IdEqual
+		{
+			const StateTable* table;
+
+			bool operator()(std::uint32_t a, std::uint32_t b) const
+			{
+				return a == b || table->resolve(a) == table->resolve(b);
+			}
+		};
+
+		typedef std::unordered_set<std::uint32_t, IdHash, IdEqual,
+			typename std::allocator_traits<AllocatorType>::template rebind_alloc<std::uint32_t>> Index;
+
+		Index index;
+
+	public:
+		// The value "find" returns for a state that is not in the table.
+		static const std::uint32_t not_found = UINT32_MAX;
+
+		explicit StateTable(const AllocatorType& allocator = AllocatorType())
+			: states(allocator), index(0, IdHash{this}, IdEqual{this}, allocator)
+		{
+		}
+
+		// The index refers back to this table, so the table cannot be copied.
+		StateTable(const StateTable&) = delete;
+		StateTable& operator=(const StateTable&) = delete;
+
+		std::size_t hash(const StateType& state) const
+		{
+			return StateHashType()(state);
+		}
+
+		/* The standard library's hash set offers no way to prefetch, so this does nothing. */
+		void prefetch(std::size_t /* hash */) const
+		{
+		}
+
+		/* Return the index of the given state, or "not_found" if the state is not in the table. */
+		std::uint32_t find(const StateType& state) const
+		{
+			typename Index::const_iterator found;
+
+			probe = &state;
+			found = index.find(probe_id);
+			probe = nullptr;
+			return found == index.end() ? not_found : *found;
+		}
+
+		/* The standard library's hash set computes the hash again, so this is the same as find(state). */
+		std::uint32_t find(const StateType& state, std::size_t /* hash */) const
+		{
+			return find(state);
+		}
+
+		bool contains(const StateType& state) const
+		{
+			return find(state) != not_found;
+		}
+
+		/* Return the index of the given state, adding the state to the table if it is not already there. */
+		std::uint32_t intern(const StateType& state)
+		{
+			std::uint32_t id = find(state);
+
+			if (id == not_found)
+			{
+				id = (std::uint32_t)states.size();
+				states.push_back(state);
+				index.insert(id);
+			}
+			return id;
+		}
+
+		std::uint32_t intern(const StateType& state, std::size_t /* hash */)
+		{
+			return intern(state);
+		}
+
+		const StateType& operator[](std::uint32_t id) const
+		{
+			return states[id];
+		}
+
+		std::size_t size() const
+		{
+			return states.size();
+		}
+
+		/*
+		Remove every state.  If the table holds few states for its number of buckets, erase them one at a time rather
+		than clearing every bucket, so that clearing takes time in proportion to the states a search touched.
+		*/
+		void clear()
+		{
+			if (states.size() * 4 < index.bucket_count())
+			{
+				for (std::uint32_t id = 0; id < states.size(); ++id)
+				{
+					index.erase(id);
+				}
+			}
+			else
+			{
+				index.clear();
+			}
+			states.clear();
+		}
+	};
+
+	template <typename StateType, typename StateHashType, typename AllocatorType>
+	const std::uint32_t StateTable<StateType, StateHashType, AllocatorType>::probe_id;
+
+	template <typename StateType, typename StateHashType, typename AllocatorType>
+	const std::uint32_t StateTable<StateType, StateHashType, AllocatorType>::not_found;
+
+	/*
+	The states are stored in a vector in the order they were added.  The index is an array of slots, whose length is a
+	power of two, with linear probing and Robin Hood insertion:  a state being inserted takes the slot of any state that
+	is closer to its home slot, which keeps probe sequences short and lets an unsuccessful lookup stop early.  Each slot
+	holds a position in the vector and the state's 32-bit hash, so the table rarely needs to compare states that don't
+	match, and it never needs to hash them again when it grows.
+
+	The table mixes the hash from StateHashType, so hashes like std::hash<int>, which is the identity, work well.
+	*/
+	template <typename StateType, typename StateHashType = std::hash<StateType>,
+		typename AllocatorType = std::allocator<StateType>>
+	class FlatStateTable
+	{
+		static const std::uint32_t empty_id = UINT32_MAX;
+
+		struct Slot
+		{
+			std::uint32_t id;
+			std::uint32_t hash;
+		};
+
+		typedef std::vector<Slot, typename std::allocator_traits<AllocatorType>::template rebind_alloc<Slot>> SlotVector;
+
+		std::vector<StateType, typename std::allocator_traits<AllocatorType>::template rebind_alloc<StateType>> states;
+		SlotVector slots;
+		std::size_t mask{0};  // The number of slots minus 1
+
+		/* Return how far a slot is from the home slot for the given hash. */
+		std::size_t distance(std::size_t position, std::uint32_t hash) const
+		{
+			return (position - hash) & mask;
+		}
+
+		/* Insert a slot, which must not already be in the table. */
+		void place(Slot slot)
+		{
+			std::size_t position = slot.hash & mask;
+			std::size_t slot_distance = 0;
+
+			while (slots[position].id != empty_id)
+			{
+				std::size_t resident_distance = distance(position, slots[position].hash);
+				if (resident_distance < slot_distance)
+				{
+					// The resident is closer to home than the slot being inserted.  Take its place, and move it instead.
+					std::swap(slots[position], slot);
+					slot_distance = resident_distance;
+				}
+				position = (position + 1) & mask;
+				++slot_distance;
+			}
+			slots[position] = slot;
+		}
+
+		/* Double the number of slots, and re-insert every state using the hashes in the slots. */
+		void grow()
+		{
+			SlotVector old_slots(slots.get_allocator());
+
+			old_slots.swap(slots);
+			slots.assign(old_slots.empty() ? 16 : old_slots.size() * 2, Slot{empty_id, 0});
+			mask = slots.size() - 1;
+			for (const Slot& slot : old_slots)
+			{
+				if (slot.id != empty_id)
+				{
+					place(slot);
+				}
+			}
+		}
+
+	public:
+		// The value "find" returns for a state that is not in the table.
+		static const std::uint32_t not_found = UINT32_MAX;
+
+		explicit FlatStateTable(const AllocatorType& allocator = AllocatorType()) : states(allocator), slots(allocator)
+		{
+		}
+
+		std::size_t hash(const StateType& state) const
+		{
+			// Fibonacci hashing:  the high bits of the product depend on all of the bits of the original hash.
+			return (std::uint32_t)(((std::uint64_t)StateHashType()(state) * 0x9E3779B97F4A7C15ull) >> 32);
+		}
+
+		/* Ask the processor to start loading the home slot for the given hash into the cache. */
+		void prefetch(std::size_t hash) const
+		{
+#if defined(__GNUC__)
+			if (!slots.empty())
+			{
+				__builtin_prefetch(&slots[hash & mask]);
+			}
+#endif
+		}
+
+		/* Return the index of the given state, or "not_found" if the state is not in the table. */
+		std::uint32_t find(const StateType& state) const
+		{
+			return find(state, hash(state));
+		}
+
+		std::uint32_t find(const StateType& state, std::size_t hash) const
+		{
+			std::size_t position = hash & mask;
+			std::size_t probe_distance = 0;
+
+			if (slots.empty())
+			{
+				return not_found;
+			}
+
+			// Stop at an empty slot or at a slot closer to its home than this state would be; Robin Hood insertion
+			// would have put the state there.
+			while (slots[position].id != empty_id && distance(position, slots[position].hash) >= probe_distance)
+			{
+				if (slots[position].hash == hash && states[slots[position].id] == state)
+				{
+					return slots[position].id;
+				}
+				position = (position + 1) & mask;
+				++probe_distance;
+			}
+			return not_found;
+		}
+
+		bool contains(const StateType& state) const
+		{
+			return find(state) != not_found;
+		}
+
+		/* Return the index of the given state, adding the state to the table if it is not already there. */
+		std::uint32_t intern(const StateType& state)
+		{
+			return intern(state, hash(state));
+		}
+
+		std::uint32_t intern(const StateType& state, std::size_t hash)
+		{
+			std::uint32_t id = find(state, hash);
+
+			if (id == not_found)
+			{
+				// Keep the table at most 7/8 full.
+				if ((states.size() + 1) * 8 > slots.size() * 7)
+				{
+					grow();
+				}
+				id = (std::uint32_t)states.size();
+				states.push_back(state);
+				place(Slot{id, (std::uint32_t)hash});
+			}
+			return id;
+		}
+
+		const StateType& operator[](std::uint32_t id) const
+		{
+			return states[id];
+		}
+
+		std::size_t size() const
+		{
+			return states.size();
+		}
+
+		/*
+		Remove every state.  If the table holds few states for its number of slots, empty just their slots, so that
+		clearing takes time in proportion to the states a search touched rather than to the largest search so far.
+		Each state's slot is at or after its home slot; emptying slots out of order breaks the probe sequences "find"
+		relies on, so look for the state's index rather than the state.
+		*/
+		void clear()
+		{
+			if (states.size() * 4 < slots.size())
+			{
+				for (std::uint32_t id = 0; id < states.size(); ++id)
+				{
+					std::size_t position = hash(states[id]) & mask;
+					while (slots[position].id != id)
+					{
+						position = (position + 1) & mask;
+					}
+					slots[position] = Slot{empty_id, 0};
+				}
+			}
+			else
+			{
+				slots.assign(slots.size(), Slot{empty_id, 0});
+			}
+			states.clear();
+		}
+	};
+
+	template <typename StateType, typename StateHashType, typename AllocatorType>
+	const std::uint32_t FlatStateTable<StateType, StateHashType, AllocatorType>::empty_id;
+
+	template <typename StateType, typename StateHashType, typename AllocatorType>
+	const std::uint32_t FlatStateTable<StateType, StateHashType, AllocatorType>::not_found;
+
+	/*
+	"ids" holds the index of each state, or not_found, at the position of the state itself, and grows to the largest
+	state added.  Its memory is proportional to the largest state rather than to the number of states, so use this
+	table only when the states are dense.  The states must be from 0 to max_state; "intern" throws std::out_of_range
+	for any other state.  Clearing resets only the entries of the states added.
+	*/
+	template <typename StateType = std::uint32_t, typename AllocatorType = std::allocator<StateType>>
+	class DenseStateTable
+	{
+		std::vector<StateType, typename std::allocator_traits<AllocatorType>::template rebind_alloc<StateType>> states;
+		std::vector<std::uint32_t, typename std::allocator_traits<AllocatorType>::template rebind_alloc<std::uint32_t>> ids;
+
+	public:
+		// The value "find" returns for a state that is not in the table.
+		static const std::uint32_t not_found = UINT32_MAX;
+
+		// The largest state the table can hold, so that every position in "ids" fits in an index.
+		static const std::size_t max_state = UINT32_MAX - 1;
+
+		explicit DenseStateTable(const AllocatorType& allocator = AllocatorType()) : states(allocator), ids(allocator)
+		{
+		}
+
+		/* The "hash" of a state is its position in "ids."  A negative state becomes larger than max_state. */
+		std::size_t hash(const StateType& state) const
+		{
+			return (std::size_t)state;
+		}
+
+		void prefetch(std::size_t hash) const
+		{
+#if defined(__GNUC__)
+			if (hash < ids.size())
+			{
+				__builtin_prefetch(&ids[hash]);
+			}
+#endif
+		}
+
+		std::uint32_t find(const StateType& state) const
+		{
+			return find(state, hash(state));
+		}
+
+		std::uint32_t find(const StateType& /* state */, std::size_t hash) const
+		{
+			return hash < ids.size() ? ids[hash] : not_found;
+		}
+
+		bool contains(const StateType& state) const
+		{
+			return find(state) != not_found;
+		}
+
+		std::uint32_t intern(const StateType& state)
+		{
+			return intern(state, hash(state));
+		}
+
+		std::uint32_t intern(const StateType& state, std::size_t hash)
+		{
+			if (hash > max_state)
+			{
+				throw std::out_of_range("A DenseStateTable holds only states from 0 to 2^32 - 2.");
+			}
+			if (hash >= ids.size())
+			{
+				ids.resize(std::max(hash + 1, ids.size() * 2), not_found);
+			}
+			if (ids[hash] == not_found)
+			{
+				ids[hash] = (std::uint32_t)states.size();
+				states.push_back(state);
+			}
+			return ids[hash];
+		}
+
+		const StateType& operator[](std::uint32_t id) const
+		{
+			return states[id];
+		}
+
+		std::size_t size() const
+		{
+			return states.size();
+		}
+
+		void clear()
+		{
+			for (const StateType& state : states)
+			{
+				ids[hash(state)] = not_found;
+			}
+			states.clear();
+		}
+	};
+
+	template <typename StateType, typename AllocatorType>
+	const std::uint32_t DenseStateTable<StateType, AllocatorType>::not_found;
+
+	template <typename StateType, typename AllocatorType>
+	const std::size_t DenseStateTable<StateType, AllocatorType>::max_state;
+
+	/*
+	The set is split into shards, each a FlatStateTable guarded by its own mutex.  The high bits of a state's hash pick
+	its shard, and the low bits pick its place in the shard, so threads adding different states seldom wait for each
+	other.  There are many more shards than threads for the same reason.
+	*/
+	template <typename StateType, typename StateHashType = std::hash<StateType>>
+	class ConcurrentStateSet
+	{
+		struct Shard
+		{
+			std::mutex mutex;
+			FlatStateTable<StateType, StateHashType> table;
+		};
+
+		std::vector<Shard> shards;
+		unsigned shard_shift;  // Shift a 32-bit hash right this far to get its shard
+
+		static unsigned shardBits(unsigned concurrency)
+		{
+			unsigned bits = 4;
+
+			while (bits < 16 && (1u << bits) < 16 * concurrency)
+			{
+				++bits;
+			}
+			return bits;
+		}
+
+		Shard& shardFor(std::size_t hash)
+		{
+			return shards[hash >> shard_shift];
+		}
+
+	public:
+		/* Create a set for use by up to "concurrency" threads at once. */
+		explicit ConcurrentStateSet(unsigned concurrency)
+			: shards(std::size_t{1} << shardBits(concurrency)), shard_shift{32 - shardBits(concurrency)}
+		{
+		}
+
+		/* Add a state to the set.  Return true if the state was not already in the set. */
+		bool insert(const StateType& state)
+		{
+			std::size_t hash = shards[0].table.hash(state);
+			Shard& shard = shardFor(hash);
+			std::lock_guard<std::mutex> lock{shard.mutex};
+			std::size_t size_before = shard.table.size();
+
+			shard.table.intern(state, hash);
+			return shard.table.size() > size_before;
+		}
+
+		bool contains(const StateType& state)
+		{
+			std::size_t hash = shards[0].table.hash(state);
+			Shard& shard = shardFor(hash);
+			std::lock_guard<std::mutex> lock{shard.mutex};
+
+			return shard.table.find(state, hash) != FlatStateTable<StateType, StateHashType>::not_found;
+		}
+
+		/* Return the number of states in the set.  Don't call this while other threads are adding states. */
+		std::size_t size() const
+		{
+			std::size_t total = 0;
+
+			for (const Shard& shard : shards)
+			{
+				total += shard.table.size();
+			}
+			return total;
+		}
+	};
+} // End of the graphsearch namespace.
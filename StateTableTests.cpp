@@ -0,0 +1,123 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code tests StateTable.h.
+*/
+
+#include <atomic>
+#include <cstdint>         // std::uint32_t
+#include <stdexcept>       // std::out_of_range
+#include <thread>
+#include <vector>
+#include "cute.h"
+#include "StateTable.h"
+#include "StateTableTests.h"
+
+/*
+Add states 0 through count - 1, check them, and check that the table can be cleared and reused, both when it is full
+and when it holds only a few states.
+*/
+template <typename StateTableType>
+static void stateTableTestsHelper(StateTableType& table, int count)
+{
+	ASSERTM("The table should start out empty.", table.size() == 0);
+	ASSERTM("An empty table should not contain a state.", !table.contains(7));
+	for (int x = 0; x < count; ++x)
+	{
+		ASSERTM("A new state should get the next index.", table.intern(x) == (std::uint32_t)x);
+	}
+	ASSERTM("The table should hold every state added.", table.size() == (std::size_t)count);
+	for (int x = 0; x < count; ++x)
+	{
+		ASSERTM("Adding a state again should return its index.", table.intern(x) == (std::uint32_t)x);
+		ASSERTM("Finding a state should return its index.", table.find(x, table.hash(x)) == (std::uint32_t)x);
+		ASSERTM("An index should refer to its state.", table[x] == x);
+	}
+	ASSERTM("Adding states again should not change the size.", table.size() == (std::size_t)count);
+	ASSERTM("The table should not contain a state that was not added.", !table.contains(-1));
+	ASSERTM("The table should not contain a state that was not added.", table.find(count) == StateTableType::not_found);
+
+	table.clear();
+	ASSERTM("The table should be empty after clearing it.", table.size() == 0);
+	ASSERTM("The table should not contain a state after clearing it.", !table.contains(0));
+	ASSERTM("A cleared table should number states from 0.", table.intern(count) == 0);
+
+	// Clearing a few states from a table that has grown large empties only their places.  The rest must stay empty.
+	for (int x = 1; x < 5; ++x)
+	{
+		table.intern(count + x);
+	}
+	table.clear();
+	ASSERTM("The table should be empty after clearing it.", table.size() == 0);
+	ASSERTM("The table should not contain a state after clearing it.", !table.contains(count) && !table.contains(count + 4));
+	for (int x = 0; x < count; ++x)
+	{
+		ASSERTM("A new state should get the next index.", table.intern(x) == (std::uint32_t)x);
+	}
+	for (int x = 0; x < count; ++x)
+	{
+		ASSERTM("Finding a state should return its index.", table.find(x) == (std::uint32_t)x);
+	}
+}
+
+void StateTableTest() {
+	graphsearch::StateTable<int> table;
+	stateTableTestsHelper(table, 1000);
+}
+
+void StateTableCollisionsTest() {
+	graphsearch::StateTable<int, CollidingHash> table;
+	stateTableTestsHelper(table, 100);
+}
+
+void FlatStateTableTest() {
+	graphsearch::FlatStateTable<int> table;
+	stateTableTestsHelper(table, 1000);
+}
+
+void FlatStateTableCollisionsTest() {
+	graphsearch::FlatStateTable<int, CollidingHash> table;
+	stateTableTestsHelper(table, 100);
+}
+
+void DenseStateTableTest() {
+	graphsearch::DenseStateTable<int> table;
+	stateTableTestsHelper(table, 1000);
+
+	// A negative state is outside the table, so it can be looked up but not added.
+	ASSERTM("A negative state should not be found.", !table.contains(-1));
+	ASSERT_THROWSM("Adding a negative state should throw.", table.intern(-1), std::out_of_range);
+	ASSERTM("A failed addition should leave the table unchanged.", !table.contains(-1));
+}
+
+void ConcurrentStateSetTest() {
+	const int num_threads = 4;
+	const int count = 10000;
+	graphsearch::ConcurrentStateSet<int> set{num_threads};
+	std::atomic<int> inserted{0};
+	std::vector<std::thread> threads;
+
+	// Every thread adds the same states.  Each state should be new to exactly one of them.
+	for (int t = 0; t < num_threads; ++t)
+	{
+		threads.emplace_back([&set, &inserted, t]() {
+			for (int i = 0; i < count; ++i)
+			{
+				int x = (i + t * count / num_threads) % count;
+				if (set.insert(x))
+				{
+					++inserted;
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	ASSERTM("Each state should be added once.", inserted.load() == count);
+	ASSERTM("The set should hold every state added.", set.size() == (std::size_t)count);
+	ASSERTM("The set should contain a state that was added.", set.contains(count - 1));
+	ASSERTM("The set should not contain a state that was not added.", !set.contains(count));
+}
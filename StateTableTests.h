@@ -0,0 +1,27 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code tests StateTable.h.
+*/
+
+#pragma once
+
+#include <cstddef>         // std::size_t
+
+/* A hasher that puts every integer in the same place, to test how the state tables handle collisions. */
+struct CollidingHash
+{
+	std::size_t operator()(int /* x */) const
+	{
+		return 42;
+	}
+};
+
+// Test function prototypes:
+void StateTableTest();
+void StateTableCollisionsTest();
+void FlatStateTableTest();
+void FlatStateTableCollisionsTest();
+void DenseStateTableTest();
+void ConcurrentStateSetTest();
@@ -0,0 +1,319 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code implements a bounded cache of the successors of states, for use with GraphSearch.h.  When "actions" and
+"result" (or "successors") are expensive, such as a step of a simulation, a problem that searches the same states
+again and again can keep their successors instead of computing them each time.  Call Problem::setSuccessorCache to
+turn it on.
+
+The cache holds the list of every action and resulting state of a state, so one lookup stands in for the call to
+"actions" and all of the calls to "result" for a state.  It keeps the lists within a memory budget, and when a new list
+doesn't fit, it evicts the lists used least recently by the CLOCK algorithm:  each list has a bit that is set when it
+is used, and a hand sweeps the lists in a circle, clearing set bits and evicting the first list whose bit is clear.
+That approximates least-recently-used eviction without reordering anything on a hit.
+
+SuccessorCache is not thread-safe.  ConcurrentSuccessorCache, which Problem uses, splits the states among several
+SuccessorCache shards, each with its own lock and its own part of the budget, so that the threads of a parallel search
+rarely wait for one another.
+*/
+
+#pragma once
+
+#include <algorithm>     // std::min, std::max
+#include <cstddef>       // std::size_t
+#include <cstdint>       // std::uint32_t
+#include <functional>    // std::hash
+#include <memory>        // std::unique_ptr
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace graphsearch
+{
+	template <typename StateType, typename ActionsType, typename StateHashType = std::hash<StateType>>
+	class SuccessorCache
+	{
+	public:
+		struct Successor
+		{
+			ActionsType action;
+			StateType state;
+		};
+
+		typedef std::vector<Successor> SuccessorList;
+
+	private:
+		struct Slot
+		{
+			StateType state;
+			SuccessorList successors;
+			bool used{false};        // Does the slot hold a list?
+			bool referenced{false};  // Has the list been used since the hand last passed it?
+		};
+
+		std::size_t memory_budget;
+		std::size_t bytes_used{0};
+		std::vector<Slot> slots;
+		std::vector<std::uint32_t> free_slots;
+		std::unordered_map<StateType, std::uint32_t, StateHashType> index;  // The slot of each state
+		std::size_t hand{0};
+		std::size_t hit_count{0};
+		std::size_t miss_count{0};
+		std::size_t eviction_count{0};
+
+		/* Estimate the memory a list takes, including its slot and its entry in the index. */
+		static std::size_t entryBytes(std::size_t successor_count)
+		{
+			return sizeof(Slot) + successor_count * sizeof(Successor) + sizeof(StateType) + sizeof(std::uint32_t)
+				+ 2 * sizeof(void*);
+		}
+
+		/* Evict the first list the hand reaches whose bit is clear. */
+		void evictOne()
+		{
+			for (;;)
+			{
+				Slot& slot = slots[hand];
+				std::uint32_t slot_id = (std::uint32_t)hand;
+
+				hand = (hand + 1) % slots.size();
+				if (!slot.used)
+				{
+					continue;
+				}
+				if (slot.referenced)
+				{
+					slot.referenced = false;  // A second chance
+					continue;
+				}
+				index.erase(slot.state);
+				bytes_used -= entryBytes(slot.successors.size());
+				SuccessorList().swap(slot.successors);
+				slot.used = false;
+				free_slots.push_back(slot_id);
+				++eviction_count;
+				return;
+			}
+		}
+
+	public:
+		/* Create a cache that keeps its lists within about memory_budget bytes. */
+		explicit SuccessorCache(std::size_t the_memory_budget) : memory_budget{the_memory_budget}
+		{
+		}
+
+		/* Return the successors of a state, and mark them used, or nullptr if the cache doesn't have them. */
+		const SuccessorList* find(const StateType& state)
+		{
+			typename std::unordered_map<StateType, std::uint32_t, StateHashType>::const_iterator it = index.find(state);
+
+			if (it == index.end())
+			{
+				++miss_count;
+				return nullptr;
+			}
+			++hit_count;
+			slots[it->second].referenced = true;
+			return &slots[it->second].successors;
+		}
+
+		/*
+		Add the successors of a state, evicting other lists until they fit.  A list larger than the whole budget, or for
+		a state the cache already has, is not added.
+		*/
+		void insert(const StateType& state, const SuccessorList& successors)
+		{
+			std::size_t bytes = entryBytes(successors.size());
+			std::uint32_t slot_id;
+
+			if (bytes > memory_budget || index.count(state) == 1)
+			{
+				return;
+			}
+			while (bytes_used + bytes > memory_budget)
+			{
+				evictOne();
+			}
+			if (free_slots.empty())
+			{
+				slot_id = (std::uint32_t)slots.size();
+				slots.emplace_back();
+			}
+			else
+			{
+				slot_id = free_slots.back();
+				free_slots.pop_back();
+			}
+
+			Slot& slot = slots[slot_id];
+			slot.state = state;
+			slot.successors = successors;
+			slot.used = true;
+			slot.referenced = false;
+			index.emplace(state, slot_id);
+			bytes_used += bytes;
+		}
+
+		/* Remove every list, for example because the problem's actions have changed.  The counters are kept. */
+		void clear()
+		{
+			slots.clear();
+			free_slots.clear();
+			index.clear();
+			hand = 0;
+			bytes_used = 0;
+		}
+
+		/* Return the number of states whose successors the cache holds. */
+		std::size_t size() const
+		{
+			return index.size();
+		}
+
+		/* Return the estimated memory the lists take, which is at most the budget. */
+		std::size_t bytesUsed() const
+		{
+			return bytes_used;
+		}
+
+		std::size_t hits() const
+		{
+			return hit_count;
+		}
+
+		std::size_t misses() const
+		{
+			return miss_count;
+		}
+
+		std::size_t evictions() const
+		{
+			return eviction_count;
+		}
+	};
+
+	/*
+	A successor cache that several threads can use at once.  A state's shard is its hash modulo the number of shards.
+	There is a shard for every shard_budget bytes of the budget, up to max_shards, so that each shard has room for many
+	lists.  Each shard evicts on its own, so a list can be evicted while another shard has a list used less recently.
+	*/
+	template <typename StateType, typename ActionsType, typename StateHashType = std::hash<StateType>>
+	class ConcurrentSuccessorCache
+	{
+		typedef SuccessorCache<StateType, ActionsType, StateHashType> ShardCache;
+
+	public:
+		typedef typename ShardCache::Successor Successor;
+		typedef typename ShardCache::SuccessorList SuccessorList;
+
+		static const std::size_t shard_budget = 65536;
+		static const std::size_t max_shards = 64;
+
+	private:
+		struct Shard
+		{
+			std::mutex mutex;
+			ShardCache cache;
+
+			explicit Shard(std::size_t memory_budget) : cache{memory_budget}
+			{
+			}
+		};
+
+		std::vector<std::unique_ptr<Shard>> shards;
+
+		Shard& shardFor(const StateType& state)
+		{
+			return *shards[StateHashType()(state) % shards.size()];
+		}
+
+		template <typename Function>
+		std::size_t sum(Function count) const
+		{
+			std::size_t total = 0;
+
+			for (const std::unique_ptr<Shard>& shard : shards)
+			{
+				total += count(shard->cache);
+			}
+			return total;
+		}
+
+	public:
+		/* Create a cache that keeps its lists within about memory_budget bytes. */
+		explicit ConcurrentSuccessorCache(std::size_t memory_budget)
+		{
+			std::size_t num_shards = std::min(std::max(memory_budget / shard_budget, std::size_t{1}), max_shards);
+
+			for (std::size_t i = 0; i < num_shards; ++i)
+			{
+				shards.emplace_back(new Shard{memory_budget / num_shards});
+			}
+		}
+
+		/*
+		If the cache has the successors of a state, call "visit" with each of them, holding the lock of the state's
+		shard, and return true.  Otherwise return false.
+		*/
+		template <typename Visitor>
+		bool find(const StateType& state, Visitor visit)
+		{
+			Shard& shard = shardFor(state);
+			std::lock_guard<std::mutex> lock{shard.mutex};
+			const SuccessorList* cached = shard.cache.find(state);
+
+			if (cached == nullptr)
+			{
+				return false;
+			}
+			for (const Successor& successor : *cached)
+			{
+				visit(successor);
+			}
+			return true;
+		}
+
+		/* Add the successors of a state.  See SuccessorCache::insert. */
+		void insert(const StateType& state, const SuccessorList& successors)
+		{
+			Shard& shard = shardFor(state);
+			std::lock_guard<std::mutex> lock{shard.mutex};
+
+			shard.cache.insert(state, successors);
+		}
+
+		/* The counters below are totals over the shards.  Don't call them while other threads use the cache. */
+
+		std::size_t size() const
+		{
+			return sum([](const ShardCache& cache) { return cache.size(); });
+		}
+
+		std::size_t bytesUsed() const
+		{
+			return sum([](const ShardCache& cache) { return cache.bytesUsed(); });
+		}
+
+		std::size_t hits() const
+		{
+			return sum([](const ShardCache& cache) { return cache.hits(); });
+		}
+
+		std::size_t misses() const
+		{
+			return sum([](const ShardCache& cache) { return cache.misses(); });
+		}
+
+		std::size_t evictions() const
+		{
+			return sum([](const ShardCache& cache) { return cache.evictions(); });
+		}
+	};
+
+	template <typename StateType, typename ActionsType, typename StateHashType>
+	const std::size_t ConcurrentSuccessorCache<StateType, ActionsType, StateHashType>::shard_budget;
+
+	template <typename StateType, typename ActionsType, typename StateHashType>
+	const std::size_t ConcurrentSuccessorCache<StateType, ActionsType, StateHashType>::max_shards;
+} // End of the graphsearch namespace.
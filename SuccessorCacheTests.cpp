@@ -0,0 +1,125 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code tests SuccessorCache.h.
+*/
+
+#include <cstddef>         // std::size_t
+#include <thread>
+#include <vector>
+#include "cute.h"
+#include "SuccessorCache.h"
+#include "SuccessorCacheTests.h"
+
+enum class CacheActions { start_state, left, right };
+
+typedef graphsearch::SuccessorCache<int, CacheActions> IntSuccessorCache;
+
+/* Return the successors of a state of a line of integers. */
+static IntSuccessorCache::SuccessorList lineSuccessors(int state)
+{
+	return IntSuccessorCache::SuccessorList({ { CacheActions::left, state - 1 }, { CacheActions::right, state + 1 } });
+}
+
+void SuccessorCacheTest()
+{
+	IntSuccessorCache cache{1 << 16};
+	const IntSuccessorCache::SuccessorList* found;
+
+	ASSERTM("A new cache should be empty.", cache.find(1) == nullptr && cache.size() == 0);
+	cache.insert(1, lineSuccessors(1));
+	found = cache.find(1);
+	ASSERTM("The cache should return the successors of a state it has.", found != nullptr && found->size() == 2
+			&& (*found)[0].action == CacheActions::left && (*found)[0].state == 0 && (*found)[1].state == 2);
+	ASSERTM("Incorrect counters.", cache.hits() == 1 && cache.misses() == 1 && cache.size() == 1 && cache.bytesUsed() > 0);
+
+	// A second list for the same state is ignored.
+	cache.insert(1, IntSuccessorCache::SuccessorList());
+	ASSERTM("The cache should keep the first list.", cache.find(1)->size() == 2 && cache.size() == 1);
+
+	cache.clear();
+	ASSERTM("A cleared cache should be empty.", cache.find(1) == nullptr && cache.size() == 0 && cache.bytesUsed() == 0);
+	ASSERTM("Clearing should keep the counters.", cache.hits() == 2 && cache.misses() == 2);
+
+	// A list larger than the budget is not kept.
+	IntSuccessorCache tiny{8};
+	tiny.insert(1, lineSuccessors(1));
+	ASSERTM("A list larger than the budget should not be kept.", tiny.size() == 0 && tiny.bytesUsed() == 0);
+}
+
+void SuccessorCacheEvictionTest()
+{
+	std::size_t entry_bytes;
+	{
+		IntSuccessorCache measure{1 << 16};
+		measure.insert(0, lineSuccessors(0));
+		entry_bytes = measure.bytesUsed();
+	}
+
+	// A cache with room for three lists should evict one for a fourth, skipping a list used since it was added.
+	IntSuccessorCache cache{3 * entry_bytes};
+	for (int state = 1; state <= 3; ++state)
+	{
+		cache.insert(state, lineSuccessors(state));
+	}
+	ASSERTM("Three lists should fit.", cache.size() == 3 && cache.evictions() == 0);
+	cache.find(1);
+	cache.insert(4, lineSuccessors(4));
+	ASSERTM("The cache should stay within its budget.", cache.size() == 3 && cache.bytesUsed() <= 3 * entry_bytes);
+	ASSERTM("The cache should evict an unused list.", cache.evictions() == 1 && cache.find(2) == nullptr);
+	ASSERTM("The cache should keep the used list and the newer lists.", cache.find(1) != nullptr && cache.find(3) != nullptr
+			&& cache.find(4) != nullptr);
+
+	// Many more lists than fit keep the cache within its budget, and the evicted slots are reused.
+	for (int state = 5; state < 1000; ++state)
+	{
+		cache.insert(state, lineSuccessors(state));
+		ASSERTM("The cache should stay within its budget.", cache.bytesUsed() <= 3 * entry_bytes);
+	}
+	ASSERTM("The newest list should be kept.", cache.find(999) != nullptr && (*cache.find(999))[1].state == 1000);
+	ASSERTM("Incorrect evictions.", cache.size() == 3 && cache.evictions() == 996);
+}
+
+void ConcurrentSuccessorCacheTest()
+{
+	const int num_threads = 4;
+	const int count = 10000;
+	graphsearch::ConcurrentSuccessorCache<int, CacheActions> cache{1 << 22};
+	std::vector<std::thread> threads;
+
+	// Every thread looks up and adds the same states.  Each state should be added once.
+	for (int t = 0; t < num_threads; ++t)
+	{
+		threads.emplace_back([&cache, t]() {
+			for (int i = 0; i < count; ++i)
+			{
+				int state = (i + t * count / num_threads) % count;
+				int found = 0;
+				if (!cache.find(state, [&found](const IntSuccessorCache::Successor&) { ++found; }))
+				{
+					cache.insert(state, lineSuccessors(state));
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	ASSERTM("The cache should hold every state added.", cache.size() == (std::size_t)count);
+	ASSERTM("Every lookup should be counted.", cache.hits() + cache.misses() == (std::size_t)(num_threads * count));
+
+	std::vector<int> states;
+	ASSERTM("The cache should return the successors of a state it has.",
+			cache.find(7, [&states](const IntSuccessorCache::Successor& successor) { states.push_back(successor.state); })
+			&& (states == std::vector<int>({ 6, 8 })));
+
+	// A small budget gets a single shard, which stays within the budget.
+	graphsearch::ConcurrentSuccessorCache<int, CacheActions> small{1024};
+	for (int state = 0; state < 100; ++state)
+	{
+		small.insert(state, lineSuccessors(state));
+	}
+	ASSERTM("The cache should stay within its budget.", small.bytesUsed() <= 1024 && small.evictions() > 0);
+}
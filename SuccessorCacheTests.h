@@ -0,0 +1,13 @@
+/*
+(C) David J. Kalbfleisch 2016
+You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
+
+This code tests SuccessorCache.h.
+*/
+
+#pragma once
+
+// Test function prototypes:
+void SuccessorCacheTest();
+void SuccessorCacheEvictionTest();
+void ConcurrentSuccessorCacheTest();
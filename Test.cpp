@@ -2,7 +2,7 @@
 (C) David J. Kalbfleisch 2016
 You are welcome to use this code pursuant to the GNU General Public license.  See the file, LICENSE.
 
-This code tests Frontier.h and GraphSearch.h.
+This code tests Frontier.h, StateTable.h, Bitmap.h, Arena.h, SuccessorCache.h, GraphSearch.h, and CsrProblem.h.
 */
 
 #include "cute.h"
@@ -10,8 +10,13 @@ This code tests Frontier.h and GraphSearch.h.
 #include "xml_listener.h"
 #include "cute_runner.h"
 
+#include "ArenaTests.h"
+#include "BitmapTests.h"
+#include "CsrProblemTests.h"
 #include "FrontierTests.h"
 #include "GraphSearchTests.h"
+#include "StateTableTests.h"
+#include "SuccessorCacheTests.h"
 
 // Create a test suite for Frontier.h.
 void runFrontierTests(int argc, const char* argv[])
@@ -19,11 +24,64 @@ void runFrontierTests(int argc, const char* argv[])
 	cute::suite s;
 	s.push_back(CUTE(BreadthFirstFrontierTest));
 	s.push_back(CUTE(DepthFirstFrontierTest));
+	s.push_back(CUTE(PriorityFrontierTest));
+	s.push_back(CUTE(BoundedFrontierTest));
+	s.push_back(CUTE(IndexedPriorityFrontierTest));
+	s.push_back(CUTE(WorkStealingFrontierTest));
 	cute::xml_file_opener xmlfile(argc,argv);
 	cute::xml_listener<cute::ide_listener<>>  lis(xmlfile.out);
 	cute::makeRunner(lis, argc, argv)(s, "Frontier Tests");
 }
 
+// Create a test suite for StateTable.h.
+void runStateTableTests(int argc, const char* argv[])
+{
+	cute::suite s;
+	s.push_back(CUTE(StateTableTest));
+	s.push_back(CUTE(StateTableCollisionsTest));
+	s.push_back(CUTE(FlatStateTableTest));
+	s.push_back(CUTE(FlatStateTableCollisionsTest));
+	s.push_back(CUTE(DenseStateTableTest));
+	s.push_back(CUTE(ConcurrentStateSetTest));
+	cute::xml_file_opener xmlfile(argc,argv);
+	cute::xml_listener<cute::ide_listener<>>  lis(xmlfile.out);
+	cute::makeRunner(lis, argc, argv)(s, "StateTable Tests");
+}
+
+// Create a test suite for Bitmap.h.
+void runBitmapTests(int argc, const char* argv[])
+{
+	cute::suite s;
+	s.push_back(CUTE(BitmapTest));
+	s.push_back(CUTE(BitmapInstructionsTest));
+	cute::xml_file_opener xmlfile(argc,argv);
+	cute::xml_listener<cute::ide_listener<>>  lis(xmlfile.out);
+	cute::makeRunner(lis, argc, argv)(s, "Bitmap Tests");
+}
+
+// Create a test suite for Arena.h.
+void runArenaTests(int argc, const char* argv[])
+{
+	cute::suite s;
+	s.push_back(CUTE(MonotonicArenaTest));
+	s.push_back(CUTE(ArenaAllocatorTest));
+	cute::xml_file_opener xmlfile(argc,argv);
+	cute::xml_listener<cute::ide_listener<>>  lis(xmlfile.out);
+	cute::makeRunner(lis, argc, argv)(s, "Arena Tests");
+}
+
+// Create a test suite for SuccessorCache.h.
+void runSuccessorCacheTests(int argc, const char* argv[])
+{
+	cute::suite s;
+	s.push_back(CUTE(SuccessorCacheTest));
+	s.push_back(CUTE(SuccessorCacheEvictionTest));
+	s.push_back(CUTE(ConcurrentSuccessorCacheTest));
+	cute::xml_file_opener xmlfile(argc,argv);
+	cute::xml_listener<cute::ide_listener<>>  lis(xmlfile.out);
+	cute::makeRunner(lis, argc, argv)(s, "SuccessorCache Tests");
+}
+
 // Create a test suite for GraphSearch.h.
 void runGraphSearchTests(int argc, const char* argv[])
 {
@@ -35,16 +93,67 @@ void runGraphSearchTests(int argc, const char* argv[])
 	s.push_back(CUTE(SimpleCyclesDepthFirstSearchTest));
 	s.push_back(CUTE(SimpleStructBreadthFirstSearchTest));
 	s.push_back(CUTE(SimpleStructDepthFirstSearchTest));
+	s.push_back(CUTE(WeightedBreadthFirstSearchTest));
+	s.push_back(CUTE(UniformCostSearchTest));
+	s.push_back(CUTE(AStarSearchTest));
+	s.push_back(CUTE(FrontierPolicySearchTest));
+	s.push_back(CUTE(SuccessorsSearchTest));
+	s.push_back(CUTE(ZeroAllocationExpandTest));
+	s.push_back(CUTE(FlatStateTableSearchTest));
+	s.push_back(CUTE(ReusedSearchAllocationTest));
+	s.push_back(CUTE(ParallelBreadthFirstSearchTest));
+	s.push_back(CUTE(ParallelGridSearchTest));
+	s.push_back(CUTE(ParallelDepthFirstSearchTest));
+	s.push_back(CUTE(ParallelTraversalStressTest));
+	s.push_back(CUTE(BidirectionalSearchTest));
+	s.push_back(CUTE(IterativeDeepeningSearchTest));
+	s.push_back(CUTE(IDAStarSearchTest));
+	s.push_back(CUTE(SearchStatsTest));
+	s.push_back(CUTE(ParallelSearchStatsTest));
+	s.push_back(CUTE(ArenaSearchTest));
+	s.push_back(CUTE(ExternalBreadthFirstSearchTest));
+	s.push_back(CUTE(ResultKindTest));
+	s.push_back(CUTE(MultiSourceSearchTest));
+	s.push_back(CUTE(NearestSourceSearchTest));
+	s.push_back(CUTE(BatchSearchTest));
+	s.push_back(CUTE(SuccessorCacheSearchTest));
+	s.push_back(CUTE(DenseBreadthFirstSearchTest));
+	s.push_back(CUTE(GoalOnGenerationTest));
+	s.push_back(CUTE(GoalPredicateSearchTest));
+	s.push_back(CUTE(StateMarkingTest));
+	s.push_back(CUTE(SearchLimitsTest));
+	s.push_back(CUTE(ResumeSearchTest));
+	s.push_back(CUTE(IncrementalSearchTest));
+	s.push_back(CUTE(BeamSearchTest));
 	cute::xml_file_opener xmlfile(argc,argv);
 	cute::xml_listener<cute::ide_listener<>>  lis(xmlfile.out);
 	cute::makeRunner(lis, argc, argv)(s, "GraphSearch Tests");
 }
 
+// Create a test suite for CsrProblem.h.
+void runCsrProblemTests(int argc, const char* argv[])
+{
+	cute::suite s;
+	s.push_back(CUTE(CsrGraphTest));
+	s.push_back(CUTE(CsrEdgeListTest));
+	s.push_back(CUTE(CsrProblemSearchTest));
+	s.push_back(CUTE(CsrReverseEdgesTest));
+	s.push_back(CUTE(DirectionOptimizingSearchTest));
+	cute::xml_file_opener xmlfile(argc,argv);
+	cute::xml_listener<cute::ide_listener<>>  lis(xmlfile.out);
+	cute::makeRunner(lis, argc, argv)(s, "CsrProblem Tests");
+}
+
 // Run all test suites.
 int main(int argc, const char* argv[])
 {
     runFrontierTests(argc, argv);
+    runStateTableTests(argc, argv);
+    runBitmapTests(argc, argv);
+    runArenaTests(argc, argv);
+    runSuccessorCacheTests(argc, argv);
     runGraphSearchTests(argc, argv);
+    runCsrProblemTests(argc, argv);
     return 0;
 }
 